@@ -2,6 +2,7 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
+#if !INSTANCED
 layout(binding = 1) uniform UboObject
 {
 #if ANIMATED
@@ -15,6 +16,7 @@ layout(binding = 1) uniform UboObject
 	float ignoreFog;
 	float ignoreLighting;
 } object;
+#endif
 
 #if DIFFUSE_MAPPING
 layout(binding = 2) uniform sampler2D samplerDiffuse;
@@ -33,6 +35,11 @@ layout(location = 2) in vec3 inNormal;
 layout(location = 3) in vec3 inTangent;
 #endif
 
+#if INSTANCED
+layout(location = 4) flat in vec4 inBaseDiffuse;
+layout(location = 5) flat in vec4 inMaterial;
+#endif
+
 layout(location = 0) out vec4 outPosition;
 layout(location = 1) out vec4 outDiffuse;
 layout(location = 2) out vec4 outNormal;
@@ -40,9 +47,17 @@ layout(location = 3) out vec4 outMaterial;
 
 void main()
 {
-	vec4 diffuse = object.baseDiffuse;
+#if INSTANCED
+	vec4 baseDiffuse = inBaseDiffuse;
+	vec4 baseMaterial = inMaterial;
+#else
+	vec4 baseDiffuse = object.baseDiffuse;
+	vec4 baseMaterial = vec4(object.metallic, object.roughness, object.ignoreFog, object.ignoreLighting);
+#endif
+
+	vec4 diffuse = baseDiffuse;
 	vec3 normal = normalize(inNormal);
-	vec3 material = vec3(object.metallic, object.roughness, 0.0f);
+	vec3 material = vec3(baseMaterial.x, baseMaterial.y, 0.0f);
 	float glowing = 0.0f;
 
 #if DIFFUSE_MAPPING
@@ -69,7 +84,7 @@ void main()
 	normal = TBN * normalize(texture(samplerNormal, inUv).rgb * 2.0f - vec3(1.0f));*/
 #endif
 
-	material.z = (1.0f / 3.0f) * (object.ignoreFog + (2.0f * min(object.ignoreLighting + glowing, 1.0f)));
+	material.z = (1.0f / 3.0f) * (baseMaterial.z + (2.0f * min(baseMaterial.w + glowing, 1.0f)));
 
 	outPosition = inPosition;
 	outDiffuse = diffuse;
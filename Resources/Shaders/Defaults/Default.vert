@@ -9,6 +9,7 @@ layout(binding = 0) uniform UboScene
 	vec3 cameraPos;
 } scene;
 
+#if !INSTANCED
 layout(binding = 1) uniform UboObject
 {
 #if ANIMATED
@@ -22,6 +23,7 @@ layout(binding = 1) uniform UboObject
 	float ignoreFog;
 	float ignoreLighting;
 } object;
+#endif
 
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUv;
@@ -33,6 +35,11 @@ layout(location = 3) in vec3 inTangent;
 layout(location = 4) in vec3 inJointIds;
 layout(location = 5) in vec3 inWeights;
 #endif
+#if INSTANCED
+layout(location = 4) in mat4 inTransform;
+layout(location = 8) in vec4 inBaseDiffuse;
+layout(location = 9) in vec4 inMaterial;
+#endif
 
 layout(location = 0) out vec4 outPosition;
 layout(location = 1) out vec2 outUv;
@@ -40,6 +47,10 @@ layout(location = 2) out vec3 outNormal;
 #if NORMAL_MAPPING
 layout(location = 3) out vec3 outTangent;
 #endif
+#if INSTANCED
+layout(location = 4) flat out vec4 outBaseDiffuse;
+layout(location = 5) flat out vec4 outMaterial;
+#endif
 
 out gl_PerVertex
 {
@@ -66,8 +77,14 @@ void main()
 	vec4 normal = vec4(inNormal, 0.0f);
 #endif
 
-	vec4 worldPosition = object.transform * position;
-    mat3 normalMatrix = transpose(inverse(mat3(object.transform)));
+#if INSTANCED
+	mat4 transform = inTransform;
+#else
+	mat4 transform = object.transform;
+#endif
+
+	vec4 worldPosition = transform * position;
+    mat3 normalMatrix = transpose(inverse(mat3(transform)));
 
 	gl_Position = scene.projection * scene.view * worldPosition;
 
@@ -77,4 +94,8 @@ void main()
 #if NORMAL_MAPPING
 	outTangent = normalMatrix * normalize(inTangent);
 #endif
+#if INSTANCED
+	outBaseDiffuse = inBaseDiffuse;
+	outMaterial = inMaterial;
+#endif
 }
@@ -5,10 +5,13 @@
 layout(binding = 0) uniform UboScene
 {
 	mat4 view;
-	mat4 shadowSpace;
+	mat4 shadowSpaces[NUM_CASCADES];
+	vec4 shadowSplits;
 	vec3 cameraPosition;
 
-	int lightsCount;
+	int globalLightsCount;
+	float clusterNear;
+	float clusterScale;
 
 	vec4 fogColour;
 	float fogDensity;
@@ -28,19 +31,29 @@ struct Light
 	float radius;
 };
 
-layout(binding = 1) buffer Lights
+layout(binding = 1) readonly buffer Lights
 {
 	Light lights[];
 } lights;
 
-layout(binding = 2) uniform sampler2D samplerPosition;
-layout(binding = 3) uniform sampler2D samplerDiffuse;
-layout(binding = 4) uniform sampler2D samplerNormal;
-layout(binding = 5) uniform sampler2D samplerMaterial;
-layout(binding = 6) uniform sampler2D samplerShadows;
+layout(binding = 2) readonly buffer Clusters
+{
+	uvec2 clusters[];
+} clusters;
+
+layout(binding = 3) readonly buffer LightIndices
+{
+	uint indices[];
+} lightIndices;
+
+layout(binding = 4) uniform sampler2D samplerPosition;
+layout(binding = 5) uniform sampler2D samplerDiffuse;
+layout(binding = 6) uniform sampler2D samplerNormal;
+layout(binding = 7) uniform sampler2D samplerMaterial;
+layout(binding = 8) uniform sampler2D samplerShadows;
 #if USE_IBL
-layout(binding = 7) uniform sampler2D samplerBrdf;
-layout(binding = 8) uniform samplerCube samplerIbl;
+layout(binding = 9) uniform sampler2D samplerBrdf;
+layout(binding = 10) uniform samplerCube samplerIbl;
 #endif
 
 layout(location = 0) in vec2 inUv;
@@ -49,6 +62,26 @@ layout(location = 0) out vec4 outColour;
 
 #include "Shaders/Lighting.glsl"
 
+vec3 radiance(Light light, vec3 worldPosition, vec3 normal, vec3 viewDir, float roughness, float metallic, vec3 diffuse)
+{
+	vec3 lightDir = light.position - worldPosition;
+	float dist = length(lightDir);
+	lightDir /= dist;
+
+	float atten = attenuation(dist, light.radius);
+	return light.colour.rgb * atten * L0(normal, lightDir, viewDir, roughness, metallic, diffuse);
+}
+
+// Finds the cluster of a pixel from its tile on the screen and its view depth, slices grow exponentially from the near plane.
+uint cluster(vec4 screenPosition)
+{
+	uvec2 tile = uvec2(gl_FragCoord.xy * vec2(CLUSTER_TILES_X, CLUSTER_TILES_Y) / vec2(textureSize(samplerPosition, 0)));
+	tile = min(tile, uvec2(CLUSTER_TILES_X - 1, CLUSTER_TILES_Y - 1));
+	float depth = max(-screenPosition.z, scene.clusterNear);
+	uint slice = min(uint(log(depth / scene.clusterNear) * scene.clusterScale), uint(CLUSTER_SLICES - 1));
+	return tile.x + (uint(CLUSTER_TILES_X) * (tile.y + (uint(CLUSTER_TILES_Y) * slice)));
+}
+
 /*float shadow(vec4 shadowCoords)
 {
 	vec2 sizeShadows = 1.0f / textureSize(samplerShadows, 0);
@@ -58,7 +91,7 @@ layout(location = 0) out vec4 outColour;
 	
 	if (shadowCoords.x > 0.0f && shadowCoords.x < 1.0f && shadowCoords.y > 0.0f && shadowCoords.y < 1.0f && shadowCoords.z > 0.0f && shadowCoords.z < 1.0f)
 	{
-		float shadowValue = texture(samplerShadows, shadowCoords.xy * sizeShadows).r;
+		float shadowValue = texture(samplerShadows, shadowCoords.xy).r;
 
 		if (shadowCoords.z < shadowValue + scene.shadowBias)
 		{
@@ -94,18 +127,16 @@ void main()
 		vec3 irradiance = 0.1f * diffuse.rgb; // vec3(0.0f)
 		vec3 viewDir = normalize(scene.cameraPosition - worldPosition);
 
-		for (int i = 0; i < scene.lightsCount; i++)
+		for (int i = 0; i < scene.globalLightsCount; i++)
 		{
-			Light light = lights.lights[i];
-
-			vec3 lightDir = light.position - worldPosition;
-			float dist = length(lightDir);
-			lightDir /= dist;
+			irradiance += radiance(lights.lights[i], worldPosition, normal, viewDir, roughness, metallic, diffuse.rgb);
+		}
 
-			float atten = attenuation(dist, light.radius);
-			vec3 radiance = light.colour.rgb * atten;
+		uvec2 lightRange = clusters.clusters[cluster(screenPosition)];
 
-			irradiance += radiance * L0(normal, lightDir, viewDir, roughness, metallic, diffuse.rgb);
+		for (uint i = 0; i < lightRange.y; i++)
+		{
+			irradiance += radiance(lights.lights[lightIndices.indices[lightRange.x + i]], worldPosition, normal, viewDir, roughness, metallic, diffuse.rgb);
 		}
 
 #if USE_IBL
@@ -116,9 +147,19 @@ void main()
 
 		/*if (scene.shadowDarkness >= 0.07f)
 		{
-			vec4 shadowCoords = scene.shadowSpace * vec4(worldPosition, 1.0f);
+			uint cascade = 0;
+
+			for (uint i = 0; i < NUM_CASCADES - 1; i++)
+			{
+				if (-screenPosition.z > scene.shadowSplits[i])
+				{
+					cascade = i + 1;
+				}
+			}
+
+			vec4 shadowCoords = scene.shadowSpaces[cascade] * vec4(worldPosition, 1.0f);
 			float distanceAway = length(screenPosition.xyz);
-			distanceAway = distanceAway - ((scene.shadowDistance * 2.0f) - scene.shadowTransition);
+			distanceAway = distanceAway - (scene.shadowDistance - scene.shadowTransition);
 			distanceAway = distanceAway / scene.shadowTransition;
 			shadowCoords.w = clamp(1.0f - distanceAway, 0.0f, 1.0f);
 			outColour *= shadow(shadowCoords);
@@ -11,10 +11,39 @@ layout(set = 0, binding = 0) uniform UboScene
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUv;
 
+#if COMPUTED
+struct Particle
+{
+	vec4 position; // xyz position, w rotation.
+	vec4 velocity; // xyz velocity, w gravity effect.
+	vec4 life; // x life length, y stage cycles, z elapsed time, w transparency.
+	vec4 scale; // x scale.
+};
+
+layout(set = 0, binding = 2) uniform UboParticles
+{
+	vec4 colourOffset;
+	float numberOfRows;
+	uint capacity;
+} particles;
+
+layout(set = 0, binding = 3) readonly buffer Particles
+{
+	Particle particles[];
+} states;
+
+#if SORTED
+layout(set = 0, binding = 4) readonly buffer Indices
+{
+	uint indices[];
+} sorted;
+#endif
+#else
 layout(location = 4) in mat4 inModelMatrix;
 layout(location = 8) in vec4 inColourOffset;
 layout(location = 9) in vec4 inOffsets;
 layout(location = 10) in vec3 inBlend;
+#endif
 
 layout(location = 0) out vec2 outCoords1;
 layout(location = 1) out vec2 outCoords2;
@@ -27,9 +56,48 @@ out gl_PerVertex
 	vec4 gl_Position;
 };
 
+#if COMPUTED
+vec2 atlasOffset(float index)
+{
+	return vec2(mod(index, particles.numberOfRows), floor(index / particles.numberOfRows)) / particles.numberOfRows;
+}
+#endif
+
 void main()
 {
+#if COMPUTED
+	// The simulation may count more particles than it could store, those instances are collapsed.
+	if (gl_InstanceIndex >= particles.capacity)
+	{
+		gl_Position = vec4(0.0f);
+		return;
+	}
+
+#if SORTED
+	// Instances are drawn back to front through the indices of the sort.
+	Particle particle = states.particles[sorted.indices[gl_InstanceIndex]];
+#else
+	Particle particle = states.particles[gl_InstanceIndex];
+#endif
+
+	// Billboarded by undoing the view rotation, then rotated around the view direction.
+	float c = cos(radians(particle.position.w));
+	float s = sin(radians(particle.position.w));
+	vec3 local = mat3(c, s, 0.0f, -s, c, 0.0f, 0.0f, 0.0f, 1.0f) * (inPosition * particle.scale.x);
+	vec4 worldPosition = vec4(particle.position.xyz + transpose(mat3(scene.view)) * local, 1.0f);
+
+	// The atlas stage is found from how far through its life the particle is.
+	float stageCount = particles.numberOfRows * particles.numberOfRows;
+	float atlasProgression = particle.life.y * particle.life.z / particle.life.x * stageCount;
+	float index1 = floor(atlasProgression);
+	float index2 = index1 < stageCount - 1.0f ? index1 + 1.0f : index1;
+
+	vec4 inColourOffset = particles.colourOffset;
+	vec4 inOffsets = vec4(atlasOffset(index1), atlasOffset(index2));
+	vec3 inBlend = vec3(fract(atlasProgression), particle.life.w, particles.numberOfRows);
+#else
 	vec4 worldPosition = inModelMatrix * vec4(inPosition, 1.0f);
+#endif
 
 	gl_Position = scene.projection * scene.view * worldPosition;
 
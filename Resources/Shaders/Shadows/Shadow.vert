@@ -4,8 +4,8 @@
 
 layout(binding = 0) uniform UboScene
 {
-	mat4 projectionView;
-	vec3 cameraPos;
+	mat4 projectionViews[NUM_CASCADES];
+	vec3 cameraPosition;
 } scene;
 
 layout(binding = 1) uniform UboObject
@@ -13,6 +13,11 @@ layout(binding = 1) uniform UboObject
 	mat4 transform;
 } object;
 
+layout(push_constant) uniform PushCascade
+{
+	uint cascade;
+} push;
+
 layout(location = 0) in vec3 inPosition;
 
 out gl_PerVertex
@@ -24,5 +29,5 @@ void main()
 {
 	vec4 worldPosition = object.transform * vec4(inPosition, 1.0f);
 
-	gl_Position = scene.projectionView * worldPosition;
+	gl_Position = scene.projectionViews[push.cascade] * worldPosition;
 }
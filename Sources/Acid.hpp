@@ -41,6 +41,7 @@
 #include "Engine/Module.hpp"
 #include "Engine/ModuleManager.hpp"
 #include "Engine/ModuleUpdater.hpp"
+#include "Engine/Profiler.hpp"
 #include "Events/EventChange.hpp"
 #include "Events/Events.hpp"
 #include "Events/EventStandard.hpp"
@@ -63,6 +64,7 @@
 #include "Helpers/Delegate.hpp"
 #include "Helpers/EnumClass.hpp"
 #include "Helpers/NonCopyable.hpp"
+#include "Helpers/RadixSort.hpp"
 #include "Helpers/String.hpp"
 #include "Inputs/AxisButton.hpp"
 #include "Inputs/AxisCompound.hpp"
@@ -77,6 +79,7 @@
 #include "Inputs/InputDelay.hpp"
 #include "Lights/Fog.hpp"
 #include "Lights/Light.hpp"
+#include "Lights/LightClusters.hpp"
 #include "Materials/Material.hpp"
 #include "Materials/MaterialDefault.hpp"
 #include "Materials/PipelineMaterial.hpp"
@@ -134,7 +137,10 @@
 #include "Network/Udp/UdpSocket.hpp"
 #include "Noise/Noise.hpp"
 #include "Particles/Particle.hpp"
+#include "Particles/ParticleCompute.hpp"
+#include "Particles/ParticlePool.hpp"
 #include "Particles/Particles.hpp"
+#include "Particles/ParticleSort.hpp"
 #include "Particles/ParticleSystem.hpp"
 #include "Particles/ParticleType.hpp"
 #include "Particles/RendererParticles.hpp"
@@ -176,15 +182,20 @@
 #include "Post/PostPipeline.hpp"
 #include "Renderer/Buffers/Buffer.hpp"
 #include "Renderer/Buffers/InstanceBuffer.hpp"
+#include "Renderer/Buffers/InstancePool.hpp"
+#include "Renderer/Buffers/RingBuffer.hpp"
 #include "Renderer/Buffers/StorageBuffer.hpp"
 #include "Renderer/Buffers/UniformBuffer.hpp"
 #include "Renderer/Commands/CommandBuffer.hpp"
+#include "Renderer/Commands/CommandPool.hpp"
 #include "Renderer/Descriptors/Descriptor.hpp"
 #include "Renderer/Descriptors/DescriptorSet.hpp"
 #include "Renderer/Handlers/DescriptorsHandler.hpp"
 #include "Renderer/Handlers/PushHandler.hpp"
 #include "Renderer/Handlers/StorageHandler.hpp"
 #include "Renderer/Handlers/UniformHandler.hpp"
+#include "Renderer/Memory/MemoryAllocator.hpp"
+#include "Renderer/Memory/UploadManager.hpp"
 #include "Renderer/Pipelines/Pipeline.hpp"
 #include "Renderer/Pipelines/PipelineCompute.hpp"
 #include "Renderer/Pipelines/PipelineGraphics.hpp"
@@ -198,17 +209,23 @@
 #include "Renderer/Renderpass/Swapchain.hpp"
 #include "Renderer/RenderPipeline.hpp"
 #include "Renderer/RenderStage.hpp"
+#include "Resources/AsyncResource.hpp"
 #include "Resources/Resource.hpp"
 #include "Resources/Resources.hpp"
+#include "Scenes/Archetype.hpp"
 #include "Scenes/Camera.hpp"
 #include "Scenes/Component.hpp"
 #include "Scenes/ComponentRegister.hpp"
+#include "Scenes/ComponentTypes.hpp"
 #include "Scenes/Entity.hpp"
+#include "Scenes/EntityCommands.hpp"
 #include "Scenes/EntityPrefab.hpp"
 #include "Scenes/Scene.hpp"
 #include "Scenes/ScenePhysics.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Scenes/SceneStructure.hpp"
+#include "Scenes/TransformHierarchy.hpp"
+#include "Scenes/View.hpp"
 #include "Serialized/Json/Json.hpp"
 #include "Serialized/Metadata.hpp"
 #include "Serialized/Xml/Xml.hpp"
@@ -219,8 +236,10 @@
 #include "Shadows/Shadows.hpp"
 #include "Skyboxes/MaterialSkybox.hpp"
 #include "Textures/Cubemap.hpp"
+#include "Textures/DepthPyramid.hpp"
 #include "Textures/DepthStencil.hpp"
 #include "Textures/Texture.hpp"
+#include "Threads/Job.hpp"
 #include "Threads/Thread.hpp"
 #include "Threads/ThreadPool.hpp"
 #include "Uis/Inputs/UiColourWheel.hpp"
@@ -18,6 +18,9 @@ namespace acid
 		m_alContext(nullptr),
 		m_masterGain(1.0f)
 	{
+		AddRead<Scenes>();
+		AddWrite<Audio>();
+
 		m_alDevice = alcOpenDevice(nullptr);
 		m_alContext = alcCreateContext(m_alDevice, nullptr);
 		alcMakeContextCurrent(m_alContext);
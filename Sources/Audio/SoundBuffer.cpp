@@ -17,11 +17,11 @@ namespace acid
 {
 	std::shared_ptr<SoundBuffer> SoundBuffer::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<SoundBuffer>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<SoundBuffer>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<SoundBuffer>("");
@@ -92,6 +92,21 @@ namespace acid
 		metadata.SetChild("Filename", m_filename);
 	}
 
+	std::size_t SoundBuffer::GetCpuSize() const
+	{
+		std::size_t size = sizeof(SoundBuffer) + m_filename.capacity();
+
+		// Samples are held by the audio device, which reports the size they were buffered with.
+		if (m_buffer != 0)
+		{
+			ALint bufferSize = 0;
+			alGetBufferi(m_buffer, AL_SIZE, &bufferSize);
+			size += static_cast<std::size_t>(bufferSize);
+		}
+
+		return size;
+	}
+
 	uint32_t SoundBuffer::LoadBufferWav(const std::string &filename)
 	{
 		auto fileLoaded = Files::Read(filename);
@@ -31,7 +31,7 @@ namespace acid
 		/// </summary>
 		/// <param name="filename"> The file to load the sound buffer from. </param>
 		/// <param name="load"> If this resource will load immediately, otherwise <seealso cref="#Load()"/> can be called. </param>
-		explicit SoundBuffer(std::string filename, const bool &load = true);
+		explicit SoundBuffer(std::string filename = "", const bool &load = true);
 
 		~SoundBuffer();
 
@@ -41,6 +41,8 @@ namespace acid
 
 		void Encode(Metadata &metadata) const override;
 
+		std::size_t GetCpuSize() const override;
+
 		const std::string &GetFilename() const { return m_filename; };
 
 		const uint32_t &GetBuffer() const { return m_buffer; }
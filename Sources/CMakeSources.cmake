@@ -38,6 +38,7 @@ set(_temp_acid_headers
 		Engine/Module.hpp
 		Engine/ModuleManager.hpp
 		Engine/ModuleUpdater.hpp
+		Engine/Profiler.hpp
 		Events/EventChange.hpp
 		Events/Events.hpp
 		Events/EventStandard.hpp
@@ -60,6 +61,7 @@ set(_temp_acid_headers
 		Helpers/Delegate.hpp
 		Helpers/EnumClass.hpp
 		Helpers/NonCopyable.hpp
+		Helpers/RadixSort.hpp
 		Helpers/String.hpp
 		Inputs/AxisButton.hpp
 		Inputs/AxisCompound.hpp
@@ -74,6 +76,7 @@ set(_temp_acid_headers
 		Inputs/InputDelay.hpp
 		Lights/Fog.hpp
 		Lights/Light.hpp
+		Lights/LightClusters.hpp
 		Materials/Material.hpp
 		Materials/MaterialDefault.hpp
 		Materials/PipelineMaterial.hpp
@@ -131,7 +134,10 @@ set(_temp_acid_headers
 		Network/Udp/UdpSocket.hpp
 		Noise/Noise.hpp
 		Particles/Particle.hpp
+		Particles/ParticleCompute.hpp
+		Particles/ParticlePool.hpp
 		Particles/Particles.hpp
+		Particles/ParticleSort.hpp
 		Particles/ParticleSystem.hpp
 		Particles/ParticleType.hpp
 		Particles/RendererParticles.hpp
@@ -173,15 +179,20 @@ set(_temp_acid_headers
 		Post/PostPipeline.hpp
 		Renderer/Buffers/Buffer.hpp
 		Renderer/Buffers/InstanceBuffer.hpp
+		Renderer/Buffers/InstancePool.hpp
+		Renderer/Buffers/RingBuffer.hpp
 		Renderer/Buffers/StorageBuffer.hpp
 		Renderer/Buffers/UniformBuffer.hpp
 		Renderer/Commands/CommandBuffer.hpp
+		Renderer/Commands/CommandPool.hpp
 		Renderer/Descriptors/Descriptor.hpp
 		Renderer/Descriptors/DescriptorSet.hpp
 		Renderer/Handlers/DescriptorsHandler.hpp
 		Renderer/Handlers/PushHandler.hpp
 		Renderer/Handlers/StorageHandler.hpp
 		Renderer/Handlers/UniformHandler.hpp
+		Renderer/Memory/MemoryAllocator.hpp
+		Renderer/Memory/UploadManager.hpp
 		Renderer/Pipelines/Pipeline.hpp
 		Renderer/Pipelines/PipelineCompute.hpp
 		Renderer/Pipelines/PipelineGraphics.hpp
@@ -195,17 +206,23 @@ set(_temp_acid_headers
 		Renderer/Renderpass/Swapchain.hpp
 		Renderer/RenderPipeline.hpp
 		Renderer/RenderStage.hpp
+		Resources/AsyncResource.hpp
 		Resources/Resource.hpp
 		Resources/Resources.hpp
+		Scenes/Archetype.hpp
 		Scenes/Camera.hpp
 		Scenes/Component.hpp
 		Scenes/ComponentRegister.hpp
+		Scenes/ComponentTypes.hpp
 		Scenes/Entity.hpp
+		Scenes/EntityCommands.hpp
 		Scenes/EntityPrefab.hpp
 		Scenes/Scene.hpp
 		Scenes/ScenePhysics.hpp
 		Scenes/Scenes.hpp
 		Scenes/SceneStructure.hpp
+		Scenes/TransformHierarchy.hpp
+		Scenes/View.hpp
 		Serialized/Json/Json.hpp
 		Serialized/Metadata.hpp
 		Serialized/Xml/Xml.hpp
@@ -216,8 +233,10 @@ set(_temp_acid_headers
 		Shadows/Shadows.hpp
 		Skyboxes/MaterialSkybox.hpp
 		Textures/Cubemap.hpp
+		Textures/DepthPyramid.hpp
 		Textures/DepthStencil.hpp
 		Textures/Texture.hpp
+		Threads/Job.hpp
 		Threads/Thread.hpp
 		Threads/ThreadPool.hpp
 		Uis/Inputs/UiColourWheel.hpp
@@ -269,6 +288,7 @@ set(_temp_acid_sources
 		Engine/Log.cpp
 		Engine/ModuleManager.cpp
 		Engine/ModuleUpdater.cpp
+		Engine/Profiler.cpp
 		Events/Events.cpp
 		Events/EventStandard.cpp
 		Events/EventTime.cpp
@@ -286,6 +306,7 @@ set(_temp_acid_sources
 		Gizmos/RendererGizmos.cpp
 		Guis/Gui.cpp
 		Guis/RendererGuis.cpp
+		Helpers/RadixSort.cpp
 		Helpers/String.cpp
 		Inputs/AxisButton.cpp
 		Inputs/AxisCompound.cpp
@@ -298,6 +319,7 @@ set(_temp_acid_sources
 		Inputs/InputDelay.cpp
 		Lights/Fog.cpp
 		Lights/Light.cpp
+		Lights/LightClusters.cpp
 		Materials/MaterialDefault.cpp
 		Materials/PipelineMaterial.cpp
 		Maths/Colour.cpp
@@ -345,7 +367,10 @@ set(_temp_acid_sources
 		Network/Udp/UdpSocket.cpp
 		Noise/Noise.cpp
 		Particles/Particle.cpp
+		Particles/ParticleCompute.cpp
+		Particles/ParticlePool.cpp
 		Particles/Particles.cpp
+		Particles/ParticleSort.cpp
 		Particles/ParticleSystem.cpp
 		Particles/ParticleType.cpp
 		Particles/RendererParticles.cpp
@@ -386,14 +411,19 @@ set(_temp_acid_sources
 		Post/PostFilter.cpp
 		Renderer/Buffers/Buffer.cpp
 		Renderer/Buffers/InstanceBuffer.cpp
+		Renderer/Buffers/InstancePool.cpp
+		Renderer/Buffers/RingBuffer.cpp
 		Renderer/Buffers/StorageBuffer.cpp
 		Renderer/Buffers/UniformBuffer.cpp
 		Renderer/Commands/CommandBuffer.cpp
+		Renderer/Commands/CommandPool.cpp
 		Renderer/Descriptors/DescriptorSet.cpp
 		Renderer/Handlers/DescriptorsHandler.cpp
 		Renderer/Handlers/PushHandler.cpp
 		Renderer/Handlers/StorageHandler.cpp
 		Renderer/Handlers/UniformHandler.cpp
+		Renderer/Memory/MemoryAllocator.cpp
+		Renderer/Memory/UploadManager.cpp
 		Renderer/Pipelines/PipelineCompute.cpp
 		Renderer/Pipelines/PipelineGraphics.cpp
 		Renderer/Pipelines/Shader.cpp
@@ -404,12 +434,17 @@ set(_temp_acid_sources
 		Renderer/Renderpass/Swapchain.cpp
 		Renderer/RenderStage.cpp
 		Resources/Resources.cpp
+		Scenes/Archetype.cpp
 		Scenes/ComponentRegister.cpp
+		Scenes/ComponentTypes.cpp
 		Scenes/Entity.cpp
+		Scenes/EntityCommands.cpp
 		Scenes/EntityPrefab.cpp
 		Scenes/ScenePhysics.cpp
 		Scenes/Scenes.cpp
 		Scenes/SceneStructure.cpp
+		Scenes/TransformHierarchy.cpp
+		Scenes/View.cpp
 		Serialized/Json/Json.cpp
 		Serialized/Metadata.cpp
 		Serialized/Xml/Xml.cpp
@@ -420,8 +455,10 @@ set(_temp_acid_sources
 		Shadows/Shadows.cpp
 		Skyboxes/MaterialSkybox.cpp
 		Textures/Cubemap.cpp
+		Textures/DepthPyramid.cpp
 		Textures/DepthStencil.cpp
 		Textures/Texture.cpp
+		Threads/Job.cpp
 		Threads/Thread.cpp
 		Threads/ThreadPool.cpp
 		Uis/Inputs/UiColourWheel.cpp
@@ -24,6 +24,9 @@ namespace acid
 
 	Joysticks::Joysticks()
 	{
+		AddWrite<Joysticks>();
+		SetMainThread(true);
+
 		glfwSetJoystickCallback(CallbackJoystick);
 
 		for (uint32_t i = 0; i < GLFW_JOYSTICK_LAST; i++)
@@ -16,6 +16,8 @@ namespace acid
 
 	Keyboard::Keyboard()
 	{
+		AddWrite<Keyboard>();
+
 		glfwSetKeyCallback(Window::Get()->GetWindow(), CallbackKey);
 		glfwSetCharCallback(Window::Get()->GetWindow(), CallbackChar);
 	}
@@ -88,6 +88,19 @@ namespace acid
 			}
 		}
 
+		// Prefer a transfer only family, its queue copies uploads while the graphics queue keeps rendering.
+		for (uint32_t i = 0; i < deviceQueueFamilyPropertyCount; i++)
+		{
+			auto queueFlags = deviceQueueFamilyProperties[i].queueFlags;
+
+			if (deviceQueueFamilyProperties[i].queueCount > 0 && queueFlags & VK_QUEUE_TRANSFER_BIT && !(queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+			{
+				m_transferFamily = i;
+				m_supportedQueues |= VK_QUEUE_TRANSFER_BIT;
+				break;
+			}
+		}
+
 		if (graphicsFamily == -1)
 		{
 			assert(false && "Vulkan runtime error, failed to find queue family supporting VK_QUEUE_GRAPHICS_BIT!");
@@ -53,6 +53,8 @@ namespace acid
 		m_windowSelected(true),
 		m_cursorHidden(false)
 	{
+		AddWrite<Mouse>();
+
 		glfwSetMouseButtonCallback(Window::Get()->GetWindow(), CallbackMouseButton);
 		glfwSetCursorPosCallback(Window::Get()->GetWindow(), CallbackCursorPos);
 		glfwSetCursorEnterCallback(Window::Get()->GetWindow(), CallbackCursorEnter);
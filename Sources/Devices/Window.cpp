@@ -112,6 +112,10 @@ namespace acid
 		m_iconified(false),
 		m_window(nullptr)
 	{
+		// GLFW may only poll events from the main thread.
+		AddWrite<Window>();
+		SetMainThread(true);
+
 		// Set the error error callback
 		glfwSetErrorCallback(CallbackError);
 
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <utility>
+#include "Profiler.hpp"
 
 namespace acid
 {
@@ -20,6 +21,9 @@ namespace acid
 	{
 		INSTANCE = this;
 		Log::OpenLog("Logs/" + GetDateTime() + ".log");
+#if defined(ACID_PROFILE)
+		Profiler::SetThreadName("Main");
+#endif
 
 		if (!emptyRegister)
 		{
@@ -2,6 +2,7 @@
 
 #include "Helpers/NonCopyable.hpp"
 #include "Maths/Time.hpp"
+#include "Threads/ThreadPool.hpp"
 #include "ModuleManager.hpp"
 #include "ModuleUpdater.hpp"
 #include "Log.hpp"
@@ -44,6 +45,12 @@ namespace acid
 		/// <returns> The engines module manager. </returns>
 		ModuleManager &GetModuleManager() { return m_moduleManager; }
 
+		/// <summary>
+		/// Gets the job system shared by the engine and its modules, work submitted here is run across every core.
+		/// </summary>
+		/// <returns> The engines thread pool. </returns>
+		ThreadPool &GetThreadPool() { return m_threadPool; }
+
 		/// <summary>
 		/// Gets the current game.
 		/// </summary>
@@ -136,6 +143,8 @@ namespace acid
 	private:
 		static ACID_STATE Engine *INSTANCE;
 
+		// Declared before the modules so it is destroyed after them, modules may still wait on jobs while shutting down.
+		ThreadPool m_threadPool;
 		ModuleManager m_moduleManager;
 		ModuleUpdater m_moduleUpdater;
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <typeindex>
+#include <vector>
 #include "Helpers/NonCopyable.hpp"
 #include "Exports.hpp"
 
@@ -28,5 +31,77 @@ namespace acid
 		/// The update function for the module.
 		/// </summary>
 		virtual void Update() = 0;
+
+		/// <summary>
+		/// Gets if this module has declared what it accesses, undeclared modules are updated alone.
+		/// </summary>
+		/// <returns> If the module declared its accesses. </returns>
+		bool IsDeclared() const { return !m_reads.empty() || !m_writes.empty(); }
+
+		/// <summary>
+		/// Gets if this module must update on the thread running the engine loop, for APIs such as GLFW.
+		/// </summary>
+		/// <returns> If the module is bound to the main thread. </returns>
+		const bool &IsMainThread() const { return m_mainThread; }
+
+		/// <summary>
+		/// Gets if this module and another module can update at the same time.
+		/// </summary>
+		/// <param name="other"> The other module. </param>
+		/// <returns> If the modules access conflicting types. </returns>
+		bool Conflicts(const Module &other) const
+		{
+			if (!IsDeclared() || !other.IsDeclared())
+			{
+				return true;
+			}
+
+			auto contains = [](const std::vector<std::type_index> &types, const std::type_index &type)
+			{
+				return std::find(types.begin(), types.end(), type) != types.end();
+			};
+
+			for (const auto &type : m_writes)
+			{
+				if (contains(other.m_reads, type) || contains(other.m_writes, type))
+				{
+					return true;
+				}
+			}
+
+			for (const auto &type : other.m_writes)
+			{
+				if (contains(m_reads, type))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+	protected:
+		/// <summary>
+		/// Declares a type this module reads from in <seealso cref="#Update()"/>.
+		/// </summary>
+		/// <param name="T"> The type read, normally another module. </param>
+		template<typename T>
+		void AddRead() { m_reads.emplace_back(typeid(T)); }
+
+		/// <summary>
+		/// Declares a type this module writes to in <seealso cref="#Update()"/>, modules should declare a write to their own type.
+		/// </summary>
+		/// <param name="T"> The type written, normally another module. </param>
+		template<typename T>
+		void AddWrite() { m_writes.emplace_back(typeid(T)); }
+
+		/// <summary>
+		/// Sets if this module must update on the thread running the engine loop.
+		/// </summary>
+		/// <param name="mainThread"> If the module is bound to the main thread. </param>
+		void SetMainThread(const bool &mainThread) { m_mainThread = mainThread; }
+	private:
+		std::vector<std::type_index> m_reads;
+		std::vector<std::type_index> m_writes;
+		bool m_mainThread = false;
 	};
 }
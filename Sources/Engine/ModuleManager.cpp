@@ -14,8 +14,10 @@
 #include "Scenes/Scenes.hpp"
 #include "Shadows/Shadows.hpp"
 #include "Uis/Uis.hpp"
+#include "Engine.hpp"
 #include "Log.hpp"
 #include "Module.hpp"
+#include "Profiler.hpp"
 
 namespace acid
 {
@@ -72,6 +74,7 @@ namespace acid
 
 		float key = static_cast<float>(update) + (0.01f * static_cast<float>(m_modules.size()));
 		m_modules.emplace(key, module);
+		m_levels.clear();
 		return module;
 	}
 
@@ -85,17 +88,94 @@ namespace acid
 			}
 
 			m_modules.erase(it);
+			m_levels.clear();
 		}
 	}
 
 	void ModuleManager::RunUpdate(const Module::Stage &update)
 	{
-		for (auto &[key, module] : m_modules)
+		auto it = m_levels.find(update);
+
+		if (it == m_levels.end())
+		{
+			it = m_levels.emplace(update, BuildLevels(update)).first;
+		}
+
+		// Copied as a module update may register or remove modules, which rebuilds the levels.
+		auto levels = it->second;
+		auto &threadPool = Engine::Get()->GetThreadPool();
+
+		for (const auto &level : levels)
+		{
+			if (level.size() == 1)
+			{
+				ACID_PROFILE_SCOPE(typeid(*level[0]).name());
+				level[0]->Update();
+				continue;
+			}
+
+			std::vector<std::shared_ptr<Job>> jobs;
+
+			for (const auto &module : level)
+			{
+				if (!module->IsMainThread())
+				{
+					jobs.emplace_back(threadPool.Submit([module]()
+					{
+						ACID_PROFILE_SCOPE(typeid(*module).name());
+						module->Update();
+					}));
+				}
+			}
+
+			for (const auto &module : level)
+			{
+				if (module->IsMainThread())
+				{
+					ACID_PROFILE_SCOPE(typeid(*module).name());
+					module->Update();
+				}
+			}
+
+			for (const auto &job : jobs)
+			{
+				threadPool.Wait(job);
+			}
+		}
+	}
+
+	std::vector<std::vector<Module *>> ModuleManager::BuildLevels(const Module::Stage &update) const
+	{
+		std::vector<std::vector<Module *>> levels;
+		std::vector<std::pair<Module *, uint32_t>> placed;
+
+		for (const auto &[key, module] : m_modules)
 		{
-			if (static_cast<uint32_t>(std::floor(key)) == static_cast<uint32_t>(update))
+			if (static_cast<uint32_t>(std::floor(key)) != static_cast<uint32_t>(update))
 			{
-				module->Update();
+				continue;
 			}
+
+			// A module runs one level after the last earlier module it conflicts with.
+			uint32_t level = 0;
+
+			for (const auto &[other, otherLevel] : placed)
+			{
+				if (module->Conflicts(*other))
+				{
+					level = std::max(level, otherLevel + 1);
+				}
+			}
+
+			if (level >= levels.size())
+			{
+				levels.resize(level + 1);
+			}
+
+			levels[level].emplace_back(module.get());
+			placed.emplace_back(module.get(), level);
 		}
+
+		return levels;
 	}
 }
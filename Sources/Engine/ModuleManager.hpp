@@ -2,6 +2,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 #include "Module.hpp"
 
 namespace acid
@@ -93,6 +94,7 @@ namespace acid
 				if (casted != nullptr)
 				{
 					m_modules.erase(it);
+					m_levels.clear();
 				}
 			}
 		}
@@ -100,11 +102,20 @@ namespace acid
 		friend class ModuleUpdater;
 
 		/// <summary>
-		/// Runs updates for all module update types.
+		/// Runs updates for all module update types. Modules are grouped into levels, modules in a level have no conflicting accesses and are updated in parallel,
+		/// while conflicting modules keep their registration order.
 		/// </summary>
 		/// <param name="update"> The modules update type. </param>
 		void RunUpdate(const Module::Stage &update);
 
+		/// <summary>
+		/// Builds the update levels for a stage from the declared module accesses.
+		/// </summary>
+		/// <param name="update"> The modules update type. </param>
+		/// <returns> The modules in each level, in the order the levels run. </returns>
+		std::vector<std::vector<Module *>> BuildLevels(const Module::Stage &update) const;
+
 		std::map<float, std::unique_ptr<Module>> m_modules;
+		std::map<Module::Stage, std::vector<std::vector<Module *>>> m_levels;
 	};
 }
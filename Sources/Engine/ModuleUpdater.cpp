@@ -2,6 +2,7 @@
 
 #include "Engine/Engine.hpp"
 #include "Maths/Maths.hpp"
+#include "Profiler.hpp"
 
 namespace acid
 {
@@ -15,6 +16,7 @@ namespace acid
 
 	void ModuleUpdater::Update(ModuleManager &moduleManager)
 	{
+		ACID_PROFILE_SCOPE("Frame");
 		m_timerRender.SetInterval(Time::Seconds(1.0f / Engine::Get()->GetFpsLimit()));
 
 		// Always-Update.
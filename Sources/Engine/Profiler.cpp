@@ -0,0 +1,216 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#if defined(ACID_BUILD_GNU) || defined(ACID_BUILD_CLANG)
+#include <cxxabi.h>
+#endif
+#include "Log.hpp"
+
+namespace acid
+{
+	const uint32_t Profiler::BufferCapacity = 1 << 16;
+
+	struct ProfilerEvent
+	{
+		const char *m_name;
+		int64_t m_start;
+		int64_t m_end;
+	};
+
+	struct ProfilerBuffer
+	{
+		explicit ProfilerBuffer(const uint32_t &id) :
+			m_id(id),
+			m_name("Thread " + std::to_string(id)),
+			m_events(Profiler::BufferCapacity),
+			m_head(0)
+		{
+		}
+
+		uint32_t m_id;
+		std::string m_name;
+		std::mutex m_mutex;
+		std::vector<ProfilerEvent> m_events;
+		uint64_t m_head;
+	};
+
+	static std::atomic<bool> ENABLED(true);
+	static std::mutex BUFFERS_MUTEX;
+	static std::vector<std::shared_ptr<ProfilerBuffer>> BUFFERS;
+	static const std::chrono::steady_clock::time_point PROFILER_START = std::chrono::steady_clock::now();
+
+	static ProfilerBuffer &GetBuffer()
+	{
+		// Buffers are shared with the registry so events of exited threads can still be exported.
+		thread_local std::shared_ptr<ProfilerBuffer> buffer = []()
+		{
+			std::unique_lock<std::mutex> lock(BUFFERS_MUTEX);
+			auto result = std::make_shared<ProfilerBuffer>(static_cast<uint32_t>(BUFFERS.size()));
+			BUFFERS.emplace_back(result);
+			return result;
+		}();
+		return *buffer;
+	}
+
+	static std::string DemangleName(const char *name)
+	{
+#if defined(ACID_BUILD_GNU) || defined(ACID_BUILD_CLANG)
+		// Only type names from typeid are demangled, a plain scope name could also be a valid mangled builtin type.
+		if (name[0] != 'N' && !std::isdigit(name[0]))
+		{
+			return name;
+		}
+
+		int32_t status = 0;
+		auto demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+
+		if (status == 0 && demangled != nullptr)
+		{
+			std::string result(demangled);
+			free(demangled);
+			return result;
+		}
+#endif
+
+		return name;
+	}
+
+	static void WriteJsonString(std::ostream &stream, const std::string &string)
+	{
+		stream << '"';
+
+		for (const auto &c : string)
+		{
+			switch (c)
+			{
+			case '"':
+				stream << "\\\"";
+				break;
+			case '\\':
+				stream << "\\\\";
+				break;
+			case '\n':
+				stream << "\\n";
+				break;
+			case '\t':
+				stream << "\\t";
+				break;
+			default:
+				stream << c;
+				break;
+			}
+		}
+
+		stream << '"';
+	}
+
+	Profiler::Scope::Scope(const char *name) :
+		m_name(IsEnabled() ? name : nullptr),
+		m_start(m_name != nullptr ? GetTimestamp() : 0)
+	{
+	}
+
+	Profiler::Scope::~Scope()
+	{
+		if (m_name != nullptr)
+		{
+			Record(m_name, m_start, GetTimestamp());
+		}
+	}
+
+	bool Profiler::IsEnabled()
+	{
+		return ENABLED.load(std::memory_order_relaxed);
+	}
+
+	void Profiler::SetEnabled(const bool &enabled)
+	{
+		ENABLED.store(enabled, std::memory_order_relaxed);
+	}
+
+	void Profiler::Record(const char *name, const int64_t &start, const int64_t &end)
+	{
+		auto &buffer = GetBuffer();
+		std::unique_lock<std::mutex> lock(buffer.m_mutex);
+		buffer.m_events[buffer.m_head % BufferCapacity] = ProfilerEvent{name, start, end};
+		buffer.m_head++;
+	}
+
+	void Profiler::SetThreadName(const std::string &name)
+	{
+		auto &buffer = GetBuffer();
+		std::unique_lock<std::mutex> lock(buffer.m_mutex);
+		buffer.m_name = name;
+	}
+
+	void Profiler::Clear()
+	{
+		std::unique_lock<std::mutex> lock(BUFFERS_MUTEX);
+
+		for (auto &buffer : BUFFERS)
+		{
+			std::unique_lock<std::mutex> bufferLock(buffer->m_mutex);
+			buffer->m_head = 0;
+		}
+	}
+
+	std::string Profiler::ExportChromeTrace()
+	{
+		std::stringstream stream;
+		stream.precision(3);
+		stream << std::fixed << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+
+		std::unique_lock<std::mutex> lock(BUFFERS_MUTEX);
+
+		for (auto &buffer : BUFFERS)
+		{
+			std::unique_lock<std::mutex> bufferLock(buffer->m_mutex);
+
+			stream << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->m_id << ",\"args\":{\"name\":";
+			WriteJsonString(stream, buffer->m_name);
+			stream << "}}";
+			first = false;
+
+			auto count = std::min<uint64_t>(buffer->m_head, BufferCapacity);
+
+			for (auto i = buffer->m_head - count; i < buffer->m_head; i++)
+			{
+				auto &event = buffer->m_events[i % BufferCapacity];
+				stream << ",{\"name\":";
+				WriteJsonString(stream, DemangleName(event.m_name));
+				stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->m_id << ",\"ts\":" << static_cast<double>(event.m_start) / 1000.0 << ",\"dur\":" <<
+					static_cast<double>(event.m_end - event.m_start) / 1000.0 << "}";
+			}
+		}
+
+		stream << "]}";
+		return stream.str();
+	}
+
+	void Profiler::WriteChromeTrace(const std::string &filename)
+	{
+		std::ofstream stream(filename);
+
+		if (!stream.is_open())
+		{
+			Log::Error("Could not write profiler trace to '%s'\n", filename.c_str());
+			return;
+		}
+
+		stream << ExportChromeTrace();
+	}
+
+	int64_t Profiler::GetTimestamp()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - PROFILER_START).count();
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "Helpers/NonCopyable.hpp"
+#include "Exports.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// A frame profiler that records named CPU scopes into a ring buffer per thread, scopes nest by time on each thread.
+	/// Recordings can be exported as a Chrome trace, to be viewed in chrome://tracing or Perfetto.
+	/// Scopes are added with <seealso cref="ACID_PROFILE_SCOPE"/>, which compiles to nothing unless ACID_PROFILE is defined.
+	/// </summary>
+	class ACID_EXPORT Profiler
+	{
+	public:
+		/// <summary>
+		/// Records the time between construction and destruction as a event, if the profiler was enabled when constructed.
+		/// </summary>
+		class ACID_EXPORT Scope :
+			public NonCopyable
+		{
+		public:
+			/// <summary>
+			/// Starts a scope.
+			/// </summary>
+			/// <param name="name"> The name of the scope, must outlive the recording. </param>
+			explicit Scope(const char *name);
+
+			~Scope();
+		private:
+			const char *m_name;
+			int64_t m_start;
+		};
+
+		/// <summary>
+		/// Gets if scopes are being recorded.
+		/// </summary>
+		/// <returns> If the profiler is enabled. </returns>
+		static bool IsEnabled();
+
+		static void SetEnabled(const bool &enabled);
+
+		/// <summary>
+		/// Records a event into the calling threads ring buffer, overwriting the oldest event when full.
+		/// </summary>
+		/// <param name="name"> The name of the event, must outlive the recording. </param>
+		/// <param name="start"> The start time in nanoseconds from <seealso cref="#GetTimestamp"/>. </param>
+		/// <param name="end"> The end time in nanoseconds from <seealso cref="#GetTimestamp"/>. </param>
+		static void Record(const char *name, const int64_t &start, const int64_t &end);
+
+		/// <summary>
+		/// Sets the name shown for the calling thread in exported traces.
+		/// </summary>
+		/// <param name="name"> The thread name. </param>
+		static void SetThreadName(const std::string &name);
+
+		/// <summary>
+		/// Removes every recorded event.
+		/// </summary>
+		static void Clear();
+
+		/// <summary>
+		/// Exports the recorded events of every thread in the Chrome trace event format.
+		/// </summary>
+		/// <returns> The trace as a JSON string. </returns>
+		static std::string ExportChromeTrace();
+
+		/// <summary>
+		/// Writes the recorded events of every thread to a Chrome trace file.
+		/// </summary>
+		/// <param name="filename"> The file to write into. </param>
+		static void WriteChromeTrace(const std::string &filename);
+
+		/// <summary>
+		/// Gets the profilers time since startup.
+		/// </summary>
+		/// <returns> The time in nanoseconds. </returns>
+		static int64_t GetTimestamp();
+
+		/// <summary>
+		/// The amount of events each threads ring buffer holds.
+		/// </summary>
+		static const uint32_t BufferCapacity;
+	};
+}
+
+#define ACID_PROFILE_CONCAT_INNER(a, b) a ## b
+#define ACID_PROFILE_CONCAT(a, b) ACID_PROFILE_CONCAT_INNER(a, b)
+
+#if defined(ACID_PROFILE)
+#  define ACID_PROFILE_SCOPE(name) acid::Profiler::Scope ACID_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#  define ACID_PROFILE_FUNCTION() ACID_PROFILE_SCOPE(__FUNCTION__)
+#else
+#  define ACID_PROFILE_SCOPE(name)
+#  define ACID_PROFILE_FUNCTION()
+#endif
@@ -207,6 +207,8 @@ namespace acid
 
 	Files::Files()
 	{
+		AddWrite<Files>();
+
 		PHYSFS_init(Engine::Get()->GetArgv0().c_str());
 	}
 
@@ -78,6 +78,8 @@ namespace acid
 
 		std::optional<Character> GetCharacter(const int32_t &ascii) const;
 
+		const std::map<int32_t, Character> &GetCharacters() const { return m_characters; }
+
 		const std::string &GetFileName() const { return m_filename; }
 
 		const float &GetSpaceWidth() const { return m_spaceWidth; }
@@ -7,11 +7,11 @@ namespace acid
 {
 	std::shared_ptr<FontType> FontType::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<FontType>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<FontType>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<FontType>("", "");
@@ -65,4 +65,16 @@ namespace acid
 		metadata.SetChild("Filename", m_filename);
 		metadata.SetChild("Style", m_style);
 	}
+
+	std::size_t FontType::GetCpuSize() const
+	{
+		std::size_t size = sizeof(FontType) + m_filename.capacity() + m_style.capacity();
+
+		if (m_metadata != nullptr)
+		{
+			size += sizeof(FontMetafile) + m_metadata->GetCharacters().size() * sizeof(FontMetafile::Character);
+		}
+
+		return size;
+	}
 }
@@ -33,7 +33,7 @@ namespace acid
 		/// <param name="filename"> The family file path that the texture atlases and character infos are contained in. </param>
 		/// <param name="fontStyle"> The style selected to load as this type. </param>
 		/// <param name="load"> If this resource will load immediately, otherwise <seealso cref="#Load()"/> can be called. </param>
-		FontType(std::string filename, std::string fontStyle, const bool &load = true);
+		explicit FontType(std::string filename = "", std::string fontStyle = "", const bool &load = true);
 
 		void Load() override;
 
@@ -41,6 +41,8 @@ namespace acid
 
 		void Encode(Metadata &metadata) const override;
 
+		std::size_t GetCpuSize() const override;
+
 		const std::shared_ptr<Texture> &GetTexture() const { return m_texture; }
 
 		const FontMetafile *GetMetadata() const { return m_metadata.get(); }
@@ -2,22 +2,21 @@
 #include <utility>
 
 #include "Resources/Resources.hpp"
+#include "Renderer/Renderer.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Gizmo.hpp"
 
 namespace acid
 {
-	static const uint32_t MAX_INSTANCES = 512;
-//	static const uint32_t INSTANCE_STEPS = 128;
 //	static const float FRUSTUM_BUFFER = 1.4f;
 
 	std::shared_ptr<GizmoType> GizmoType::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<GizmoType>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<GizmoType>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<GizmoType>(nullptr);
@@ -38,10 +37,7 @@ namespace acid
 	GizmoType::GizmoType(std::shared_ptr<Model> model, const float &lineThickness, const Colour &diffuse) :
 		m_model(std::move(model)),
 		m_lineThickness(lineThickness),
-		m_diffuse(diffuse),
-		m_maxInstances(0),
-		m_instances(0),
-		m_instanceBuffer(sizeof(GizmoTypeData) * MAX_INSTANCES)
+		m_diffuse(diffuse)
 	{
 	}
 
@@ -68,11 +64,16 @@ namespace acid
 		// Draws the instanced objects.
 		m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
 
-		VkBuffer vertexBuffers[] = {m_model->GetVertexBuffer()->GetBuffer(), m_instanceBuffer.GetBuffer()};
-		VkDeviceSize offsets[] = {0, 0};
-		vkCmdBindVertexBuffers(commandBuffer.GetCommandBuffer(), 0, 2, vertexBuffers, offsets);
 		vkCmdBindIndexBuffer(commandBuffer.GetCommandBuffer(), m_model->GetIndexBuffer()->GetBuffer(), 0, m_model->GetIndexType());
-		vkCmdDrawIndexed(commandBuffer.GetCommandBuffer(), m_model->GetIndexCount(), m_instances, 0, 0, 0);
+
+		for (const auto &batch : m_batches)
+		{
+			VkBuffer vertexBuffers[] = {m_model->GetVertexBuffer()->GetBuffer(), batch.m_buffer};
+			VkDeviceSize offsets[] = {0, batch.m_offset};
+			vkCmdBindVertexBuffers(commandBuffer.GetCommandBuffer(), 0, 2, vertexBuffers, offsets);
+			vkCmdDrawIndexed(commandBuffer.GetCommandBuffer(), m_model->GetIndexCount(), batch.m_instances, 0, 0, 0);
+		}
+
 		return true;
 	}
 
@@ -83,35 +84,25 @@ namespace acid
 			return false;
 		}
 
-		// Calculates a max instance count over the time of the type. TODO: Allow decreasing max using a timer and average count over the delay.
-	//	uint32_t instances = INSTANCE_STEPS * static_cast<uint32_t>(std::ceil(static_cast<float>(gizmos.size()) / static_cast<float>(INSTANCE_STEPS)));
-	//	m_maxInstances = std::max(m_maxInstances, instances);
-		m_maxInstances = MAX_INSTANCES;
-		m_instances = 0;
-
-		GizmoTypeData *gizmoInstances;
-		m_instanceBuffer.Map(reinterpret_cast<void **>(&gizmoInstances));
+		// Every gizmo is drawn, instances are written into batches taken from the instance pool, which grows to fit them.
+		Renderer::Get()->GetInstancePool()->Allocate(sizeof(GizmoTypeData), static_cast<uint32_t>(gizmos.size()), m_batches, m_batchInstances);
+		uint32_t instanceIndex = 0;
 
 		for (const auto &gizmo : gizmos)
 		{
-			if (m_instances >= m_maxInstances)
-			{
-				break;
-			}
-
 		//	if (!Scenes::Get()->GetCamera()->GetViewFrustum().SphereInFrustum(gizmo->GetTransform().GetPosition(), FRUSTUM_BUFFER * gizmo->GetTransform().GetPosition().GetScale()))
 		//	{
 		//		continue;
 		//	}
 
-			auto instance = &gizmoInstances[m_instances];
+			auto batchInstances = static_cast<GizmoTypeData *>(m_batchInstances[instanceIndex / InstancePool::BatchInstances]);
+			auto instance = &batchInstances[instanceIndex % InstancePool::BatchInstances];
 			instance->modelMatrix = gizmo->GetTransform().GetWorldMatrix();
 			instance->diffuse = gizmo->GetDiffuse();
-			m_instances++;
+			instanceIndex++;
 		}
 
-		m_instanceBuffer.Unmap();
-		return m_instances != 0;
+		return true;
 	}
 
 	void GizmoType::Decode(const Metadata &metadata)
@@ -128,6 +119,11 @@ namespace acid
 		metadata.SetChild("Diffuse", m_diffuse);
 	}
 
+	std::size_t GizmoType::GetCpuSize() const
+	{
+		return sizeof(GizmoType) + m_batches.capacity() * sizeof(InstancePool::Batch) + m_batchInstances.capacity() * sizeof(void *);
+	}
+
 	Shader::VertexInput GizmoType::GetVertexInput(const uint32_t &binding)
 	{
 		std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
@@ -3,7 +3,7 @@
 #include "Maths/Colour.hpp"
 #include "Maths/Matrix4.hpp"
 #include "Models/Model.hpp"
-#include "Renderer/Buffers/InstanceBuffer.hpp"
+#include "Renderer/Buffers/InstancePool.hpp"
 #include "Renderer/Handlers/DescriptorsHandler.hpp"
 #include "Renderer/Pipelines/PipelineGraphics.hpp"
 #include "Resources/Resource.hpp"
@@ -45,6 +45,8 @@ namespace acid
 
 		void Encode(Metadata &metadata) const override;
 
+		std::size_t GetCpuSize() const override;
+
 		static Shader::VertexInput GetVertexInput(const uint32_t &binding = 0);
 
 		const std::shared_ptr<Model> &GetModel() const { return m_model; }
@@ -71,10 +73,8 @@ namespace acid
 		float m_lineThickness;
 		Colour m_diffuse;
 
-		uint32_t m_maxInstances;
-		uint32_t m_instances;
-
 		DescriptorsHandler m_descriptorSet;
-		InstanceBuffer m_instanceBuffer;
+		std::vector<InstancePool::Batch> m_batches;
+		std::vector<void *> m_batchInstances;
 	};
 }
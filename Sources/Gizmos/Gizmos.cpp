@@ -4,6 +4,7 @@ namespace acid
 {
 	Gizmos::Gizmos()
 	{
+		AddWrite<Gizmos>();
 	}
 
 	void Gizmos::Update()
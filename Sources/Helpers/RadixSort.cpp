@@ -0,0 +1,134 @@
+#include "RadixSort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include "Engine/Engine.hpp"
+
+namespace acid
+{
+	const uint32_t RadixSort::ParallelSize = 65536;
+
+	static const uint32_t DIGIT_BITS = 11;
+	static const uint32_t BUCKET_COUNT = 1u << DIGIT_BITS;
+	static const uint32_t PASS_COUNT = 3;
+
+	void RadixSort::Sort(std::vector<Entry> &entries, std::vector<Entry> &scratch, const bool &descending)
+	{
+		auto size = static_cast<uint32_t>(entries.size());
+
+		if (size < 2)
+		{
+			return;
+		}
+
+		scratch.resize(entries.size());
+
+		// Each chunk is a contiguous range histogrammed and scattered by one job, scattering chunks in order keeps the sort stable.
+		uint32_t chunkCount = 1;
+
+		if (size >= ParallelSize)
+		{
+			chunkCount = std::clamp(Engine::Get()->GetThreadPool().GetWorkerCount(), 1u, size / (ParallelSize / 4));
+		}
+
+		std::vector<std::array<uint32_t, BUCKET_COUNT>> offsets(chunkCount);
+
+		auto chunkBegin = [size, chunkCount](const uint32_t &chunk)
+		{
+			return static_cast<uint32_t>(static_cast<uint64_t>(size) * chunk / chunkCount);
+		};
+
+		auto forEachChunk = [chunkCount](const std::function<void(uint32_t)> &function)
+		{
+			if (chunkCount == 1)
+			{
+				function(0);
+				return;
+			}
+
+			Engine::Get()->GetThreadPool().ParallelFor(0, chunkCount, [&function](uint32_t from, uint32_t to)
+			{
+				for (uint32_t chunk = from; chunk < to; chunk++)
+				{
+					function(chunk);
+				}
+			}, 1);
+		};
+
+		auto source = &entries;
+		auto destination = &scratch;
+		auto mask = BUCKET_COUNT - 1;
+
+		for (uint32_t pass = 0; pass < PASS_COUNT; pass++)
+		{
+			auto shift = pass * DIGIT_BITS;
+
+			forEachChunk([&](uint32_t chunk)
+			{
+				auto &counts = offsets[chunk];
+				counts.fill(0);
+
+				for (uint32_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); i++)
+				{
+					counts[(ToKey((*source)[i].first, descending) >> shift) & mask]++;
+				}
+			});
+
+			// Counts become the offset each chunk starts writing a bucket at, buckets in order and chunks in order inside each bucket.
+			uint32_t offset = 0;
+			bool sorted = false;
+
+			for (uint32_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+			{
+				uint32_t bucketStart = offset;
+
+				for (auto &counts : offsets)
+				{
+					auto count = counts[bucket];
+					counts[bucket] = offset;
+					offset += count;
+				}
+
+				// When every key has the same digit the pass would not move anything.
+				if (offset - bucketStart == size)
+				{
+					sorted = true;
+					break;
+				}
+			}
+
+			if (sorted)
+			{
+				continue;
+			}
+
+			forEachChunk([&](uint32_t chunk)
+			{
+				auto &counts = offsets[chunk];
+
+				for (uint32_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); i++)
+				{
+					auto &entry = (*source)[i];
+					(*destination)[counts[(ToKey(entry.first, descending) >> shift) & mask]++] = entry;
+				}
+			});
+
+			std::swap(source, destination);
+		}
+
+		if (source != &entries)
+		{
+			entries.swap(scratch);
+		}
+	}
+
+	uint32_t RadixSort::ToKey(const float &value, const bool &descending)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(uint32_t));
+		bits ^= (bits & 0x80000000u) != 0 ? 0xFFFFFFFFu : 0x80000000u;
+		return descending ? ~bits : bits;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Engine/Exports.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// A stable least significant digit radix sort over float keys, each entry carries a index back to the sorted item.
+	/// Keys are split into three 11 bit digits, large ranges histogram and scatter contiguous chunks on the engines thread pool.
+	/// </summary>
+	class ACID_EXPORT RadixSort
+	{
+	public:
+		using Entry = std::pair<float, uint32_t>;
+
+		/// <summary>
+		/// Sorts entries by their key, entries with the same key keep their order.
+		/// </summary>
+		/// <param name="entries"> The entries to sort, sorted in place. </param>
+		/// <param name="scratch"> A buffer entries are scattered into between passes, kept by the caller so it is not allocated each sort. </param>
+		/// <param name="descending"> If the largest keys are placed first. </param>
+		static void Sort(std::vector<Entry> &entries, std::vector<Entry> &scratch, const bool &descending = false);
+
+		/// <summary>
+		/// Converts a float into a unsigned key that orders the same way, negative floats have every bit flipped and positive floats only the sign bit.
+		/// </summary>
+		/// <param name="value"> The float to convert. </param>
+		/// <param name="descending"> If the key is inverted so larger floats order first. </param>
+		/// <returns> The key. </returns>
+		static uint32_t ToKey(const float &value, const bool &descending);
+
+		/// <summary>
+		/// The amount of entries where sorting is split across the thread pool.
+		/// </summary>
+		static const uint32_t ParallelSize;
+	};
+}
@@ -35,12 +35,8 @@ namespace acid
 
 	Transform Light::GetWorldTransform() const
 	{
-		if (m_localTransform.IsDirty() || GetParent()->GetWorldTransform().IsDirty())
-		{
-			m_worldTransform = GetParent()->GetWorldTransform() * m_localTransform;
-			m_localTransform.SetDirty(false);
-		}
-
+		// The parents world transform is cached, so composing with it each call is cheap and never misses a parent change.
+		m_worldTransform = GetParent()->GetWorldTransform() * m_localTransform;
 		return m_worldTransform;
 	}
 }
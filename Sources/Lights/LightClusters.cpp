@@ -0,0 +1,144 @@
+#include "LightClusters.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace acid
+{
+	LightClusters::LightClusters(const uint32_t &tilesX, const uint32_t &tilesY, const uint32_t &slices) :
+		m_tilesX(tilesX),
+		m_tilesY(tilesY),
+		m_slices(slices),
+		m_planesX(tilesX + 1),
+		m_planesY(tilesY + 1),
+		m_sliceNear(0.1f),
+		m_sliceFar(1000.0f),
+		m_sliceScale(1.0f),
+		m_clusters(tilesX * tilesY * slices)
+	{
+	}
+
+	void LightClusters::Reset(const Camera &camera)
+	{
+		auto &projection = camera.GetProjectionMatrix();
+		m_viewMatrix = camera.GetViewMatrix();
+
+		// Each tile edge is a plane through the camera, points in front of the camera with a larger normalized device coordinate are on its positive side.
+		for (uint32_t i = 0; i <= m_tilesX; i++)
+		{
+			auto edge = -1.0f + (2.0f * static_cast<float>(i) / static_cast<float>(m_tilesX));
+			m_planesX[i] = Vector3(projection[0][0], 0.0f, edge).Normalize();
+		}
+
+		for (uint32_t i = 0; i <= m_tilesY; i++)
+		{
+			auto edge = -1.0f + (2.0f * static_cast<float>(i) / static_cast<float>(m_tilesY));
+			m_planesY[i] = Vector3(0.0f, projection[1][1], edge).Normalize();
+		}
+
+		m_sliceNear = camera.GetNearPlane();
+		m_sliceFar = camera.GetFarPlane();
+		m_sliceScale = static_cast<float>(m_slices) / std::log(m_sliceFar / m_sliceNear);
+		m_ranges.clear();
+	}
+
+	bool LightClusters::Add(const uint32_t &index, const Vector3 &position, const float &radius)
+	{
+		auto viewPosition = m_viewMatrix.Transform(Vector4(position, 1.0f));
+		auto centre = Vector3(viewPosition.m_x, viewPosition.m_y, viewPosition.m_z);
+		auto depth = -centre.m_z;
+
+		if (depth + radius < m_sliceNear || depth - radius > m_sliceFar)
+		{
+			return false;
+		}
+
+		// A tile is touched when the sphere reaches past both of its edges towards the inside.
+		auto findRange = [&centre, &radius](const std::vector<Vector3> &planes, uint32_t &first, uint32_t &last)
+		{
+			first = static_cast<uint32_t>(planes.size());
+			last = 0;
+
+			for (uint32_t i = 0; i + 1 < planes.size(); i++)
+			{
+				if (planes[i].Dot(centre) > -radius && planes[i + 1].Dot(centre) < radius)
+				{
+					first = std::min(first, i);
+					last = i + 1;
+				}
+			}
+
+			return first < last;
+		};
+
+		LightRange range = {};
+		range.m_index = index;
+
+		if (!findRange(m_planesX, range.m_x0, range.m_x1) || !findRange(m_planesY, range.m_y0, range.m_y1))
+		{
+			return false;
+		}
+
+		range.m_z0 = GetSlice(depth - radius);
+		range.m_z1 = GetSlice(depth + radius) + 1;
+		m_ranges.emplace_back(range);
+		return true;
+	}
+
+	void LightClusters::Build()
+	{
+		for (auto &cluster : m_clusters)
+		{
+			cluster = {};
+		}
+
+		auto forEachCluster = [this](const LightRange &range, const auto &function)
+		{
+			for (auto z = range.m_z0; z < range.m_z1; z++)
+			{
+				for (auto y = range.m_y0; y < range.m_y1; y++)
+				{
+					for (auto x = range.m_x0; x < range.m_x1; x++)
+					{
+						function(m_clusters[x + (m_tilesX * (y + (m_tilesY * z)))]);
+					}
+				}
+			}
+		};
+
+		// Counts the lights of each cluster, then lays the clusters out one after another and fills them.
+		for (const auto &range : m_ranges)
+		{
+			forEachCluster(range, [](Cluster &cluster)
+			{
+				cluster.m_count++;
+			});
+		}
+
+		uint32_t offset = 0;
+
+		for (auto &cluster : m_clusters)
+		{
+			cluster.m_offset = offset;
+			offset += cluster.m_count;
+			cluster.m_count = 0;
+		}
+
+		m_indices.resize(offset);
+
+		for (const auto &range : m_ranges)
+		{
+			forEachCluster(range, [this, &range](Cluster &cluster)
+			{
+				m_indices[cluster.m_offset + cluster.m_count] = range.m_index;
+				cluster.m_count++;
+			});
+		}
+	}
+
+	uint32_t LightClusters::GetSlice(const float &depth) const
+	{
+		auto slice = std::floor(std::log(std::max(depth, m_sliceNear) / m_sliceNear) * m_sliceScale);
+		return static_cast<uint32_t>(std::clamp(slice, 0.0f, static_cast<float>(m_slices - 1)));
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include "Maths/Vector3.hpp"
+#include "Scenes/Camera.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// Assigns bounded lights to clusters of the view frustum, so shading only loops over the lights that can reach a pixel.
+	/// Clusters are screen tiles split into slices that grow exponentially with the view depth.
+	/// </summary>
+	class ACID_EXPORT LightClusters
+	{
+	public:
+		/// <summary>
+		/// The lights of a cluster, a range into the light indices.
+		/// </summary>
+		struct Cluster
+		{
+			uint32_t m_offset;
+			uint32_t m_count;
+		};
+
+		/// <summary>
+		/// Creates a new cluster grid.
+		/// </summary>
+		/// <param name="tilesX"> The amount of tiles across the screen. </param>
+		/// <param name="tilesY"> The amount of tiles down the screen. </param>
+		/// <param name="slices"> The amount of slices between the near and far plane. </param>
+		LightClusters(const uint32_t &tilesX, const uint32_t &tilesY, const uint32_t &slices);
+
+		/// <summary>
+		/// Clears the lights, the planes of the tiles and slices are rebuilt from the camera.
+		/// </summary>
+		/// <param name="camera"> The camera the clusters divide the view of. </param>
+		void Reset(const Camera &camera);
+
+		/// <summary>
+		/// Adds a light to every cluster its sphere of influence touches.
+		/// </summary>
+		/// <param name="index"> The index of the light, as stored in the cluster indices. </param>
+		/// <param name="position"> The world position of the light. </param>
+		/// <param name="radius"> The radius of the light, must be positive. </param>
+		/// <returns> If the light touches any cluster. </returns>
+		bool Add(const uint32_t &index, const Vector3 &position, const float &radius);
+
+		/// <summary>
+		/// Builds the clusters and light indices from the added lights.
+		/// </summary>
+		void Build();
+
+		const std::vector<Cluster> &GetClusters() const { return m_clusters; }
+
+		const std::vector<uint32_t> &GetIndices() const { return m_indices; }
+
+		const uint32_t &GetTilesX() const { return m_tilesX; }
+
+		const uint32_t &GetTilesY() const { return m_tilesY; }
+
+		const uint32_t &GetSlices() const { return m_slices; }
+
+		/// <summary>
+		/// Gets the view depth of the first slice.
+		/// </summary>
+		/// <returns> The near plane of the camera. </returns>
+		const float &GetSliceNear() const { return m_sliceNear; }
+
+		/// <summary>
+		/// Gets the scale from the log of a depth over the near plane to a slice, slice = floor(log(depth / near) * scale).
+		/// </summary>
+		/// <returns> The slice scale. </returns>
+		const float &GetSliceScale() const { return m_sliceScale; }
+	private:
+		/// <summary>
+		/// The box of clusters a light touches, end values are exclusive.
+		/// </summary>
+		struct LightRange
+		{
+			uint32_t m_index;
+			uint32_t m_x0, m_x1;
+			uint32_t m_y0, m_y1;
+			uint32_t m_z0, m_z1;
+		};
+
+		uint32_t GetSlice(const float &depth) const;
+
+		uint32_t m_tilesX;
+		uint32_t m_tilesY;
+		uint32_t m_slices;
+
+		Matrix4 m_viewMatrix;
+		std::vector<Vector3> m_planesX;
+		std::vector<Vector3> m_planesY;
+		float m_sliceNear;
+		float m_sliceFar;
+		float m_sliceScale;
+
+		std::vector<LightRange> m_ranges;
+		std::vector<Cluster> m_clusters;
+		std::vector<uint32_t> m_indices;
+	};
+}
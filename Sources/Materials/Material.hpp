@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include "Scenes/Component.hpp"
 #include "Renderer/Handlers/DescriptorsHandler.hpp"
 #include "Renderer/Handlers/UniformHandler.hpp"
@@ -35,6 +36,25 @@ namespace acid
 		/// <param name="descriptorSet"> The descriptor handler to update. </param>
 		virtual void PushDescriptors(DescriptorsHandler &descriptorSet) = 0;
 
+		/// <summary>
+		/// Gets a key shared by materials that can be drawn together as instances of one draw call.
+		/// Materials with equal keys must use the same pipeline and push identical descriptors.
+		/// </summary>
+		/// <returns> The instance key, or nothing if this material cannot be instanced. </returns>
+		virtual std::optional<std::size_t> GetInstanceKey() const { return std::nullopt; }
+
+		/// <summary>
+		/// Gets the size in bytes of the per instance data written by <seealso cref="#PushInstance()"/>.
+		/// </summary>
+		/// <returns> The instance size. </returns>
+		virtual std::size_t GetInstanceSize() const { return 0; }
+
+		/// <summary>
+		/// Used to write this materials per instance data when it is drawn as a instance.
+		/// </summary>
+		/// <param name="instance"> The instance data to write, <seealso cref="#GetInstanceSize()"/> bytes long. </param>
+		virtual void PushInstance(void *instance) const {}
+
 		/// <summary>
 		/// Gets the material pipeline defined in this material.
 		/// </summary>
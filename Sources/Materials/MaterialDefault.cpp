@@ -7,6 +7,11 @@
 
 namespace acid
 {
+	static void HashCombine(std::size_t &seed, const std::size_t &value)
+	{
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
 	MaterialDefault::MaterialDefault(const Colour &baseDiffuse, std::shared_ptr<Texture> diffuseTexture, 
 		const float &metallic, const float &roughness, std::shared_ptr<Texture> materialTexture, std::shared_ptr<Texture> normalTexture, 
 		const bool &castsShadows, const bool &ignoreLighting, const bool &ignoreFog) :
@@ -34,7 +39,16 @@ namespace acid
 		}
 
 		m_animated = dynamic_cast<MeshAnimated *>(mesh) != nullptr;
-		m_pipelineMaterial = PipelineMaterial::Create({1, 0}, PipelineGraphicsCreate({"Shaders/Defaults/Default.vert", "Shaders/Defaults/Default.frag"}, {mesh->GetVertexInput()},
+
+		// Animated meshes keep their joints in the object uniform, everything else is drawn instanced.
+		std::vector<Shader::VertexInput> vertexInputs = {mesh->GetVertexInput(0)};
+
+		if (!m_animated)
+		{
+			vertexInputs.emplace_back(GetInstanceInput(1));
+		}
+
+		m_pipelineMaterial = PipelineMaterial::Create({1, 0}, PipelineGraphicsCreate({"Shaders/Defaults/Default.vert", "Shaders/Defaults/Default.frag"}, vertexInputs,
 			PipelineGraphics::Mode::Mrt, PipelineGraphics::Depth::ReadWrite, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, false, GetDefines()));
 	}
 
@@ -74,13 +88,16 @@ namespace acid
 
 	void MaterialDefault::PushUniforms(UniformHandler &uniformObject)
 	{
-		if (m_animated)
+		// Instanced materials write these values in PushInstance instead.
+		if (!m_animated)
 		{
-			auto meshAnimated = GetParent()->GetComponent<MeshAnimated>();
-			auto joints = meshAnimated->GetJointTransforms(); // TODO: Move into storage buffer and update every frame.
-			uniformObject.Push("jointTransforms", *joints.data(), sizeof(Matrix4) * joints.size());
+			return;
 		}
 
+		auto meshAnimated = GetParent()->GetComponent<MeshAnimated>();
+		auto joints = meshAnimated->GetJointTransforms(); // TODO: Move into storage buffer and update every frame.
+		uniformObject.Push("jointTransforms", *joints.data(), sizeof(Matrix4) * joints.size());
+
 		uniformObject.Push("transform", GetParent()->GetWorldMatrix());
 		uniformObject.Push("baseDiffuse", m_baseDiffuse);
 		uniformObject.Push("metallic", m_metallic);
@@ -96,6 +113,68 @@ namespace acid
 		descriptorSet.Push("samplerNormal", m_normalTexture);
 	}
 
+	std::optional<std::size_t> MaterialDefault::GetInstanceKey() const
+	{
+		if (m_animated || m_pipelineMaterial == nullptr)
+		{
+			return std::nullopt;
+		}
+
+		// Materials sharing a pipeline only differ by their textures, everything else is per instance data.
+		std::hash<const void *> hasher;
+		std::size_t key = 0;
+		HashCombine(key, hasher(m_diffuseTexture.get()));
+		HashCombine(key, hasher(m_materialTexture.get()));
+		HashCombine(key, hasher(m_normalTexture.get()));
+		return key;
+	}
+
+	void MaterialDefault::PushInstance(void *instance) const
+	{
+		auto data = static_cast<Instance *>(instance);
+		data->m_transform = GetParent()->GetWorldMatrix();
+		data->m_baseDiffuse = m_baseDiffuse;
+		data->m_metallic = m_metallic;
+		data->m_roughness = m_roughness;
+		data->m_ignoreFog = static_cast<float>(m_ignoreFog);
+		data->m_ignoreLighting = static_cast<float>(m_ignoreLighting);
+	}
+
+	Shader::VertexInput MaterialDefault::GetInstanceInput(const uint32_t &binding)
+	{
+		std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+
+		// The instance input description.
+		bindingDescriptions[0].binding = binding;
+		bindingDescriptions[0].stride = sizeof(Instance);
+		bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+		std::vector<VkVertexInputAttributeDescription> attributeDescriptions(6);
+
+		// Transform rows 0 to 3 attributes.
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			attributeDescriptions[i].binding = binding;
+			attributeDescriptions[i].location = i;
+			attributeDescriptions[i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+			attributeDescriptions[i].offset = offsetof(Instance, m_transform) + offsetof(Matrix4, m_rows) + (i * sizeof(Vector4));
+		}
+
+		// Base diffuse attribute.
+		attributeDescriptions[4].binding = binding;
+		attributeDescriptions[4].location = 4;
+		attributeDescriptions[4].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		attributeDescriptions[4].offset = offsetof(Instance, m_baseDiffuse);
+
+		// Metallic, roughness, ignore fog and ignore lighting attribute.
+		attributeDescriptions[5].binding = binding;
+		attributeDescriptions[5].location = 5;
+		attributeDescriptions[5].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		attributeDescriptions[5].offset = offsetof(Instance, m_metallic);
+
+		return Shader::VertexInput(binding, bindingDescriptions, attributeDescriptions);
+	}
+
 	std::vector<Shader::Define> MaterialDefault::GetDefines() const
 	{
 		std::vector<Shader::Define> result = {};
@@ -103,6 +182,7 @@ namespace acid
 		result.emplace_back("MATERIAL_MAPPING", String::To<int32_t>(m_materialTexture != nullptr));
 		result.emplace_back("NORMAL_MAPPING", String::To<int32_t>(m_normalTexture != nullptr));
 		result.emplace_back("ANIMATED", String::To<int32_t>(m_animated));
+		result.emplace_back("INSTANCED", String::To<int32_t>(!m_animated));
 		result.emplace_back("MAX_JOINTS", String::To(MeshAnimated::MaxJoints));
 		result.emplace_back("MAX_WEIGHTS", String::To(MeshAnimated::MaxWeights));
 		return result;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Maths/Colour.hpp"
+#include "Maths/Matrix4.hpp"
 #include "Models/Model.hpp"
 #include "Textures/Texture.hpp"
 #include "Material.hpp"
@@ -14,6 +15,19 @@ namespace acid
 		public Material
 	{
 	public:
+		/// <summary>
+		/// The per instance data of a non animated default material, read as vertex attributes.
+		/// </summary>
+		struct Instance
+		{
+			Matrix4 m_transform;
+			Colour m_baseDiffuse;
+			float m_metallic;
+			float m_roughness;
+			float m_ignoreFog;
+			float m_ignoreLighting;
+		};
+
 		explicit MaterialDefault(const Colour &baseDiffuse = Colour::White, std::shared_ptr<Texture> diffuseTexture = nullptr,
 			const float &metallic = 0.0f, const float &roughness = 0.0f, std::shared_ptr<Texture> materialTexture = nullptr, std::shared_ptr<Texture> normalTexture = nullptr, 
 			const bool &castsShadows = true, const bool &ignoreLighting = false, const bool &ignoreFog = false);
@@ -30,6 +44,14 @@ namespace acid
 
 		void PushDescriptors(DescriptorsHandler &descriptorSet) override;
 
+		std::optional<std::size_t> GetInstanceKey() const override;
+
+		std::size_t GetInstanceSize() const override { return sizeof(Instance); }
+
+		void PushInstance(void *instance) const override;
+
+		static Shader::VertexInput GetInstanceInput(const uint32_t &binding = 1);
+
 		const Colour &GetBaseDiffuse() const { return m_baseDiffuse; }
 
 		void SetBaseDiffuse(const Colour &baseDiffuse) { m_baseDiffuse = baseDiffuse; }
@@ -11,11 +11,11 @@ namespace acid
 		Metadata metadata = Metadata();
 		temp.Encode(metadata);
 
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<PipelineMaterial>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<PipelineMaterial>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<PipelineMaterial>(pipelineStage, pipelineCreate);
@@ -47,6 +47,12 @@ namespace acid
 			m_pipeline.reset(m_pipelineCreate.Create(m_pipelineStage));
 		}
 
+		// Draws using this material are skipped while its pipeline builds on the thread pool.
+		if (!m_pipeline->IsReady())
+		{
+			return false;
+		}
+
 		m_pipeline->BindPipeline(commandBuffer);
 		return true;
 	}
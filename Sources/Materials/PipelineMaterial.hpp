@@ -30,6 +30,7 @@ namespace acid
 		/// Binds this pipeline to the current renderpass.
 		/// </summary>
 		/// <param name="commandBuffer"> The command buffer to write to. </param>
+		/// <returns> If the pipeline was bound, false while it is still being built. </returns>
 		bool BindPipeline(const CommandBuffer &commandBuffer);
 
 		void Decode(const Metadata &metadata) override;
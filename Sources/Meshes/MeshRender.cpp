@@ -1,9 +1,8 @@
 #include "MeshRender.hpp"
 
 #include "Materials/Material.hpp"
-#include "Physics/Rigidbody.hpp"
+#include "Renderer/Renderer.hpp"
 #include "Scenes/Entity.hpp"
-#include "Scenes/Scenes.hpp"
 
 namespace acid
 {
@@ -24,49 +23,47 @@ namespace acid
 		material->PushUniforms(m_uniformObject);
 	}
 
-	bool MeshRender::CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const Pipeline::Stage &pipelineStage)
+	bool MeshRender::CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const PipelineGraphics &pipeline)
 	{
-		// Checks if the mesh is in view.
-		auto rigidbody = GetParent()->GetComponent<Rigidbody>();
-
-		if (rigidbody != nullptr)
-		{
-			if (!rigidbody->InFrustum(Scenes::Get()->GetCamera()->GetViewFrustum()))
-			{
-				return false;
-			}
-		}
-
 		// Gets required components.
 		auto material = GetParent()->GetComponent<Material>();
 		auto mesh = GetParent()->GetComponent<Mesh>();
 
-		if (material == nullptr || mesh == nullptr)
+		if (material == nullptr || mesh == nullptr || mesh->GetModel() == nullptr)
 		{
 			return false;
 		}
 
-		auto meshModel = mesh->GetModel();
-		auto materialPipeline = material->GetPipelineMaterial();
+		// Updates descriptors.
+		m_descriptorSet.Push("UboScene", uniformScene);
+		m_descriptorSet.Push("UboObject", m_uniformObject);
+		material->PushDescriptors(m_descriptorSet);
+		bool updateSuccess = m_descriptorSet.Update(pipeline);
 
-		if (meshModel == nullptr || materialPipeline->GetStage() != pipelineStage)
+		if (!updateSuccess)
 		{
 			return false;
 		}
 
-		// Binds the material pipeline.
-		bool bindSuccess = materialPipeline->BindPipeline(commandBuffer);
+		// Draws the object.
+		m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
+		return mesh->GetModel()->CmdRender(commandBuffer);
+	}
+
+	bool MeshRender::CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const PipelineGraphics &pipeline, const VkDeviceSize &instanceOffset,
+		const uint32_t &instanceCount, const std::optional<VkDeviceSize> &indirectOffset)
+	{
+		// Gets required components.
+		auto material = GetParent()->GetComponent<Material>();
+		auto mesh = GetParent()->GetComponent<Mesh>();
 
-		if (!bindSuccess)
+		if (material == nullptr || mesh == nullptr || mesh->GetModel() == nullptr)
 		{
 			return false;
 		}
 
-		auto &pipeline = *materialPipeline->GetPipeline();
-
-		// Updates descriptors.
+		// Every instance shares this materials descriptors, per object values are read from the instance buffer.
 		m_descriptorSet.Push("UboScene", uniformScene);
-		m_descriptorSet.Push("UboObject", m_uniformObject);
 		material->PushDescriptors(m_descriptorSet);
 		bool updateSuccess = m_descriptorSet.Update(pipeline);
 
@@ -75,9 +72,19 @@ namespace acid
 			return false;
 		}
 
-		// Draws the object.
+		// Draws the instanced objects.
 		m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
-		return meshModel->CmdRender(commandBuffer);
+
+		VkBuffer instanceBuffers[] = {Renderer::Get()->GetRingBuffer()->GetBuffer()};
+		VkDeviceSize offsets[] = {instanceOffset};
+		vkCmdBindVertexBuffers(commandBuffer.GetCommandBuffer(), 1, 1, instanceBuffers, offsets);
+
+		if (indirectOffset)
+		{
+			return mesh->GetModel()->CmdRenderIndirect(commandBuffer, *Renderer::Get()->GetRingBuffer(), *indirectOffset);
+		}
+
+		return mesh->GetModel()->CmdRender(commandBuffer, instanceCount);
 	}
 
 	void MeshRender::Decode(const Metadata &metadata)
@@ -87,14 +94,4 @@ namespace acid
 	void MeshRender::Encode(Metadata &metadata) const
 	{
 	}
-
-	bool MeshRender::operator<(const MeshRender &other) const
-	{
-		auto camera = Scenes::Get()->GetCamera();
-
-		float thisDistance2 = (camera->GetPosition() - GetParent()->GetWorldTransform().GetPosition()).LengthSquared();
-		float otherDistance2 = (camera->GetPosition() - other.GetParent()->GetWorldTransform().GetPosition()).LengthSquared();
-
-		return thisDistance2 > otherDistance2;
-	}
 }
@@ -2,6 +2,7 @@
 
 #include "Renderer/Handlers/DescriptorsHandler.hpp"
 #include "Renderer/Handlers/UniformHandler.hpp"
+#include "Renderer/Pipelines/PipelineGraphics.hpp"
 #include "Mesh.hpp"
 
 namespace acid
@@ -18,9 +19,27 @@ namespace acid
 
 		void Encode(Metadata &metadata) const override;
 
-		bool CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const Pipeline::Stage &pipelineStage);
+		/// <summary>
+		/// Draws this mesh with its own object uniforms, the materials pipeline must already be bound.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into. </param>
+		/// <param name="uniformScene"> The scene uniforms. </param>
+		/// <param name="pipeline"> The bound material pipeline. </param>
+		/// <returns> If the mesh was drawn. </returns>
+		bool CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const PipelineGraphics &pipeline);
 
-		bool operator<(const MeshRender &other) const;
+		/// <summary>
+		/// Draws this mesh and the instances that share its model and material in a single draw, the materials pipeline must already be bound.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into. </param>
+		/// <param name="uniformScene"> The scene uniforms. </param>
+		/// <param name="pipeline"> The bound material pipeline. </param>
+		/// <param name="instanceOffset"> The offset of the instance data in the ring buffer. </param>
+		/// <param name="instanceCount"> The amount of instances to draw. </param>
+		/// <param name="indirectOffset"> If set, the offset of a draw command in the ring buffer that the instance count is read from instead. </param>
+		/// <returns> If the instances were drawn. </returns>
+		bool CmdRender(const CommandBuffer &commandBuffer, UniformHandler &uniformScene, const PipelineGraphics &pipeline, const VkDeviceSize &instanceOffset,
+			const uint32_t &instanceCount, const std::optional<VkDeviceSize> &indirectOffset = std::nullopt);
 	private:
 		DescriptorsHandler m_descriptorSet;
 		UniformHandler m_uniformObject;
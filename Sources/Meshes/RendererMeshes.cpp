@@ -1,17 +1,38 @@
 ﻿#include "RendererMeshes.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include "Materials/Material.hpp"
+#include "Physics/Rigidbody.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Scenes/Entity.hpp"
 #include "Scenes/Scenes.hpp"
 #include "MeshRender.hpp"
 
 namespace acid
 {
+	// The culling descriptors are kept for each frame in flight, swapchains have at most this many images.
+	static const uint32_t CULLING_DESCRIPTOR_SETS = 8;
+
 	RendererMeshes::RendererMeshes(const Pipeline::Stage &pipelineStage, const Sort &sort) :
 		RenderPipeline(pipelineStage),
 		m_sort(sort),
-		m_uniformScene(true)
+		m_uniformScene(true),
+		m_instancesOffset(0),
+		m_instancesSize(0),
+		m_cullingPipeline("Shaders/Culling.comp", 1, 1, 64, false, {}, CULLING_DESCRIPTOR_SETS),
+		m_lastDepthStencil(nullptr)
 	{
 	}
 
+	void RendererMeshes::PreRender(const CommandBuffer &commandBuffer)
+	{
+		BuildQueue();
+		BuildBatches();
+		BuildPyramid(commandBuffer);
+		RecordCulling(commandBuffer);
+	}
+
 	void RendererMeshes::Render(const CommandBuffer &commandBuffer)
 	{
 		auto camera = Scenes::Get()->GetCamera();
@@ -19,21 +40,359 @@ namespace acid
 		m_uniformScene.Push("view", camera->GetViewMatrix());
 		m_uniformScene.Push("cameraPos", camera->GetPosition());
 
-		auto sceneMeshRenders = Scenes::Get()->GetStructure()->QueryComponents<MeshRender>();
+		PipelineMaterial *boundPipeline = nullptr;
+		bool pipelineReady = false;
+
+		for (const auto &batch : m_drawBatches)
+		{
+			const auto &entry = m_drawQueue[batch.m_first];
+
+			// The queue is sorted by pipeline first, so each pipeline is usually only bound once.
+			if (entry.m_pipeline != boundPipeline)
+			{
+				boundPipeline = entry.m_pipeline;
+				pipelineReady = boundPipeline->BindPipeline(commandBuffer);
+			}
+
+			if (!pipelineReady)
+			{
+				continue;
+			}
+
+			auto &pipeline = *boundPipeline->GetPipeline();
+
+			if (!entry.m_instanceKey)
+			{
+				entry.m_meshRender->CmdRender(commandBuffer, m_uniformScene, pipeline);
+			}
+			else if (batch.m_indirectOffset)
+			{
+				entry.m_meshRender->CmdRender(commandBuffer, m_uniformScene, pipeline, batch.m_culledOffset, batch.m_count, batch.m_indirectOffset);
+			}
+			else
+			{
+				entry.m_meshRender->CmdRender(commandBuffer, m_uniformScene, pipeline, batch.m_instanceOffset, batch.m_count);
+			}
+		}
+	}
+
+	void RendererMeshes::BuildQueue()
+	{
+		auto camera = Scenes::Get()->GetCamera();
+		auto &frustum = camera->GetViewFrustum();
+
+		m_view.Bind(Scenes::Get()->GetStructure());
+		m_drawQueue.clear();
+		m_pipelineIds.clear();
+		m_materialIds.clear();
+		m_modelIds.clear();
+
+		for (const auto &[meshRender] : m_view)
+		{
+			if (!meshRender->IsEnabled())
+			{
+				continue;
+			}
+
+			auto entity = meshRender->GetParent();
+			auto material = entity->GetComponent<Material>();
+			auto mesh = entity->GetComponent<Mesh>();
+
+			if (material == nullptr || mesh == nullptr || mesh->GetModel() == nullptr || material->GetPipelineMaterial() == nullptr ||
+				material->GetPipelineMaterial()->GetStage() != GetStage())
+			{
+				continue;
+			}
+
+			DrawEntry entry = {};
+			entry.m_meshRender = meshRender;
+			entry.m_material = material;
+			entry.m_model = mesh->GetModel().get();
+			entry.m_pipeline = material->GetPipelineMaterial().get();
+			entry.m_instanceKey = material->GetInstanceKey();
+
+			auto &worldTransform = entity->GetWorldTransform();
+
+			// Instances of indexed models are culled on the GPU against a bounding sphere, everything else is checked here.
+			entry.m_gpuCulled = entry.m_instanceKey && entry.m_model->GetIndexBuffer() != nullptr;
+
+			if (entry.m_gpuCulled)
+			{
+				auto &scaling = worldTransform.GetScaling();
+				auto scale = std::max({std::abs(scaling.m_x), std::abs(scaling.m_y), std::abs(scaling.m_z)});
+				auto &position = worldTransform.GetPosition();
+				entry.m_sphere = {position.m_x, position.m_y, position.m_z, entry.m_model->GetRadius() * scale};
+			}
+			else
+			{
+				auto rigidbody = entity->GetComponent<Rigidbody>();
+
+				if (rigidbody != nullptr && !rigidbody->InFrustum(frustum))
+				{
+					continue;
+				}
+			}
+
+			auto depth = (camera->GetPosition() - worldTransform.GetPosition()).Length() / camera->GetFarPlane();
+			entry.m_key = GetSortKey(entry, depth);
+			m_drawQueue.emplace_back(entry);
+		}
+
+		std::sort(m_drawQueue.begin(), m_drawQueue.end(), [](const DrawEntry &a, const DrawEntry &b)
+		{
+			return a.m_key < b.m_key;
+		});
+	}
+
+	void RendererMeshes::BuildBatches()
+	{
+		m_drawBatches.clear();
+		m_instancesOffset = 0;
+		m_instancesSize = 0;
+
+		for (std::size_t i = 0; i < m_drawQueue.size();)
+		{
+			const auto &entry = m_drawQueue[i];
+
+			// Consecutive entries with the same pipeline, instance key and model are drawn as one instanced draw.
+			auto end = i + 1;
+
+			if (entry.m_instanceKey)
+			{
+				while (end < m_drawQueue.size() && m_drawQueue[end].m_pipeline == entry.m_pipeline && m_drawQueue[end].m_instanceKey == entry.m_instanceKey &&
+					m_drawQueue[end].m_model == entry.m_model)
+				{
+					end++;
+				}
+			}
+
+			DrawBatch batch = {};
+			batch.m_first = i;
+			batch.m_count = static_cast<uint32_t>(end - i);
+
+			if (entry.m_instanceKey)
+			{
+				batch.m_instanceOffset = m_instancesSize;
+				m_instancesSize += entry.m_material->GetInstanceSize() * batch.m_count;
+			}
+
+			m_drawBatches.emplace_back(batch);
+			i = end;
+		}
+
+		if (m_instancesSize == 0)
+		{
+			return;
+		}
+
+		// The instances of every batch are written into one range, so the culling pass can read them through a single binding.
+		auto instances = static_cast<uint8_t *>(Renderer::Get()->GetRingBuffer()->Allocate(m_instancesSize, m_instancesOffset));
+
+		if (instances == nullptr)
+		{
+			m_instancesSize = 0;
+			m_drawBatches.erase(std::remove_if(m_drawBatches.begin(), m_drawBatches.end(), [this](const DrawBatch &batch)
+			{
+				return m_drawQueue[batch.m_first].m_instanceKey.has_value();
+			}), m_drawBatches.end());
+			return;
+		}
+
+		for (auto &batch : m_drawBatches)
+		{
+			if (!m_drawQueue[batch.m_first].m_instanceKey)
+			{
+				continue;
+			}
+
+			auto instanceSize = m_drawQueue[batch.m_first].m_material->GetInstanceSize();
+
+			for (uint32_t j = 0; j < batch.m_count; j++)
+			{
+				m_drawQueue[batch.m_first + j].m_material->PushInstance(instances + batch.m_instanceOffset + (j * instanceSize));
+			}
+
+			batch.m_instanceOffset += m_instancesOffset;
+		}
+	}
+
+	void RendererMeshes::BuildPyramid(const CommandBuffer &commandBuffer)
+	{
+		auto camera = Scenes::Get()->GetCamera();
+		auto depthStencil = Renderer::Get()->GetRenderStage(GetStage().first)->GetDepthStencil();
+
+		// The culling pass always binds a pyramid, a single texel one stands in when there is no depth to reduce.
+		uint32_t width = depthStencil != nullptr ? depthStencil->GetWidth() : 1;
+		uint32_t height = depthStencil != nullptr ? depthStencil->GetHeight() : 1;
+
+		if (m_depthPyramid == nullptr || m_depthPyramid->GetWidth() != width || m_depthPyramid->GetHeight() != height)
+		{
+			m_depthPyramid = std::make_unique<DepthPyramid>(width, height);
+		}
+
+		auto gpuCulled = std::any_of(m_drawBatches.begin(), m_drawBatches.end(), [this](const DrawBatch &batch)
+		{
+			return m_drawQueue[batch.m_first].m_gpuCulled;
+		});
+
+		// The depth only holds the last frame when the same attachment was rendered into last frame, a recreated attachment holds nothing.
+		auto occlusion = gpuCulled && depthStencil != nullptr && depthStencil == m_lastDepthStencil && m_depthPyramid->CmdBuild(commandBuffer, *depthStencil);
+
+		m_lastDepthStencil = depthStencil;
+		m_uniformCulling.Push("lastProjection", m_lastProjection);
+		m_uniformCulling.Push("lastView", m_lastView);
+		m_uniformCulling.Push("occlusion", static_cast<uint32_t>(occlusion));
+		m_lastProjection = camera->GetProjectionMatrix();
+		m_lastView = camera->GetViewMatrix();
+	}
+
+	void RendererMeshes::RecordCulling(const CommandBuffer &commandBuffer)
+	{
+		auto ringBuffer = Renderer::Get()->GetRingBuffer();
+
+		std::vector<DrawBatch *> culledBatches;
+		uint32_t objectCount = 0;
+		VkDeviceSize instancesSize = 0;
+
+		for (auto &batch : m_drawBatches)
+		{
+			if (m_drawQueue[batch.m_first].m_gpuCulled)
+			{
+				culledBatches.emplace_back(&batch);
+				objectCount += batch.m_count;
+				instancesSize += m_drawQueue[batch.m_first].m_material->GetInstanceSize() * batch.m_count;
+			}
+		}
+
+		if (culledBatches.empty())
+		{
+			return;
+		}
+
+		// Fills the objects to test and the draws they are compacted into, draws start with no instances.
+		VkDeviceSize objectsOffset = 0;
+		VkDeviceSize drawsOffset = 0;
+		VkDeviceSize culledOffset = 0;
+		auto objects = static_cast<CullObject *>(ringBuffer->Allocate(sizeof(CullObject) * objectCount, objectsOffset));
+		auto draws = static_cast<CullDraw *>(ringBuffer->Allocate(sizeof(CullDraw) * culledBatches.size(), drawsOffset));
+		auto culled = ringBuffer->Allocate(instancesSize, culledOffset);
 
-		if (m_sort != Sort::None)
+		if (objects == nullptr || draws == nullptr || culled == nullptr)
 		{
-			std::sort(sceneMeshRenders.begin(), sceneMeshRenders.end());
+			return;
+		}
+
+		uint32_t objectIndex = 0;
+		uint32_t target = 0;
 
-			if (m_sort == Sort::Front)
+		for (uint32_t i = 0; i < culledBatches.size(); i++)
+		{
+			auto &batch = *culledBatches[i];
+			const auto &first = m_drawQueue[batch.m_first];
+			auto stride = static_cast<uint32_t>(first.m_material->GetInstanceSize() / sizeof(uint32_t));
+			auto source = static_cast<uint32_t>((batch.m_instanceOffset - m_instancesOffset) / sizeof(uint32_t));
+
+			auto &draw = draws[i];
+			draw.m_command.indexCount = first.m_model->GetIndexCount();
+			draw.m_command.instanceCount = 0;
+			draw.m_command.firstIndex = 0;
+			draw.m_command.vertexOffset = 0;
+			draw.m_command.firstInstance = 0;
+			draw.m_target = target;
+			batch.m_culledOffset = culledOffset + (target * sizeof(uint32_t));
+
+			for (uint32_t j = 0; j < batch.m_count; j++)
 			{
-				std::reverse(sceneMeshRenders.begin(), sceneMeshRenders.end());
+				auto &object = objects[objectIndex++];
+				object.m_sphere = m_drawQueue[batch.m_first + j].m_sphere;
+				object.m_draw = i;
+				object.m_source = source + (j * stride);
+				object.m_stride = stride;
+				object.m_padding = 0;
 			}
+
+			target += batch.m_count * stride;
+		}
+
+		// The descriptors are rewritten every frame, so each frame in flight has its own set.
+		auto currentFrame = Renderer::Get()->GetCurrentFrame();
+
+		while (m_cullingDescriptors.size() <= currentFrame)
+		{
+			m_cullingDescriptors.emplace_back(m_cullingPipeline);
+		}
+
+		auto &descriptorSet = m_cullingDescriptors[currentFrame];
+
+		auto &frustum = Scenes::Get()->GetCamera()->GetViewFrustum();
+		m_uniformCulling.Push("frustumPlanes", frustum.GetPlanes(), sizeof(frustum.GetPlanes()));
+		m_uniformCulling.Push("objectCount", objectCount);
+
+		descriptorSet.Push("UboCulling", m_uniformCulling);
+		descriptorSet.Push("Objects", ringBuffer, OffsetSize(static_cast<uint32_t>(objectsOffset), static_cast<uint32_t>(sizeof(CullObject) * objectCount)));
+		descriptorSet.Push("InstancesIn", ringBuffer, OffsetSize(static_cast<uint32_t>(m_instancesOffset), static_cast<uint32_t>(m_instancesSize)));
+		descriptorSet.Push("InstancesOut", ringBuffer, OffsetSize(static_cast<uint32_t>(culledOffset), static_cast<uint32_t>(instancesSize)));
+		descriptorSet.Push("Draws", ringBuffer, OffsetSize(static_cast<uint32_t>(drawsOffset), static_cast<uint32_t>(sizeof(CullDraw) * culledBatches.size())));
+		descriptorSet.Push("samplerPyramid", *m_depthPyramid);
+		bool updateSuccess = descriptorSet.Update(m_cullingPipeline);
+
+		if (!updateSuccess)
+		{
+			return;
 		}
 
-		for (const auto &meshRender : sceneMeshRenders)
+		m_cullingPipeline.BindPipeline(commandBuffer);
+		descriptorSet.BindDescriptor(commandBuffer, m_cullingPipeline);
+		m_cullingPipeline.CmdRender(commandBuffer, objectCount, 1);
+
+		// The draws read the commands and instances written by the culling pass.
+		VkMemoryBarrier memoryBarrier = {};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+		for (uint32_t i = 0; i < culledBatches.size(); i++)
+		{
+			culledBatches[i]->m_indirectOffset = drawsOffset + (i * sizeof(CullDraw));
+		}
+	}
+
+	uint64_t RendererMeshes::GetSortKey(const DrawEntry &entry, const float &depth)
+	{
+		// Ids are handed out in the order they are first seen this frame, and are clamped to 16 bits.
+		auto getId = [](auto &ids, const auto &key) -> uint64_t
+		{
+			auto it = ids.find(key);
+
+			if (it == ids.end())
+			{
+				it = ids.emplace(key, static_cast<uint16_t>(std::min<std::size_t>(ids.size(), 0xFFFF))).first;
+			}
+
+			return it->second;
+		};
+
+		// Materials that can not be instanced are grouped by their own address.
+		auto materialKey = entry.m_instanceKey ? *entry.m_instanceKey : std::hash<const void *>()(entry.m_material);
+
+		auto pipelineId = getId(m_pipelineIds, static_cast<const void *>(entry.m_pipeline));
+		auto materialId = getId(m_materialIds, materialKey);
+		auto modelId = getId(m_modelIds, static_cast<const void *>(entry.m_model));
+		auto depthId = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * 0xFFFF);
+
+		switch (m_sort)
 		{
-			meshRender->CmdRender(commandBuffer, m_uniformScene, GetStage());
+		case Sort::Front:
+			// Front to back, depth takes priority over state changes.
+			return (depthId << 48) | (pipelineId << 32) | (materialId << 16) | modelId;
+		case Sort::Back:
+			// Back to front, for blended meshes.
+			return ((0xFFFF - depthId) << 48) | (pipelineId << 32) | (materialId << 16) | modelId;
+		default:
+			// Grouped by state so pipelines, descriptors and models are rebound as little as possible, front to back within a group.
+			return (pipelineId << 48) | (materialId << 32) | (modelId << 16) | depthId;
 		}
 	}
 }
@@ -1,11 +1,29 @@
 ﻿#pragma once
 
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include "Maths/Matrix4.hpp"
 #include "Renderer/RenderPipeline.hpp"
+#include "Renderer/Handlers/DescriptorsHandler.hpp"
 #include "Renderer/Handlers/UniformHandler.hpp"
+#include "Renderer/Pipelines/PipelineCompute.hpp"
 #include "Renderer/Pipelines/PipelineGraphics.hpp"
+#include "Scenes/View.hpp"
+#include "Textures/DepthPyramid.hpp"
 
 namespace acid
 {
+	class Material;
+	class MeshRender;
+	class Model;
+	class PipelineMaterial;
+
+	/// <summary>
+	/// Draws the meshes of a pipeline stage, sorted to reduce state changes and merged into instanced draws where the material allows it.
+	/// Instanced draws of indexed models are frustum culled on the GPU, a compute pass compacts the visible instances and writes indirect draw commands.
+	/// The same pass tests them against a depth pyramid of the last frame, built from the depth attachment of the render stage before it is cleared.
+	/// </summary>
 	class ACID_EXPORT RendererMeshes :
 		public RenderPipeline
 	{
@@ -17,9 +35,87 @@ namespace acid
 
 		explicit RendererMeshes(const Pipeline::Stage &pipelineStage, const Sort &sort = Sort::None);
 
+		void PreRender(const CommandBuffer &commandBuffer) override;
+
 		void Render(const CommandBuffer &commandBuffer) override;
 	private:
+		/// <summary>
+		/// A queued draw, sorted by a key built from its pipeline, material, model and depth.
+		/// </summary>
+		struct DrawEntry
+		{
+			uint64_t m_key;
+			MeshRender *m_meshRender;
+			Material *m_material;
+			Model *m_model;
+			PipelineMaterial *m_pipeline;
+			std::optional<std::size_t> m_instanceKey;
+			bool m_gpuCulled;
+			std::array<float, 4> m_sphere;
+		};
+
+		/// <summary>
+		/// A run of queued draws recorded as one draw, instanced when the entries share a instance key.
+		/// </summary>
+		struct DrawBatch
+		{
+			std::size_t m_first;
+			uint32_t m_count;
+			VkDeviceSize m_instanceOffset;
+			std::optional<VkDeviceSize> m_indirectOffset;
+			VkDeviceSize m_culledOffset;
+		};
+
+		/// <summary>
+		/// The culling input of a object, matches the Object struct in Culling.comp.
+		/// </summary>
+		struct CullObject
+		{
+			std::array<float, 4> m_sphere;
+			uint32_t m_draw;
+			uint32_t m_source;
+			uint32_t m_stride;
+			uint32_t m_padding;
+		};
+
+		/// <summary>
+		/// A indirect draw command followed by the offset of its instances, matches the Draw struct in Culling.comp.
+		/// </summary>
+		struct CullDraw
+		{
+			VkDrawIndexedIndirectCommand m_command;
+			uint32_t m_target;
+			uint32_t m_padding[2];
+		};
+
+		void BuildQueue();
+
+		void BuildBatches();
+
+		void BuildPyramid(const CommandBuffer &commandBuffer);
+
+		void RecordCulling(const CommandBuffer &commandBuffer);
+
+		uint64_t GetSortKey(const DrawEntry &entry, const float &depth);
+
 		Sort m_sort;
 		UniformHandler m_uniformScene;
+		View<MeshRender> m_view;
+		std::vector<DrawEntry> m_drawQueue;
+		std::vector<DrawBatch> m_drawBatches;
+		VkDeviceSize m_instancesOffset;
+		VkDeviceSize m_instancesSize;
+		std::unordered_map<const void *, uint16_t> m_pipelineIds;
+		std::unordered_map<std::size_t, uint16_t> m_materialIds;
+		std::unordered_map<const void *, uint16_t> m_modelIds;
+
+		PipelineCompute m_cullingPipeline;
+		UniformHandler m_uniformCulling;
+		std::vector<DescriptorsHandler> m_cullingDescriptors;
+
+		std::unique_ptr<DepthPyramid> m_depthPyramid;
+		const DepthStencil *m_lastDepthStencil;
+		Matrix4 m_lastProjection;
+		Matrix4 m_lastView;
 	};
 }
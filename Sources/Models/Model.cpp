@@ -1,6 +1,7 @@
 #include "Model.hpp"
 
 #include <cassert>
+#include "Renderer/Renderer.hpp"
 #include "Scenes/Scenes.hpp"
 #include "Resources/Resources.hpp"
 
@@ -51,6 +52,22 @@ namespace acid
 		return true;
 	}
 
+	bool Model::CmdRenderIndirect(const CommandBuffer &commandBuffer, const Buffer &indirectBuffer, const VkDeviceSize &offset) const
+	{
+		if (m_vertexBuffer == nullptr || m_indexBuffer == nullptr)
+		{
+			assert(false && "Cannot render model indirectly, it has no index buffer!");
+			return false;
+		}
+
+		VkBuffer vertexBuffers[] = {m_vertexBuffer->GetBuffer()};
+		VkDeviceSize offsets[] = {0};
+		vkCmdBindVertexBuffers(commandBuffer.GetCommandBuffer(), 0, 1, vertexBuffers, offsets);
+		vkCmdBindIndexBuffer(commandBuffer.GetCommandBuffer(), m_indexBuffer->GetBuffer(), 0, GetIndexType());
+		vkCmdDrawIndexedIndirect(commandBuffer.GetCommandBuffer(), indirectBuffer.GetBuffer(), offset, 1, sizeof(VkDrawIndexedIndirectCommand));
+		return true;
+	}
+
 	void Model::Load()
 	{
 	}
@@ -63,6 +80,28 @@ namespace acid
 	{
 	}
 
+	std::size_t Model::GetCpuSize() const
+	{
+		return sizeof(Model);
+	}
+
+	std::size_t Model::GetGpuSize() const
+	{
+		std::size_t size = 0;
+
+		if (m_vertexBuffer != nullptr)
+		{
+			size += m_vertexBuffer->GetSize();
+		}
+
+		if (m_indexBuffer != nullptr)
+		{
+			size += m_indexBuffer->GetSize();
+		}
+
+		return size;
+	}
+
 	std::vector<float> Model::GetPointCloud() const
 	{
 		if (m_vertexBuffer == nullptr)
@@ -75,4 +114,11 @@ namespace acid
 		m_vertexBuffer->Unmap();
 		return result;
 	}
+
+	std::unique_ptr<Buffer> Model::CreateBuffer(const void *data, const VkDeviceSize &size, const VkBufferUsageFlags &usage)
+	{
+		auto buffer = std::make_unique<Buffer>(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		Renderer::Get()->GetUploadManager()->UploadBuffer(buffer->GetBuffer(), data, size);
+		return buffer;
+	}
 }
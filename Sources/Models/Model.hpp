@@ -42,12 +42,25 @@ namespace acid
 
 		bool CmdRender(const CommandBuffer &commandBuffer, const uint32_t &instances = 1) const;
 
+		/// <summary>
+		/// Draws the model with the parameters of a VkDrawIndexedIndirectCommand written by the GPU, the model must have indices.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into. </param>
+		/// <param name="indirectBuffer"> The buffer containing the draw command. </param>
+		/// <param name="offset"> The offset of the draw command in the buffer. </param>
+		/// <returns> If the draw was recorded. </returns>
+		bool CmdRenderIndirect(const CommandBuffer &commandBuffer, const Buffer &indirectBuffer, const VkDeviceSize &offset) const;
+
 		void Load() override;
 
 		void Decode(const Metadata &metadata) override;
 
 		void Encode(Metadata &metadata) const override;
 
+		std::size_t GetCpuSize() const override;
+
+		std::size_t GetGpuSize() const override;
+
 		std::vector<float> GetPointCloud() const;
 
 		const Vector3 &GetMinExtents() const { return m_minExtents; }
@@ -82,34 +95,14 @@ namespace acid
 
 			if (!vertices.empty())
 			{
-				auto vertexStaging = Buffer(sizeof(T) * vertices.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, vertices.data());
-				m_vertexBuffer = std::make_unique<Buffer>(sizeof(T) * vertices.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+				m_vertexBuffer = CreateBuffer(vertices.data(), sizeof(T) * vertices.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
 				m_vertexCount = vertices.size();
-
-				CommandBuffer commandBuffer = CommandBuffer();
-
-				VkBufferCopy copyRegion = {};
-				copyRegion.size = sizeof(T) * vertices.size();
-				vkCmdCopyBuffer(commandBuffer.GetCommandBuffer(), vertexStaging.GetBuffer(), m_vertexBuffer->GetBuffer(), 1, &copyRegion);
-
-				commandBuffer.End();
-				commandBuffer.SubmitIdle();
 			}
 
 			if (!indices.empty())
 			{
-				auto indexStaging = Buffer(sizeof(uint32_t) * indices.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, indices.data());
-				m_indexBuffer = std::make_unique<Buffer>(sizeof(uint32_t) * indices.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+				m_indexBuffer = CreateBuffer(indices.data(), sizeof(uint32_t) * indices.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
 				m_indexCount = indices.size();
-
-				CommandBuffer commandBuffer = CommandBuffer();
-
-				VkBufferCopy copyRegion = {};
-				copyRegion.size = sizeof(uint32_t) * indices.size();
-				vkCmdCopyBuffer(commandBuffer.GetCommandBuffer(), indexStaging.GetBuffer(), m_indexBuffer->GetBuffer(), 1, &copyRegion);
-
-				commandBuffer.End();
-				commandBuffer.SubmitIdle();
 			}
 
 			m_minExtents = Vector3::PositiveInfinity;
@@ -130,6 +123,11 @@ namespace acid
 			m_radius = std::max(min0, std::max(min1, std::max(max0, max1)));
 		}
 	private:
+		/// <summary>
+		/// Creates a device local buffer, its data is copied in by the next upload batch.
+		/// </summary>
+		static std::unique_ptr<Buffer> CreateBuffer(const void *data, const VkDeviceSize &size, const VkBufferUsageFlags &usage);
+
 		std::unique_ptr<Buffer> m_vertexBuffer;
 		std::unique_ptr<Buffer> m_indexBuffer;
 		uint32_t m_vertexCount;
@@ -15,11 +15,11 @@ namespace acid
 
 	std::shared_ptr<ModelObj> ModelObj::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<ModelObj>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<ModelObj>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<ModelObj>("");
@@ -38,7 +38,8 @@ namespace acid
 	}
 
 	ModelObj::ModelObj(std::string filename, const bool &load) :
-		m_filename(std::move(filename))
+		m_filename(std::move(filename)),
+		m_prepared(false)
 	{
 		if (load)
 		{
@@ -46,9 +47,9 @@ namespace acid
 		}
 	}
 
-	void ModelObj::Load()
+	void ModelObj::Prepare()
 	{
-		if (m_filename.empty())
+		if (m_filename.empty() || m_prepared)
 		{
 			return;
 		}
@@ -147,7 +148,8 @@ namespace acid
 			}
 		}
 
-		std::vector<VertexModel> vertices = {};
+		m_vertices.clear();
+		m_indices = std::move(indices);
 
 		// Averages out vertex tangents, and disabled non set vertices,
 		// and converts the loaded data into a format that can be used by models.
@@ -158,7 +160,7 @@ namespace acid
 			auto uvs = current->GetUvIndex() ? uvsList[*current->GetUvIndex()] : Vector2::Zero;
 			auto normal = current->GetNormalIndex() ? normalsList[*current->GetNormalIndex()] : Vector3::Zero;
 			auto tangent = current->GetAverageTangent();
-			vertices.emplace_back(VertexModel(position, uvs, normal, tangent));
+			m_vertices.emplace_back(VertexModel(position, uvs, normal, tangent));
 		}
 
 #if defined(ACID_VERBOSE)
@@ -166,7 +168,23 @@ namespace acid
 		Log::Out("Model OBJ '%s' loaded in %ims\n", m_filename.c_str(), (debugEnd - debugStart).AsMilliseconds());
 #endif
 
-		Initialize(vertices, indices);
+		m_prepared = true;
+	}
+
+	void ModelObj::Load()
+	{
+		if (m_filename.empty())
+		{
+			return;
+		}
+
+		Prepare();
+		Initialize(m_vertices, m_indices);
+
+		// The data has been uploaded, it is not kept on the host.
+		m_vertices = {};
+		m_indices = {};
+		m_prepared = false;
 	}
 
 	void ModelObj::Decode(const Metadata &metadata)
@@ -180,6 +198,12 @@ namespace acid
 		metadata.SetChild("Filename", m_filename);
 	}
 
+	std::size_t ModelObj::GetCpuSize() const
+	{
+		// Vertices are only held between being prepared and loaded.
+		return sizeof(ModelObj) + m_filename.capacity() + m_vertices.capacity() * sizeof(VertexModel) + m_indices.capacity() * sizeof(uint32_t);
+	}
+
 	VertexModelData *ModelObj::ProcessDataVertex(const std::optional<uint32_t> &vertexIndex, const std::optional<uint32_t> &uvIndex, const std::optional<uint32_t> &normalIndex,
 		std::vector<std::unique_ptr<VertexModelData>> &vertices, std::vector<uint32_t> &indices)
 	{
@@ -32,13 +32,17 @@ namespace acid
 		/// </summary>
 		/// <param name="filename"> The file to load the model from. </param>
 		/// <param name="load"> If this resource will load immediately, otherwise <seealso cref="#Load()"/> can be called. </param>
-		explicit ModelObj(std::string filename, const bool &load = true);
+		explicit ModelObj(std::string filename = "", const bool &load = true);
+
+		void Prepare() override;
 
 		void Load() override;
 
 		void Decode(const Metadata &metadata) override;
 
 		void Encode(Metadata &metadata) const override;
+
+		std::size_t GetCpuSize() const override;
 	private:
 		template<typename T>
 		std::optional<T> ParseReal(const char **token, const char *startControl = " \t", const char *endControl = " \t\r")
@@ -68,5 +72,9 @@ namespace acid
 		static void CalculateTangents(VertexModelData *v0, VertexModelData *v1, VertexModelData *v2, std::vector<Vector2> &uvs);
 
 		std::string m_filename;
+
+		std::vector<VertexModel> m_vertices;
+		std::vector<uint32_t> m_indices;
+		bool m_prepared;
 	};
 }
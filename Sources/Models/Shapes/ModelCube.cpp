@@ -7,11 +7,11 @@ namespace acid
 {
 	std::shared_ptr<ModelCube> ModelCube::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<ModelCube>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<ModelCube>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<ModelCube>(0.0f, 0.0f, 0.0f);
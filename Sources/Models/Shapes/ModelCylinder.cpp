@@ -8,11 +8,11 @@ namespace acid
 {
 	std::shared_ptr<ModelCylinder> ModelCylinder::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<ModelCylinder>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<ModelCylinder>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<ModelCylinder>(0.0f, 0.0f);
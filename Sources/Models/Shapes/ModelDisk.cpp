@@ -8,11 +8,11 @@ namespace acid
 {
 	std::shared_ptr<ModelDisk> ModelDisk::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<ModelDisk>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<ModelDisk>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<ModelDisk>(0.0f, 0.0f);
@@ -7,11 +7,11 @@ namespace acid
 {
 	std::shared_ptr<ModelRectangle> ModelRectangle::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<ModelRectangle>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<ModelRectangle>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<ModelRectangle>(0.0f, 0.0f);
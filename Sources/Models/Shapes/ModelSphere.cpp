@@ -8,11 +8,11 @@ namespace acid
 {
 	std::shared_ptr<ModelSphere> ModelSphere::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<ModelSphere>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<ModelSphere>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<ModelSphere>(0.0f);
@@ -0,0 +1,185 @@
+#include "ParticleCompute.hpp"
+
+#include <algorithm>
+#include <utility>
+#include "Renderer/Renderer.hpp"
+#include "Scenes/Scenes.hpp"
+#include "ParticlePool.hpp"
+
+namespace acid
+{
+	// The simulation descriptors are kept for each frame in flight, swapchains have at most this many images.
+	static const uint32_t SIMULATE_DESCRIPTOR_SETS = 8;
+
+	ParticleCompute::ParticleCompute(const uint32_t &capacity, std::shared_ptr<Model> model, const bool &sorted) :
+		m_capacity(capacity),
+		m_model(std::move(model)),
+		m_target(0),
+		m_cleared(true),
+		m_simulated(false),
+		m_sort(sorted ? std::make_unique<ParticleSort>(capacity) : nullptr),
+		m_pipeline("Shaders/Particles/Particle.comp", capacity, 1, 256, false, {}, SIMULATE_DESCRIPTOR_SETS)
+	{
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			m_states[i] = std::make_unique<StorageBuffer>(sizeof(ParticleState) * m_capacity, nullptr, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			m_draws[i] = std::make_unique<StorageBuffer>(sizeof(VkDrawIndexedIndirectCommand), nullptr, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, 
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		}
+	}
+
+	void ParticleCompute::CmdSimulate(const CommandBuffer &commandBuffer, const ParticlePool &emitted, const float &delta)
+	{
+		auto source = m_target;
+		auto target = 1 - m_target;
+
+		// New particles are packed into the ring buffer, empty emissions still take a element so the binding stays valid.
+		auto emitCount = std::min(emitted.GetSize(), m_capacity);
+		VkDeviceSize emittedOffset = 0;
+		auto emittedSize = sizeof(ParticleState) * std::max(emitCount, 1u);
+		auto states = static_cast<ParticleState *>(Renderer::Get()->GetRingBuffer()->Allocate(emittedSize, emittedOffset));
+
+		if (states == nullptr)
+		{
+			return;
+		}
+
+		for (uint32_t i = 0; i < emitCount; i++)
+		{
+			auto &state = states[i];
+			state.m_position[0] = emitted.GetField(ParticlePool::Field::PositionX)[i];
+			state.m_position[1] = emitted.GetField(ParticlePool::Field::PositionY)[i];
+			state.m_position[2] = emitted.GetField(ParticlePool::Field::PositionZ)[i];
+			state.m_rotation = emitted.GetField(ParticlePool::Field::Rotation)[i];
+			state.m_velocity[0] = emitted.GetField(ParticlePool::Field::VelocityX)[i];
+			state.m_velocity[1] = emitted.GetField(ParticlePool::Field::VelocityY)[i];
+			state.m_velocity[2] = emitted.GetField(ParticlePool::Field::VelocityZ)[i];
+			state.m_gravityEffect = emitted.GetField(ParticlePool::Field::GravityEffect)[i];
+			state.m_lifeLength = emitted.GetField(ParticlePool::Field::LifeLength)[i];
+			state.m_stageCycles = emitted.GetField(ParticlePool::Field::StageCycles)[i];
+			state.m_elapsedTime = 0.0f;
+			state.m_transparency = 1.0f;
+			state.m_scale = emitted.GetField(ParticlePool::Field::Scale)[i];
+		}
+
+		// The descriptors change every step, so each frame in flight has its own set.
+		auto currentFrame = Renderer::Get()->GetCurrentFrame();
+
+		while (m_simulateDescriptors.size() <= currentFrame)
+		{
+			m_simulateDescriptors.emplace_back(m_pipeline);
+		}
+
+		auto &descriptorSet = m_simulateDescriptors[currentFrame];
+
+		m_uniformSimulate.Push("delta", delta);
+		m_uniformSimulate.Push("capacity", m_capacity);
+		m_uniformSimulate.Push("emitCount", emitCount);
+
+		descriptorSet.Push("UboSimulate", m_uniformSimulate);
+		descriptorSet.Push("ParticlesIn", *m_states[source]);
+		descriptorSet.Push("ParticlesOut", *m_states[target]);
+		descriptorSet.Push("Emitted", Renderer::Get()->GetRingBuffer(), OffsetSize(static_cast<uint32_t>(emittedOffset), static_cast<uint32_t>(emittedSize)));
+		descriptorSet.Push("DrawIn", *m_draws[source]);
+		descriptorSet.Push("DrawOut", *m_draws[target]);
+		bool updateSuccess = descriptorSet.Update(m_pipeline);
+
+		if (!updateSuccess)
+		{
+			return;
+		}
+
+		// The target was last read by the draw two frames ago and by the last step, it is not reset until they have finished.
+		vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | 
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+		// The target draw starts with no instances, the source is also reset after a clear or before the first step.
+		VkDrawIndexedIndirectCommand command = {};
+		command.indexCount = m_model->GetIndexCount();
+		vkCmdUpdateBuffer(commandBuffer.GetCommandBuffer(), m_draws[target]->GetBuffer(), 0, sizeof(VkDrawIndexedIndirectCommand), &command);
+
+		if (m_cleared)
+		{
+			vkCmdUpdateBuffer(commandBuffer.GetCommandBuffer(), m_draws[source]->GetBuffer(), 0, sizeof(VkDrawIndexedIndirectCommand), &command);
+			m_cleared = false;
+		}
+
+		VkMemoryBarrier memoryBarrier = {};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+		m_pipeline.BindPipeline(commandBuffer);
+		descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+		m_pipeline.CmdRender(commandBuffer, m_capacity, 1);
+
+		// A step that could not be sorted is not drawn, the indices would be from a older step.
+		bool sorted = true;
+
+		if (m_sort != nullptr)
+		{
+			auto camera = Scenes::Get()->GetCamera();
+			sorted = m_sort->CmdSort(commandBuffer, target, *m_states[target], *m_draws[target], camera->GetPosition(), camera->GetFarPlane());
+		}
+
+		// The draw reads the instance count, particles and sorted indices written by the step.
+		memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+			0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+		m_target = target;
+		m_simulated = sorted;
+	}
+
+	std::size_t ParticleCompute::GetGpuSize() const
+	{
+		std::size_t size = m_sort != nullptr ? m_sort->GetGpuSize() : 0;
+
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			size += m_states[i]->GetSize() + m_draws[i]->GetSize();
+		}
+
+		return size;
+	}
+
+	bool ParticleCompute::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene, const std::shared_ptr<Texture> &texture,
+		const Colour &colourOffset, const uint32_t &numberOfRows)
+	{
+		if (!m_simulated)
+		{
+			return false;
+		}
+
+		m_uniformParticles.Push("colourOffset", colourOffset);
+		m_uniformParticles.Push("numberOfRows", static_cast<float>(numberOfRows));
+		m_uniformParticles.Push("capacity", m_capacity);
+
+		// Each state buffer has its own set, the buffer drawn from alternates every step.
+		auto &descriptorSet = m_renderDescriptors[m_target];
+		descriptorSet.Push("UboScene", uniformScene);
+		descriptorSet.Push("UboParticles", m_uniformParticles);
+		descriptorSet.Push("Particles", *m_states[m_target]);
+
+		if (m_sort != nullptr)
+		{
+			descriptorSet.Push("Indices", m_sort->GetIndices());
+		}
+
+		descriptorSet.Push("samplerColour", texture);
+		bool updateSuccess = descriptorSet.Update(pipeline);
+
+		if (!updateSuccess)
+		{
+			return false;
+		}
+
+		descriptorSet.BindDescriptor(commandBuffer, pipeline);
+
+		// The instance count is the amount of particles the simulation kept alive.
+		return m_model->CmdRenderIndirect(commandBuffer, *m_draws[m_target], 0);
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "Maths/Colour.hpp"
+#include "Models/Model.hpp"
+#include "Renderer/Buffers/StorageBuffer.hpp"
+#include "Renderer/Handlers/DescriptorsHandler.hpp"
+#include "Renderer/Handlers/UniformHandler.hpp"
+#include "Renderer/Pipelines/PipelineCompute.hpp"
+#include "Renderer/Pipelines/PipelineGraphics.hpp"
+#include "Textures/Texture.hpp"
+#include "ParticleSort.hpp"
+
+namespace acid
+{
+	class ParticlePool;
+
+	/// <summary>
+	/// Simulates the particles of a type on the GPU. Particle state lives in two device local storage buffers that a compute pass ping-pongs between,
+	/// integrating and compacting the live particles and appending new ones. The pass also writes the instance count of a indirect draw,
+	/// so particles are drawn straight from the simulated buffer without being read back. Sorted simulations order the live particles back to front after each step.
+	/// </summary>
+	class ACID_EXPORT ParticleCompute
+	{
+	public:
+		/// <summary>
+		/// Creates a new GPU particle simulation.
+		/// </summary>
+		/// <param name="capacity"> The most particles that can be alive at once, emissions past it are dropped. </param>
+		/// <param name="model"> The indexed model drawn for each particle. </param>
+		/// <param name="sorted"> If the particles are sorted back to front, the draw must then use a pipeline built with the SORTED define. </param>
+		ParticleCompute(const uint32_t &capacity, std::shared_ptr<Model> model, const bool &sorted);
+
+		/// <summary>
+		/// Records a simulation step, must be recorded outside of a renderpass.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into. </param>
+		/// <param name="emitted"> The particles emitted since the last step, uploaded and appended to the live particles. </param>
+		/// <param name="delta"> The time since the last step in seconds. </param>
+		void CmdSimulate(const CommandBuffer &commandBuffer, const ParticlePool &emitted, const float &delta);
+
+		/// <summary>
+		/// Records a indirect draw of the particles written by the last simulation step.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into. </param>
+		/// <param name="pipeline"> The particle pipeline built with the COMPUTED define. </param>
+		/// <param name="uniformScene"> The scene uniforms. </param>
+		/// <param name="texture"> The texture atlas of the particles. </param>
+		/// <param name="colourOffset"> The colour the particles are multiplied by. </param>
+		/// <param name="numberOfRows"> The number of rows in the texture atlas. </param>
+		/// <returns> If the particles were drawn. </returns>
+		bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene, const std::shared_ptr<Texture> &texture,
+			const Colour &colourOffset, const uint32_t &numberOfRows);
+
+		/// <summary>
+		/// Removes every live particle in the next simulation step.
+		/// </summary>
+		void Clear() { m_cleared = true; }
+
+		/// <summary>
+		/// Gets the amount of device memory used by the particle and sort buffers.
+		/// </summary>
+		/// <returns> The size in bytes. </returns>
+		std::size_t GetGpuSize() const;
+
+		const uint32_t &GetCapacity() const { return m_capacity; }
+
+		bool IsSorted() const { return m_sort != nullptr; }
+	private:
+		/// <summary>
+		/// The state of a particle, matches the Particle struct in Particle.comp and Particle.vert.
+		/// </summary>
+		struct ParticleState
+		{
+			float m_position[3];
+			float m_rotation;
+			float m_velocity[3];
+			float m_gravityEffect;
+			float m_lifeLength;
+			float m_stageCycles;
+			float m_elapsedTime;
+			float m_transparency;
+			float m_scale;
+			float m_padding[3];
+		};
+
+		uint32_t m_capacity;
+		std::shared_ptr<Model> m_model;
+		std::array<std::unique_ptr<StorageBuffer>, 2> m_states;
+		std::array<std::unique_ptr<StorageBuffer>, 2> m_draws;
+		uint32_t m_target;
+		bool m_cleared;
+		bool m_simulated;
+
+		std::unique_ptr<ParticleSort> m_sort;
+
+		PipelineCompute m_pipeline;
+		UniformHandler m_uniformSimulate;
+		std::vector<DescriptorsHandler> m_simulateDescriptors;
+
+		UniformHandler m_uniformParticles;
+		std::array<DescriptorsHandler, 2> m_renderDescriptors;
+	};
+}
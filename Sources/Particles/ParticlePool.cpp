@@ -0,0 +1,146 @@
+#include "ParticlePool.hpp"
+
+#include "Engine/Engine.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ACID_PARTICLES_SSE
+#endif
+
+namespace acid
+{
+	const uint32_t ParticlePool::UpdateGrainSize = 16384;
+	const float ParticlePool::FadeTime = 1.0f;
+
+	static const float GRAVITY = -10.0f;
+
+	void ParticlePool::Add(const Particle &particle)
+	{
+		GetField(Field::PositionX).emplace_back(particle.GetPosition().m_x);
+		GetField(Field::PositionY).emplace_back(particle.GetPosition().m_y);
+		GetField(Field::PositionZ).emplace_back(particle.GetPosition().m_z);
+		GetField(Field::VelocityX).emplace_back(particle.GetVelocity().m_x);
+		GetField(Field::VelocityY).emplace_back(particle.GetVelocity().m_y);
+		GetField(Field::VelocityZ).emplace_back(particle.GetVelocity().m_z);
+		GetField(Field::LifeLength).emplace_back(particle.GetLifeLength());
+		GetField(Field::StageCycles).emplace_back(particle.GetStageCycles());
+		GetField(Field::Rotation).emplace_back(particle.GetRotation());
+		GetField(Field::Scale).emplace_back(particle.GetScale());
+		GetField(Field::GravityEffect).emplace_back(particle.GetGravityEffect());
+		GetField(Field::ElapsedTime).emplace_back(0.0f);
+		GetField(Field::Transparency).emplace_back(1.0f);
+	}
+
+	void ParticlePool::Update(const float &delta)
+	{
+		auto size = GetSize();
+
+		if (size <= UpdateGrainSize)
+		{
+			Update(delta, 0, size);
+			return;
+		}
+
+		Engine::Get()->GetThreadPool().ParallelFor(0, size, [this, delta](uint32_t from, uint32_t to)
+		{
+			Update(delta, from, to);
+		}, UpdateGrainSize);
+	}
+
+	void ParticlePool::Update(const float &delta, const uint32_t &from, const uint32_t &to)
+	{
+		auto positionX = GetField(Field::PositionX).data();
+		auto positionY = GetField(Field::PositionY).data();
+		auto positionZ = GetField(Field::PositionZ).data();
+		auto velocityX = GetField(Field::VelocityX).data();
+		auto velocityY = GetField(Field::VelocityY).data();
+		auto velocityZ = GetField(Field::VelocityZ).data();
+		auto lifeLength = GetField(Field::LifeLength).data();
+		auto gravityEffect = GetField(Field::GravityEffect).data();
+		auto elapsedTime = GetField(Field::ElapsedTime).data();
+		auto transparency = GetField(Field::Transparency).data();
+
+		auto gravityStep = GRAVITY * delta;
+		auto fadeStep = delta / FadeTime;
+		auto i = from;
+
+#if defined(ACID_PARTICLES_SSE)
+		// Four particles per step, chunks are not aligned so loads and stores are unaligned.
+		auto deltas = _mm_set1_ps(delta);
+		auto gravitySteps = _mm_set1_ps(gravityStep);
+		auto fadeSteps = _mm_set1_ps(fadeStep);
+		auto fadeTimes = _mm_set1_ps(FadeTime);
+
+		for (; i + 4 <= to; i += 4)
+		{
+			auto vy = _mm_add_ps(_mm_loadu_ps(velocityY + i), _mm_mul_ps(gravitySteps, _mm_loadu_ps(gravityEffect + i)));
+			_mm_storeu_ps(velocityY + i, vy);
+			_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(_mm_loadu_ps(velocityX + i), deltas)));
+			_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, deltas)));
+			_mm_storeu_ps(positionZ + i, _mm_add_ps(_mm_loadu_ps(positionZ + i), _mm_mul_ps(_mm_loadu_ps(velocityZ + i), deltas)));
+
+			auto elapsed = _mm_add_ps(_mm_loadu_ps(elapsedTime + i), deltas);
+			_mm_storeu_ps(elapsedTime + i, elapsed);
+
+			// Particles past the start of their fade lose transparency, the others subtract zero.
+			auto fading = _mm_cmpgt_ps(elapsed, _mm_sub_ps(_mm_loadu_ps(lifeLength + i), fadeTimes));
+			_mm_storeu_ps(transparency + i, _mm_sub_ps(_mm_loadu_ps(transparency + i), _mm_and_ps(fading, fadeSteps)));
+		}
+#endif
+
+		for (; i < to; i++)
+		{
+			velocityY[i] += gravityStep * gravityEffect[i];
+			positionX[i] += velocityX[i] * delta;
+			positionY[i] += velocityY[i] * delta;
+			positionZ[i] += velocityZ[i] * delta;
+			elapsedTime[i] += delta;
+
+			if (elapsedTime[i] > lifeLength[i] - FadeTime)
+			{
+				transparency[i] -= fadeStep;
+			}
+		}
+	}
+
+	void ParticlePool::Compact()
+	{
+		auto &transparency = GetField(Field::Transparency);
+		auto size = transparency.size();
+
+		for (std::size_t i = 0; i < size;)
+		{
+			if (transparency[i] > 0.0f)
+			{
+				i++;
+				continue;
+			}
+
+			// The last particle takes the place of the dead one, and is checked next.
+			size--;
+
+			for (auto &field : m_fields)
+			{
+				field[i] = field[size];
+			}
+		}
+
+		for (auto &field : m_fields)
+		{
+			field.resize(size);
+		}
+	}
+
+	void ParticlePool::Clear()
+	{
+		for (auto &field : m_fields)
+		{
+			field.clear();
+		}
+	}
+
+	Vector3 ParticlePool::GetPosition(const uint32_t &index) const
+	{
+		return Vector3(GetField(Field::PositionX)[index], GetField(Field::PositionY)[index], GetField(Field::PositionZ)[index]);
+	}
+}
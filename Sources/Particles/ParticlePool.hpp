@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "Maths/Vector3.hpp"
+#include "Particle.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// The live particles of a single type, stored as a structure of arrays so the simulation can step several particles per instruction.
+	/// Dead particles are removed by moving the last particle into their slot, so the order of particles is not kept.
+	/// </summary>
+	class ACID_EXPORT ParticlePool
+	{
+	public:
+		/// <summary>
+		/// The simulated values of each particle, every field is a array of floats.
+		/// </summary>
+		enum class Field
+		{
+			PositionX, PositionY, PositionZ, VelocityX, VelocityY, VelocityZ, LifeLength, StageCycles, Rotation, Scale, GravityEffect, ElapsedTime, Transparency, Count
+		};
+
+		/// <summary>
+		/// Adds a particle to the end of the pool.
+		/// </summary>
+		/// <param name="particle"> The initial state of the particle. </param>
+		void Add(const Particle &particle);
+
+		/// <summary>
+		/// Steps every particle, the pool is split into chunks that are updated across the thread pool.
+		/// </summary>
+		/// <param name="delta"> The time since the last update in seconds. </param>
+		void Update(const float &delta);
+
+		/// <summary>
+		/// Steps the particles in the range [from, to).
+		/// </summary>
+		/// <param name="delta"> The time since the last update in seconds. </param>
+		/// <param name="from"> The first particle to step. </param>
+		/// <param name="to"> One past the last particle to step. </param>
+		void Update(const float &delta, const uint32_t &from, const uint32_t &to);
+
+		/// <summary>
+		/// Removes every particle that has faded out.
+		/// </summary>
+		void Compact();
+
+		/// <summary>
+		/// Removes every particle.
+		/// </summary>
+		void Clear();
+
+		uint32_t GetSize() const { return static_cast<uint32_t>(GetField(Field::PositionX).size()); }
+
+		bool IsEmpty() const { return GetField(Field::PositionX).empty(); }
+
+		const std::vector<float> &GetField(const Field &field) const { return m_fields[static_cast<std::size_t>(field)]; }
+
+		Vector3 GetPosition(const uint32_t &index) const;
+
+		/// <summary>
+		/// The amount of particles in each chunk of a threaded update.
+		/// </summary>
+		static const uint32_t UpdateGrainSize;
+
+		/// <summary>
+		/// The time in seconds a particle takes to fade out at the end of its life.
+		/// </summary>
+		static const float FadeTime;
+	private:
+		std::vector<float> &GetField(const Field &field) { return m_fields[static_cast<std::size_t>(field)]; }
+
+		std::array<std::vector<float>, static_cast<std::size_t>(Field::Count)> m_fields;
+	};
+}
@@ -0,0 +1,150 @@
+#include "ParticleSort.hpp"
+
+namespace acid
+{
+	const uint32_t ParticleSort::BlockSize = 4096;
+
+	static const uint32_t WORKGROUP_SIZE = 256;
+	static const uint32_t BLOCK_WORKGROUP_SIZE = 128;
+	static const uint32_t KEY_BITS = 16;
+	static const uint32_t DIGIT_BITS = 4;
+	static const uint32_t DIGIT_COUNT = 1u << DIGIT_BITS;
+
+	ParticleSort::ParticleSort(const uint32_t &capacity) :
+		m_capacity(capacity),
+		m_blockCount((capacity + BlockSize - 1) / BlockSize),
+		m_pipelineKeys("Shaders/Particles/SortKeys.comp", capacity, 1, WORKGROUP_SIZE, false, {}, 2),
+		m_pipelineCount("Shaders/Particles/SortCount.comp", m_blockCount * BLOCK_WORKGROUP_SIZE, 1, BLOCK_WORKGROUP_SIZE, false, {}, 4),
+		m_pipelineScan("Shaders/Particles/SortScan.comp", WORKGROUP_SIZE, 1, WORKGROUP_SIZE, false, {}, 1),
+		m_pipelineScatter("Shaders/Particles/SortScatter.comp", m_blockCount * BLOCK_WORKGROUP_SIZE, 1, BLOCK_WORKGROUP_SIZE, false, {}, 4),
+		m_descriptorsScan(m_pipelineScan)
+	{
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			m_keys[i] = std::make_unique<StorageBuffer>(sizeof(uint32_t) * m_capacity, nullptr, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			m_values[i] = std::make_unique<StorageBuffer>(sizeof(uint32_t) * m_capacity, nullptr, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			m_descriptorsKeys.emplace_back(m_pipelineKeys);
+		}
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			m_descriptorsCount.emplace_back(m_pipelineCount);
+			m_descriptorsScatter.emplace_back(m_pipelineScatter);
+		}
+
+		// Each digit of each block has a count, stored digit major so a single scan gives every block the offset it scatters each digit to.
+		m_histograms = std::make_unique<StorageBuffer>(sizeof(uint32_t) * DIGIT_COUNT * m_blockCount, nullptr, 0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	}
+
+	bool ParticleSort::CmdSort(const CommandBuffer &commandBuffer, const uint32_t &target, const StorageBuffer &states, const StorageBuffer &draw,
+		const Vector3 &cameraPosition, const float &farPlane)
+	{
+		// Push constants are bound to their blocks before being written, the first push after a block is found clears the data.
+		auto &descriptorsKeys = m_descriptorsKeys[target];
+		descriptorsKeys.Push("PushSort", m_pushKeys);
+		descriptorsKeys.Push("Particles", states);
+		descriptorsKeys.Push("DrawIn", draw);
+		descriptorsKeys.Push("KeysOut", *m_keys[0]);
+		descriptorsKeys.Push("ValuesOut", *m_values[0]);
+		bool updateSuccess = descriptorsKeys.Update(m_pipelineKeys);
+
+		m_descriptorsScan.Push("PushSort", m_pushScan);
+		m_descriptorsScan.Push("Histograms", *m_histograms);
+		updateSuccess &= m_descriptorsScan.Update(m_pipelineScan);
+
+		for (uint32_t parity = 0; parity < 2; parity++)
+		{
+			auto &descriptorsCount = m_descriptorsCount[2 * target + parity];
+			descriptorsCount.Push("PushSort", m_pushCount);
+			descriptorsCount.Push("DrawIn", draw);
+			descriptorsCount.Push("KeysIn", *m_keys[parity]);
+			descriptorsCount.Push("Histograms", *m_histograms);
+			updateSuccess &= descriptorsCount.Update(m_pipelineCount);
+
+			auto &descriptorsScatter = m_descriptorsScatter[2 * target + parity];
+			descriptorsScatter.Push("PushSort", m_pushScatter);
+			descriptorsScatter.Push("DrawIn", draw);
+			descriptorsScatter.Push("KeysIn", *m_keys[parity]);
+			descriptorsScatter.Push("ValuesIn", *m_values[parity]);
+			descriptorsScatter.Push("KeysOut", *m_keys[1 - parity]);
+			descriptorsScatter.Push("ValuesOut", *m_values[1 - parity]);
+			descriptorsScatter.Push("Histograms", *m_histograms);
+			updateSuccess &= descriptorsScatter.Update(m_pipelineScatter);
+		}
+
+		if (!updateSuccess)
+		{
+			return false;
+		}
+
+		// Keys are the distance scaled over the far plane and inverted, so sorting ascending orders particles back to front.
+		m_pushKeys.Push("cameraPosition", cameraPosition);
+		m_pushKeys.Push("keyScale", farPlane > 0.0f ? 1.0f / farPlane : 0.0f);
+		m_pushKeys.Push("capacity", m_capacity);
+		m_pushScan.Push("count", DIGIT_COUNT * m_blockCount);
+		m_pushCount.Push("capacity", m_capacity);
+		m_pushCount.Push("blockCount", m_blockCount);
+		m_pushScatter.Push("capacity", m_capacity);
+		m_pushScatter.Push("blockCount", m_blockCount);
+
+		CmdBarrier(commandBuffer);
+
+		m_pipelineKeys.BindPipeline(commandBuffer);
+		descriptorsKeys.BindDescriptor(commandBuffer, m_pipelineKeys);
+		m_pushKeys.BindPush(commandBuffer, m_pipelineKeys);
+		m_pipelineKeys.CmdRender(commandBuffer, m_capacity, 1);
+
+		// An even amount of passes leaves the sorted keys and indices in the first buffers.
+		for (uint32_t shift = 0; shift < KEY_BITS; shift += DIGIT_BITS)
+		{
+			auto parity = (shift / DIGIT_BITS) % 2;
+			m_pushCount.Push("shift", shift);
+			m_pushScatter.Push("shift", shift);
+
+			CmdBarrier(commandBuffer);
+
+			m_pipelineCount.BindPipeline(commandBuffer);
+			m_descriptorsCount[2 * target + parity].BindDescriptor(commandBuffer, m_pipelineCount);
+			m_pushCount.BindPush(commandBuffer, m_pipelineCount);
+			m_pipelineCount.CmdRender(commandBuffer, m_blockCount * BLOCK_WORKGROUP_SIZE, 1);
+
+			CmdBarrier(commandBuffer);
+
+			m_pipelineScan.BindPipeline(commandBuffer);
+			m_descriptorsScan.BindDescriptor(commandBuffer, m_pipelineScan);
+			m_pushScan.BindPush(commandBuffer, m_pipelineScan);
+			m_pipelineScan.CmdRender(commandBuffer, WORKGROUP_SIZE, 1);
+
+			CmdBarrier(commandBuffer);
+
+			m_pipelineScatter.BindPipeline(commandBuffer);
+			m_descriptorsScatter[2 * target + parity].BindDescriptor(commandBuffer, m_pipelineScatter);
+			m_pushScatter.BindPush(commandBuffer, m_pipelineScatter);
+			m_pipelineScatter.CmdRender(commandBuffer, m_blockCount * BLOCK_WORKGROUP_SIZE, 1);
+		}
+
+		return true;
+	}
+
+	std::size_t ParticleSort::GetGpuSize() const
+	{
+		std::size_t size = m_histograms->GetSize();
+
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			size += m_keys[i]->GetSize() + m_values[i]->GetSize();
+		}
+
+		return size;
+	}
+
+	void ParticleSort::CmdBarrier(const CommandBuffer &commandBuffer) const
+	{
+		VkMemoryBarrier memoryBarrier = {};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+	}
+}
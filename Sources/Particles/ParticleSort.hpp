@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "Maths/Vector3.hpp"
+#include "Renderer/Buffers/StorageBuffer.hpp"
+#include "Renderer/Handlers/DescriptorsHandler.hpp"
+#include "Renderer/Handlers/PushHandler.hpp"
+#include "Renderer/Pipelines/PipelineCompute.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// Sorts particles simulated on the GPU back to front with a compute radix sort. A key pass writes a 16 bit distance key and the index of each live particle,
+	/// then each 4 bit digit is sorted with a count, scan and stable scatter pass. The sorted indices are read by the draw in place of the instance index.
+	/// </summary>
+	class ACID_EXPORT ParticleSort
+	{
+	public:
+		/// <summary>
+		/// Creates a new particle sort.
+		/// </summary>
+		/// <param name="capacity"> The most particles that can be sorted, the capacity of the simulation. </param>
+		explicit ParticleSort(const uint32_t &capacity);
+
+		/// <summary>
+		/// Records a sort of the simulated particles, must be recorded outside of a renderpass after the simulation step.
+		/// The caller makes the indices visible to the draw, the same as the particles.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into. </param>
+		/// <param name="target"> The index of the state buffer that was written, each has its own descriptors. </param>
+		/// <param name="states"> The simulated particles. </param>
+		/// <param name="draw"> The indirect draw holding the live particle count. </param>
+		/// <param name="cameraPosition"> The position particles are sorted away from. </param>
+		/// <param name="farPlane"> The distance keys are scaled over, particles further away share the last key. </param>
+		/// <returns> If the sort was recorded. </returns>
+		bool CmdSort(const CommandBuffer &commandBuffer, const uint32_t &target, const StorageBuffer &states, const StorageBuffer &draw,
+			const Vector3 &cameraPosition, const float &farPlane);
+
+		/// <summary>
+		/// Gets the particle indices from furthest to nearest, written by the last sort.
+		/// </summary>
+		/// <returns> The sorted indices. </returns>
+		const StorageBuffer &GetIndices() const { return *m_values[0]; }
+
+		/// <summary>
+		/// Gets the amount of device memory used by the key, value and histogram buffers.
+		/// </summary>
+		/// <returns> The size in bytes. </returns>
+		std::size_t GetGpuSize() const;
+
+		const uint32_t &GetCapacity() const { return m_capacity; }
+
+		/// <summary>
+		/// The particles sorted by each workgroup of the count and scatter passes.
+		/// </summary>
+		static const uint32_t BlockSize;
+	private:
+		void CmdBarrier(const CommandBuffer &commandBuffer) const;
+
+		uint32_t m_capacity;
+		uint32_t m_blockCount;
+
+		std::array<std::unique_ptr<StorageBuffer>, 2> m_keys;
+		std::array<std::unique_ptr<StorageBuffer>, 2> m_values;
+		std::unique_ptr<StorageBuffer> m_histograms;
+
+		PipelineCompute m_pipelineKeys;
+		PipelineCompute m_pipelineCount;
+		PipelineCompute m_pipelineScan;
+		PipelineCompute m_pipelineScatter;
+
+		PushHandler m_pushKeys;
+		PushHandler m_pushCount;
+		PushHandler m_pushScan;
+		PushHandler m_pushScatter;
+
+		// Sets are kept for each simulation target and for each ping-pong direction, so a set is never rewritten while a frame in flight uses it.
+		std::vector<DescriptorsHandler> m_descriptorsKeys;
+		std::vector<DescriptorsHandler> m_descriptorsCount;
+		DescriptorsHandler m_descriptorsScan;
+		std::vector<DescriptorsHandler> m_descriptorsScatter;
+	};
+}
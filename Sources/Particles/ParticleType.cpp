@@ -1,25 +1,25 @@
 ﻿#include "ParticleType.hpp"
+#include <algorithm>
 #include <utility>
 
 #include "Resources/Resources.hpp"
 #include "Maths/Maths.hpp"
 #include "Models/Shapes/ModelRectangle.hpp"
+#include "Renderer/Renderer.hpp"
 #include "Scenes/Scenes.hpp"
-#include "Particle.hpp"
+#include "ParticlePool.hpp"
 
 namespace acid
 {
-	static const uint32_t MAX_INSTANCES = 1024;
-//	static const uint32_t INSTANCE_STEPS = 128;
 	static const float FRUSTUM_BUFFER = 1.4f;
 
 	std::shared_ptr<ParticleType> ParticleType::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<ParticleType>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<ParticleType>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<ParticleType>(nullptr);
@@ -30,16 +30,16 @@ namespace acid
 	}
 
 	std::shared_ptr<ParticleType> ParticleType::Create(const std::shared_ptr<Texture> &texture, const uint32_t &numberOfRows, const Colour &colourOffset, 
-		const float &lifeLength, const float &stageCycles, const float &scale)
+		const float &lifeLength, const float &stageCycles, const float &scale, const uint32_t &computeCapacity, const Blend &blend)
 	{
-		auto temp = ParticleType(texture, numberOfRows, colourOffset, lifeLength, stageCycles, scale);
+		auto temp = ParticleType(texture, numberOfRows, colourOffset, lifeLength, stageCycles, scale, computeCapacity, blend);
 		Metadata metadata = Metadata();
 		temp.Encode(metadata);
 		return Create(metadata);
 	}
 
 	ParticleType::ParticleType(std::shared_ptr<Texture> texture, const uint32_t &numberOfRows, const Colour &colourOffset,
-		const float &lifeLength, const float &stageCycles, const float &scale) :
+		const float &lifeLength, const float &stageCycles, const float &scale, const uint32_t &computeCapacity, const Blend &blend) :
 		m_texture(std::move(texture)),
 		m_model(ModelRectangle::Create(-0.5f, 0.5f)),
 		m_numberOfRows(numberOfRows),
@@ -47,13 +47,12 @@ namespace acid
 		m_lifeLength(lifeLength),
 		m_stageCycles(stageCycles),
 		m_scale(scale),
-		m_maxInstances(0),
-		m_instances(0),
-		m_instanceBuffer(sizeof(ParticleTypeData) * MAX_INSTANCES)
+		m_computeCapacity(computeCapacity),
+		m_blend(blend)
 	{
 	}
 
-	bool ParticleType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene, const std::vector<Particle> &particles)
+	bool ParticleType::CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene, const ParticlePool &particles)
 	{
 		bool updatedBuffer = UpdateInstanceBuffer(particles);
 
@@ -75,45 +74,126 @@ namespace acid
 		// Draws the instanced objects.
 		m_descriptorSet.BindDescriptor(commandBuffer, pipeline);
 
-		VkBuffer vertexBuffers[] = {m_model->GetVertexBuffer()->GetBuffer(), m_instanceBuffer.GetBuffer()};
-		VkDeviceSize offsets[] = {0, 0};
-		vkCmdBindVertexBuffers(commandBuffer.GetCommandBuffer(), 0, 2, vertexBuffers, offsets);
 		vkCmdBindIndexBuffer(commandBuffer.GetCommandBuffer(), m_model->GetIndexBuffer()->GetBuffer(), 0, m_model->GetIndexType());
-		vkCmdDrawIndexed(commandBuffer.GetCommandBuffer(), m_model->GetIndexCount(), m_instances, 0, 0, 0);
+
+		// Batches are drawn in order, so sorted particles stay back to front across batches.
+		for (const auto &batch : m_batches)
+		{
+			VkBuffer vertexBuffers[] = {m_model->GetVertexBuffer()->GetBuffer(), batch.m_buffer};
+			VkDeviceSize offsets[] = {0, batch.m_offset};
+			vkCmdBindVertexBuffers(commandBuffer.GetCommandBuffer(), 0, 2, vertexBuffers, offsets);
+			vkCmdDrawIndexed(commandBuffer.GetCommandBuffer(), m_model->GetIndexCount(), batch.m_instances, 0, 0, 0);
+		}
+
 		return true;
 	}
 
-	bool ParticleType::UpdateInstanceBuffer(const std::vector<Particle> &particles)
+	void ParticleType::CmdSimulate(const CommandBuffer &commandBuffer, const ParticlePool &emitted, const float &delta)
+	{
+		// Every frame that could have recorded a retired simulation has completed once the swapchain has cycled past it.
+		auto frameNumber = Renderer::Get()->GetRingBuffer()->GetFrameNumber();
+		auto framesInFlight = Renderer::Get()->GetSwapchain()->GetImageCount();
+		m_retiredComputes.erase(std::remove_if(m_retiredComputes.begin(), m_retiredComputes.end(), [&](const std::pair<uint64_t, std::unique_ptr<ParticleCompute>> &retired)
+		{
+			return frameNumber > retired.first + framesInFlight;
+		}), m_retiredComputes.end());
+
+		if (m_computeCapacity == 0)
+		{
+			return;
+		}
+
+		// Created on first use, so types that are only encoded never allocate GPU state.
+		if (m_compute == nullptr)
+		{
+			m_compute = std::make_unique<ParticleCompute>(m_computeCapacity, m_model, IsSorted());
+		}
+
+		m_compute->CmdSimulate(commandBuffer, emitted, delta);
+	}
+
+	bool ParticleType::CmdRenderComputed(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene)
 	{
-		if (particles.empty())
+		if (m_compute == nullptr)
 		{
 			return false;
 		}
 
-		// Calculates a max instance count over the time of the type. TODO: Allow decreasing max using a timer and average count over the delay.
-	//	uint32_t instances = INSTANCE_STEPS * static_cast<uint32_t>(std::ceil(static_cast<float>(particles.size()) / static_cast<float>(INSTANCE_STEPS)));
-	//	m_maxInstances = std::max(m_maxInstances, instances);
-		m_maxInstances = MAX_INSTANCES;
-		m_instances = 0;
+		return m_compute->CmdRender(commandBuffer, pipeline, uniformScene, m_texture, m_colourOffset, m_numberOfRows);
+	}
 
-		ParticleTypeData *particleInstances;
-		m_instanceBuffer.Map(reinterpret_cast<void **>(&particleInstances));
+	void ParticleType::ClearComputed()
+	{
+		if (m_compute != nullptr)
+		{
+			m_compute->Clear();
+		}
+	}
+
+	void ParticleType::SetComputeCapacity(const uint32_t &computeCapacity)
+	{
+		m_computeCapacity = computeCapacity;
+		RetireCompute();
+	}
 
-		for (const auto &particle : particles)
+	void ParticleType::SetBlend(const Blend &blend)
+	{
+		m_blend = blend;
+		RetireCompute();
+	}
+
+	bool ParticleType::UpdateInstanceBuffer(const ParticlePool &particles)
+	{
+		if (particles.IsEmpty())
 		{
-			if (m_instances >= m_maxInstances)
-			{
-				break;
-			}
+			return false;
+		}
+
+		auto camera = Scenes::Get()->GetCamera();
+		auto &frustum = camera->GetViewFrustum();
+		auto &scales = particles.GetField(ParticlePool::Field::Scale);
+
+		// Only the visible particles are kept, with their squared distance to the camera.
+		m_visible.clear();
+
+		for (uint32_t i = 0; i < particles.GetSize(); i++)
+		{
+			auto position = particles.GetPosition(i);
 
-			if (!Scenes::Get()->GetCamera()->GetViewFrustum().SphereInFrustum(particle.GetPosition(), FRUSTUM_BUFFER * particle.GetScale()))
+			if (frustum.SphereInFrustum(position, FRUSTUM_BUFFER * scales[i]))
 			{
-				continue;
+				m_visible.emplace_back((camera->GetPosition() - position).LengthSquared(), i);
 			}
+		}
+
+		if (m_visible.empty())
+		{
+			return false;
+		}
+
+		// Alpha blended particles are drawn back to front, the radix sort is linear in the visible count.
+		if (IsSorted())
+		{
+			RadixSort::Sort(m_visible, m_sortScratch, true);
+		}
+
+		// Every visible particle is drawn, instances are written into batches taken from the instance pool, which grows to fit them.
+		Renderer::Get()->GetInstancePool()->Allocate(sizeof(ParticleTypeData), static_cast<uint32_t>(m_visible.size()), m_batches, m_batchInstances);
+		uint32_t instanceIndex = 0;
 
-			auto viewMatrix = Scenes::Get()->GetCamera()->GetViewMatrix();
-			ParticleTypeData *instance = &particleInstances[m_instances];
-			instance->modelMatrix = Matrix4::Identity.Translate(particle.GetPosition());
+		auto &viewMatrix = camera->GetViewMatrix();
+		auto &rotations = particles.GetField(ParticlePool::Field::Rotation);
+		auto &lifeLengths = particles.GetField(ParticlePool::Field::LifeLength);
+		auto &stageCycles = particles.GetField(ParticlePool::Field::StageCycles);
+		auto &elapsedTimes = particles.GetField(ParticlePool::Field::ElapsedTime);
+		auto &transparencies = particles.GetField(ParticlePool::Field::Transparency);
+		auto stageCount = static_cast<int32_t>(m_numberOfRows * m_numberOfRows);
+
+		for (const auto &[distance, i] : m_visible)
+		{
+			auto batchInstances = static_cast<ParticleTypeData *>(m_batchInstances[instanceIndex / InstancePool::BatchInstances]);
+			auto instance = &batchInstances[instanceIndex % InstancePool::BatchInstances];
+			instance->modelMatrix = Matrix4::Identity.Translate(particles.GetPosition(i));
 
 			for (int32_t row = 0; row < 3; row++)
 			{
@@ -123,19 +203,50 @@ namespace acid
 				}
 			}
 
-			instance->modelMatrix = instance->modelMatrix.Rotate(particle.GetRotation() * Maths::DegToRad, Vector3::Front);
-			instance->modelMatrix = instance->modelMatrix.Scale(particle.GetScale() * Vector3::One);
+			instance->modelMatrix = instance->modelMatrix.Rotate(rotations[i] * Maths::DegToRad, Vector3::Front);
+			instance->modelMatrix = instance->modelMatrix.Scale(scales[i] * Vector3::One);
 			// TODO: Multiply MVP by View and Projection
 
-			instance->colourOffset = particle.GetParticleType()->m_colourOffset;
-			instance->offsets = Vector4(particle.GetTextureOffset1(), particle.GetTextureOffset2());
-			instance->blend = Vector3(particle.GetTextureBlendFactor(), particle.GetTransparency(),
-				static_cast<float>(particle.GetParticleType()->m_numberOfRows));
-			m_instances++;
+			// The atlas stage is found from how far through its life the particle is.
+			Vector2 textureOffset1;
+			Vector2 textureOffset2;
+			float textureBlendFactor = 0.0f;
+
+			if (m_texture != nullptr)
+			{
+				float atlasProgression = stageCycles[i] * elapsedTimes[i] / lifeLengths[i] * stageCount;
+				auto index1 = static_cast<int32_t>(std::floor(atlasProgression));
+				int32_t index2 = index1 < stageCount - 1 ? index1 + 1 : index1;
+				textureBlendFactor = std::fmod(atlasProgression, 1.0f);
+				textureOffset1 = CalculateTextureOffset(index1);
+				textureOffset2 = CalculateTextureOffset(index2);
+			}
+
+			instance->colourOffset = m_colourOffset;
+			instance->offsets = Vector4(textureOffset1, textureOffset2);
+			instance->blend = Vector3(textureBlendFactor, transparencies[i], static_cast<float>(m_numberOfRows));
+			instanceIndex++;
 		}
 
-		m_instanceBuffer.Unmap();
-		return m_instances != 0;
+		return true;
+	}
+
+	void ParticleType::RetireCompute()
+	{
+		if (m_compute != nullptr)
+		{
+			m_retiredComputes.emplace_back(Renderer::Get()->GetRingBuffer()->GetFrameNumber(), std::move(m_compute));
+		}
+	}
+
+	Vector2 ParticleType::CalculateTextureOffset(const int32_t &index) const
+	{
+		int32_t column = index % m_numberOfRows;
+		int32_t row = index / m_numberOfRows;
+		Vector2 result = Vector2();
+		result.m_x = static_cast<float>(column) / m_numberOfRows;
+		result.m_y = static_cast<float>(row) / m_numberOfRows;
+		return result;
 	}
 
 	void ParticleType::Decode(const Metadata &metadata)
@@ -146,6 +257,8 @@ namespace acid
 		metadata.GetChild("Life Length", m_lifeLength);
 		metadata.GetChild("Stage Cycles", m_stageCycles);
 		metadata.GetChild("Scale", m_scale);
+		metadata.GetChild("Compute Capacity", m_computeCapacity);
+		metadata.GetChild("Blend", m_blend);
 	}
 
 	void ParticleType::Encode(Metadata &metadata) const
@@ -156,6 +269,26 @@ namespace acid
 		metadata.SetChild("Life Length", m_lifeLength);
 		metadata.SetChild("Stage Cycles", m_stageCycles);
 		metadata.SetChild("Scale", m_scale);
+		metadata.SetChild("Compute Capacity", m_computeCapacity);
+		metadata.SetChild("Blend", m_blend);
+	}
+
+	std::size_t ParticleType::GetCpuSize() const
+	{
+		return sizeof(ParticleType) + m_batches.capacity() * sizeof(InstancePool::Batch) + m_batchInstances.capacity() * sizeof(void *) +
+			(m_visible.capacity() + m_sortScratch.capacity()) * sizeof(RadixSort::Entry);
+	}
+
+	std::size_t ParticleType::GetGpuSize() const
+	{
+		std::size_t size = m_compute != nullptr ? m_compute->GetGpuSize() : 0;
+
+		for (const auto &[frameNumber, retired] : m_retiredComputes)
+		{
+			size += retired->GetGpuSize();
+		}
+
+		return size;
 	}
 
 	Shader::VertexInput ParticleType::GetVertexInput(const uint32_t &binding)
@@ -1,19 +1,22 @@
 ﻿#pragma once
 
+#include "Helpers/RadixSort.hpp"
 #include "Maths/Colour.hpp"
 #include "Maths/Matrix4.hpp"
+#include "Maths/Vector2.hpp"
 #include "Maths/Vector4.hpp"
 #include "Maths/Vector3.hpp"
 #include "Models/Model.hpp"
-#include "Renderer/Buffers/InstanceBuffer.hpp"
+#include "Renderer/Buffers/InstancePool.hpp"
 #include "Renderer/Handlers/DescriptorsHandler.hpp"
 #include "Renderer/Pipelines/PipelineGraphics.hpp"
 #include "Resources/Resource.hpp"
 #include "Textures/Texture.hpp"
+#include "ParticleCompute.hpp"
 
 namespace acid
 {
-	class Particle;
+	class ParticlePool;
 
 	/// <summary>
 	/// A definition for what a particle should act and look like.
@@ -22,6 +25,14 @@ namespace acid
 		public Resource
 	{
 	public:
+		/// <summary>
+		/// How particles are blended over the scene, alpha blended particles depend on draw order and are sorted back to front.
+		/// </summary>
+		enum class Blend
+		{
+			Alpha, Additive
+		};
+
 		/// <summary>
 		/// Will find an existing particle type with the same values, or create a new particle type.
 		/// </summary>
@@ -37,8 +48,11 @@ namespace acid
 		/// <param name="lifeLength"> The averaged life length for the particle. </param>
 		/// <param name="stageCycles"> The amount of times stages will be shown. </param>
 		/// <param name="scale"> The averaged scale for the particle. </param>
+		/// <param name="computeCapacity"> If not zero the particles are simulated on the GPU, with room for this many live particles. </param>
+		/// <param name="blend"> How the particles are blended, additive particles are drawn unsorted. </param>
 		static std::shared_ptr<ParticleType> Create(const std::shared_ptr<Texture> &texture, const uint32_t &numberOfRows = 1, const Colour &colourOffset = Colour::Black,
-			const float &lifeLength = 10.0f, const float &stageCycles = 1.0f, const float &scale = 1.0f);
+			const float &lifeLength = 10.0f, const float &stageCycles = 1.0f, const float &scale = 1.0f, const uint32_t &computeCapacity = 0,
+			const Blend &blend = Blend::Alpha);
 
 		/// <summary>
 		/// Creates a new particle type.
@@ -49,15 +63,44 @@ namespace acid
 		/// <param name="lifeLength"> The averaged life length for the particle. </param>
 		/// <param name="stageCycles"> The amount of times stages will be shown. </param>
 		/// <param name="scale"> The averaged scale for the particle. </param>
+		/// <param name="computeCapacity"> If not zero the particles are simulated on the GPU, with room for this many live particles. </param>
+		/// <param name="blend"> How the particles are blended, additive particles are drawn unsorted. </param>
 		explicit ParticleType(std::shared_ptr<Texture> texture, const uint32_t &numberOfRows = 1, const Colour &colourOffset = Colour::Black,
-			const float &lifeLength = 10.0f, const float &stageCycles = 1.0f, const float &scale = 1.0f);
+			const float &lifeLength = 10.0f, const float &stageCycles = 1.0f, const float &scale = 1.0f, const uint32_t &computeCapacity = 0,
+			const Blend &blend = Blend::Alpha);
+
+		bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene, const ParticlePool &particles);
 
-		bool CmdRender(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene, const std::vector<Particle> &particles);
+		/// <summary>
+		/// Records a GPU simulation step of this type, only used when the type has a compute capacity.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into, outside of a renderpass. </param>
+		/// <param name="emitted"> The particles emitted since the last step. </param>
+		/// <param name="delta"> The time since the last step in seconds. </param>
+		void CmdSimulate(const CommandBuffer &commandBuffer, const ParticlePool &emitted, const float &delta);
+
+		/// <summary>
+		/// Records a draw of the particles simulated on the GPU.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into. </param>
+		/// <param name="pipeline"> The particle pipeline built with the COMPUTED define. </param>
+		/// <param name="uniformScene"> The scene uniforms. </param>
+		/// <returns> If the particles were drawn. </returns>
+		bool CmdRenderComputed(const CommandBuffer &commandBuffer, const PipelineGraphics &pipeline, UniformHandler &uniformScene);
+
+		/// <summary>
+		/// Removes every particle simulated on the GPU.
+		/// </summary>
+		void ClearComputed();
 
 		void Decode(const Metadata &metadata) override;
 
 		void Encode(Metadata &metadata) const override;
 
+		std::size_t GetCpuSize() const override;
+
+		std::size_t GetGpuSize() const override;
+
 		static Shader::VertexInput GetVertexInput(const uint32_t &binding = 0);
 
 		const std::shared_ptr<Texture> &GetTexture() const { return m_texture; }
@@ -83,8 +126,29 @@ namespace acid
 		const float &GetScale() const { return m_scale; }
 
 		void SetScale(const float &scale) { m_scale = scale; }
+
+		const uint32_t &GetComputeCapacity() const { return m_computeCapacity; }
+
+		void SetComputeCapacity(const uint32_t &computeCapacity);
+
+		const Blend &GetBlend() const { return m_blend; }
+
+		void SetBlend(const Blend &blend);
+
+		/// <summary>
+		/// Gets if the particles are drawn back to front.
+		/// </summary>
+		/// <returns> If the particles are sorted. </returns>
+		bool IsSorted() const { return m_blend == Blend::Alpha; }
 	private:
-		bool UpdateInstanceBuffer(const std::vector<Particle> &particles);
+		bool UpdateInstanceBuffer(const ParticlePool &particles);
+
+		/// <summary>
+		/// Replaces the GPU simulation with a new one on next use, the old one is kept until no frame in flight reads from it.
+		/// </summary>
+		void RetireCompute();
+
+		Vector2 CalculateTextureOffset(const int32_t &index) const;
 
 		struct ParticleTypeData
 		{
@@ -101,11 +165,16 @@ namespace acid
 		float m_lifeLength;
 		float m_stageCycles;
 		float m_scale;
-
-		uint32_t m_maxInstances;
-		uint32_t m_instances;
+		uint32_t m_computeCapacity;
+		Blend m_blend;
 
 		DescriptorsHandler m_descriptorSet;
-		InstanceBuffer m_instanceBuffer;
+		std::vector<InstancePool::Batch> m_batches;
+		std::vector<void *> m_batchInstances;
+		std::vector<RadixSort::Entry> m_visible;
+		std::vector<RadixSort::Entry> m_sortScratch;
+
+		std::unique_ptr<ParticleCompute> m_compute;
+		std::vector<std::pair<uint64_t, std::unique_ptr<ParticleCompute>>> m_retiredComputes;
 	};
 }
@@ -6,6 +6,8 @@ namespace acid
 {
 	Particles::Particles()
 	{
+		AddRead<Scenes>();
+		AddWrite<Particles>();
 	}
 
 	void Particles::Update()
@@ -16,29 +18,20 @@ namespace acid
 		}
 
 		std::lock_guard<std::mutex> lock(m_mutex);
+		auto delta = Engine::Get()->GetDelta().AsSeconds();
 
+		// Particles are drawn sorted by distance from the camera, so the pools are left unsorted here.
 		for (auto it = m_particles.begin(); it != m_particles.end();)
 		{
-			for (auto it1 = (*it).second.begin(); it1 != (*it).second.end();)
-			{
-				(*it1).Update();
-
-				if (!(*it1).IsAlive())
-				{
-					it1 = (*it).second.erase(it1);
-					continue;
-				}
-
-				++it1;
-			}
+			it->second.Update(delta);
+			it->second.Compact();
 
-			if (it->second.empty())
+			if (it->second.IsEmpty())
 			{
 				it = m_particles.erase(it);
 				continue;
 			}
 
-			std::sort((*it).second.begin(), (*it).second.end()); // TODO: Do in render pass and optimize.
 			++it;
 		}
 	}
@@ -46,20 +39,37 @@ namespace acid
 	void Particles::AddParticle(const Particle &particle)
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
-		auto it = m_particles.find(particle.GetParticleType());
 
-		if (it == m_particles.end())
+		// Types simulated on the GPU only queue the particle, it is uploaded by the next simulation step.
+		if (particle.GetParticleType()->GetComputeCapacity() != 0)
 		{
-			m_particles.emplace(particle.GetParticleType(), std::vector<Particle>());
-			it = m_particles.find(particle.GetParticleType());
+			m_emitted[particle.GetParticleType()].Add(particle);
+			return;
 		}
 
-		(*it).second.emplace_back(particle);
+		m_particles[particle.GetParticleType()].Add(particle);
+	}
+
+	void Particles::ClearEmitted()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (auto &[type, emitted] : m_emitted)
+		{
+			emitted.Clear();
+		}
 	}
 
 	void Particles::Clear()
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
 		m_particles.clear();
+
+		for (auto &[type, emitted] : m_emitted)
+		{
+			type->ClearComputed();
+		}
+
+		m_emitted.clear();
 	}
 }
@@ -2,9 +2,9 @@
 
 #include <map>
 #include <mutex>
-#include <vector>
 #include "Engine/Engine.hpp"
 #include "Particle.hpp"
+#include "ParticlePool.hpp"
 
 namespace acid
 {
@@ -33,12 +33,25 @@ namespace acid
 		void Clear();
 
 		/// <summary>
-		/// Gets a list of all particles.
+		/// Gets the pools of live particles, one for each particle type.
 		/// </summary>
 		/// <returns> All particles. </returns>
-		const std::map<std::shared_ptr<ParticleType>, std::vector<Particle>> &GetParticles() const { return m_particles; }
+		const std::map<std::shared_ptr<ParticleType>, ParticlePool> &GetParticles() const { return m_particles; }
+
+		/// <summary>
+		/// Gets the particles emitted since the last GPU simulation step, for every type simulated on the GPU.
+		/// A type stays in the map once it has emitted, so its live particles keep being simulated and drawn.
+		/// </summary>
+		/// <returns> The emitted particles. </returns>
+		const std::map<std::shared_ptr<ParticleType>, ParticlePool> &GetEmitted() const { return m_emitted; }
+
+		/// <summary>
+		/// Empties the emitted particles once they have been uploaded by a simulation step.
+		/// </summary>
+		void ClearEmitted();
 	private:
 		std::mutex m_mutex;
-		std::map<std::shared_ptr<ParticleType>, std::vector<Particle>> m_particles;
+		std::map<std::shared_ptr<ParticleType>, ParticlePool> m_particles;
+		std::map<std::shared_ptr<ParticleType>, ParticlePool> m_emitted;
 	};
 }
@@ -9,23 +9,62 @@ namespace acid
 	RendererParticles::RendererParticles(const Pipeline::Stage &pipelineStage) :
 		RenderPipeline(pipelineStage),
 		m_pipeline(pipelineStage, {"Shaders/Particles/Particle.vert", "Shaders/Particles/Particle.frag"}, {VertexModel::GetVertexInput(0), ParticleType::GetVertexInput(1)},
-			PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::Read, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT, false, {})
+			PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::Read, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT, false, {}),
+		m_pipelineAdditive(pipelineStage, {"Shaders/Particles/Particle.vert", "Shaders/Particles/Particle.frag"}, {VertexModel::GetVertexInput(0), ParticleType::GetVertexInput(1)},
+			PipelineGraphics::Mode::Additive, PipelineGraphics::Depth::Read, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT, false, {}),
+		m_pipelineComputed(pipelineStage, {"Shaders/Particles/Particle.vert", "Shaders/Particles/Particle.frag"}, {VertexModel::GetVertexInput(0)},
+			PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::Read, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT, false, 
+			{{"COMPUTED", "1"}, {"SORTED", "1"}}),
+		m_pipelineComputedAdditive(pipelineStage, {"Shaders/Particles/Particle.vert", "Shaders/Particles/Particle.frag"}, {VertexModel::GetVertexInput(0)},
+			PipelineGraphics::Mode::Additive, PipelineGraphics::Depth::Read, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_FRONT_BIT, false, 
+			{{"COMPUTED", "1"}}),
+		m_uniformScene(true)
 	{
 	}
 
+	void RendererParticles::PreRender(const CommandBuffer &commandBuffer)
+	{
+		auto delta = Scenes::Get()->IsPaused() ? 0.0f : Engine::Get()->GetDelta().AsSeconds();
+
+		for (auto &[type, emitted] : Particles::Get()->GetEmitted())
+		{
+			type->CmdSimulate(commandBuffer, emitted, delta);
+		}
+
+		Particles::Get()->ClearEmitted();
+	}
+
 	void RendererParticles::Render(const CommandBuffer &commandBuffer)
 	{
 		auto camera = Scenes::Get()->GetCamera();
 		m_uniformScene.Push("projection", camera->GetProjectionMatrix());
 		m_uniformScene.Push("view", camera->GetViewMatrix());
 
-		auto particles = Particles::Get()->GetParticles();
+		// Alpha blended types are drawn first with their particles sorted back to front, additive types are unsorted and drawn over them.
+		for (const auto &blend : {ParticleType::Blend::Alpha, ParticleType::Blend::Additive})
+		{
+			auto &pipeline = blend == ParticleType::Blend::Alpha ? m_pipeline : m_pipelineAdditive;
+			auto &pipelineComputed = blend == ParticleType::Blend::Alpha ? m_pipelineComputed : m_pipelineComputedAdditive;
 
-		m_pipeline.BindPipeline(commandBuffer);
+			pipeline.BindPipeline(commandBuffer);
 
-		for (auto &[type, typeParticles] : particles)
-		{
-			type->CmdRender(commandBuffer, m_pipeline, m_uniformScene, typeParticles);
+			for (auto &[type, typeParticles] : Particles::Get()->GetParticles())
+			{
+				if (type->GetBlend() == blend)
+				{
+					type->CmdRender(commandBuffer, pipeline, m_uniformScene, typeParticles);
+				}
+			}
+
+			pipelineComputed.BindPipeline(commandBuffer);
+
+			for (auto &[type, typeEmitted] : Particles::Get()->GetEmitted())
+			{
+				if (type->GetBlend() == blend)
+				{
+					type->CmdRenderComputed(commandBuffer, pipelineComputed, m_uniformScene);
+				}
+			}
 		}
 	}
 }
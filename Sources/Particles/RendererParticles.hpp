@@ -6,15 +6,25 @@
 
 namespace acid
 {
+	/// <summary>
+	/// Draws particles, types simulated on the CPU are drawn from instances written each frame,
+	/// types simulated on the GPU are stepped before the renderpass and drawn indirectly from their simulated buffer.
+	/// Each blend mode has its own pipelines, only alpha blended types are sorted.
+	/// </summary>
 	class ACID_EXPORT RendererParticles :
 		public RenderPipeline
 	{
 	public:
 		explicit RendererParticles(const Pipeline::Stage &pipelineStage);
 
+		void PreRender(const CommandBuffer &commandBuffer) override;
+
 		void Render(const CommandBuffer &commandBuffer) override;
 	private:
 		PipelineGraphics m_pipeline;
+		PipelineGraphics m_pipelineAdditive;
+		PipelineGraphics m_pipelineComputed;
+		PipelineGraphics m_pipelineComputedAdditive;
 		UniformHandler m_uniformScene;
 	};
 }
@@ -47,6 +47,12 @@ namespace acid
 		/// <param name="max"> The point 2nd position. </param>
 		/// <returns> True if partially contained, false if outside. </returns>
 		bool CubeInFrustum(const Vector3 &min, const Vector3 &max) const;
+
+		/// <summary>
+		/// Gets the planes of the frustum, each as a normal and distance, the normals point inwards.
+		/// </summary>
+		/// <returns> The right, left, bottom, top, back and front planes. </returns>
+		const std::array<std::array<float, 4>, 6> &GetPlanes() const { return m_frustum; }
 	private:
 		void NormalizePlane(const int32_t &side);
 
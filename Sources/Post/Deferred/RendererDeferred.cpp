@@ -1,5 +1,6 @@
 #include "RendererDeferred.hpp"
 
+#include <cstring>
 #include "Files/FileSystem.hpp"
 #include "Lights/Light.hpp"
 #include "Models/Shapes/ModelRectangle.hpp"
@@ -12,10 +13,13 @@
 
 namespace acid
 {
-	static const uint32_t MAX_LIGHTS = 32; // TODO: Make configurable.
+	static const uint32_t CLUSTER_TILES_X = 16;
+	static const uint32_t CLUSTER_TILES_Y = 9;
+	static const uint32_t CLUSTER_SLICES = 24;
 
 	RendererDeferred::RendererDeferred(const Pipeline::Stage &pipelineStage, const Type &type) :
 		RenderPipeline(pipelineStage),
+		m_lightClusters(CLUSTER_TILES_X, CLUSTER_TILES_Y, CLUSTER_SLICES),
 		m_type(type),
 		m_pipeline(pipelineStage, {"Shaders/Deferred/Deferred.vert", "Shaders/Deferred/Deferred.frag"}, {VertexModel::GetVertexInput()},
 			PipelineGraphics::Mode::Polygon, PipelineGraphics::Depth::None, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, false, GetDefines()),
@@ -43,67 +47,163 @@ namespace acid
 			}
 		}
 
-		// Updates uniforms.
-		std::vector<DeferredLight> deferredLights(MAX_LIGHTS);
-		uint32_t lightCount = 0;
+		// Unbounded lights are shaded everywhere and stored first, bounded lights are stored after them and assigned to clusters.
+		m_deferredLights.clear();
+		m_lightClusters.Reset(*camera);
 
-		auto sceneLights = Scenes::Get()->GetStructure()->QueryComponents<Light>();
+		m_view.Bind(Scenes::Get()->GetStructure());
 
-		for (const auto &light : sceneLights)
+		for (const auto &[light] : m_view)
 		{
-		//	auto position = *light->GetPosition();
-		//	float radius = light->GetRadius();
+			if (light->IsEnabled() && light->GetRadius() <= 0.0f)
+			{
+				DeferredLight deferredLight = {};
+				deferredLight.m_colour = light->GetColour();
+				deferredLight.m_position = light->GetWorldTransform().GetPosition();
+				deferredLight.m_radius = light->GetRadius();
+				m_deferredLights.emplace_back(deferredLight);
+			}
+		}
+
+		auto globalLightsCount = static_cast<uint32_t>(m_deferredLights.size());
 
-		//	if (radius >= 0.0f && !camera.GetViewFrustum()->SphereInFrustum(position, radius))
-		//	{
-		//		continue;
-		//	}
+		for (const auto &[light] : m_view)
+		{
+			if (!light->IsEnabled() || light->GetRadius() <= 0.0f)
+			{
+				continue;
+			}
 
 			DeferredLight deferredLight = {};
 			deferredLight.m_colour = light->GetColour();
 			deferredLight.m_position = light->GetWorldTransform().GetPosition();
 			deferredLight.m_radius = light->GetRadius();
-			deferredLights[lightCount] = deferredLight;
-			lightCount++;
 
-			if (lightCount >= MAX_LIGHTS)
+			if (m_lightClusters.Add(static_cast<uint32_t>(m_deferredLights.size()), deferredLight.m_position, deferredLight.m_radius))
+			{
+				m_deferredLights.emplace_back(deferredLight);
+			}
+		}
+
+		m_lightClusters.Build();
+
+		// The lights and clusters change every frame, they are written into the ring buffer. Empty lists still take a element, so the bindings stay valid.
+		auto ringBuffer = Renderer::Get()->GetRingBuffer();
+		auto &clusters = m_lightClusters.GetClusters();
+		auto &indices = m_lightClusters.GetIndices();
+		auto lightsSize = sizeof(DeferredLight) * std::max<std::size_t>(m_deferredLights.size(), 1);
+		auto clustersSize = sizeof(LightClusters::Cluster) * clusters.size();
+		auto indicesSize = sizeof(uint32_t) * std::max<std::size_t>(indices.size(), 1);
+		VkDeviceSize lightsOffset = 0;
+		VkDeviceSize clustersOffset = 0;
+		VkDeviceSize indicesOffset = 0;
+		auto lightsData = ringBuffer->Allocate(lightsSize, lightsOffset);
+		auto clustersData = ringBuffer->Allocate(clustersSize, clustersOffset);
+		auto indicesData = ringBuffer->Allocate(indicesSize, indicesOffset);
+		bool clustered = lightsData != nullptr && clustersData != nullptr && indicesData != nullptr;
+
+		// The light ranges move every frame so each frame in flight has its own set.
+		auto currentFrame = Renderer::Get()->GetCurrentFrame();
+
+		if (clustered)
+		{
+			std::memcpy(lightsData, m_deferredLights.data(), sizeof(DeferredLight) * m_deferredLights.size());
+			std::memcpy(clustersData, clusters.data(), clustersSize);
+			std::memcpy(indicesData, indices.data(), sizeof(uint32_t) * indices.size());
+		}
+		else
+		{
+			Log::Error("Ring buffer is full, %i lights are shaded without clusters!\n", static_cast<int32_t>(m_deferredLights.size()));
+
+			// Every light is shaded as unbounded, from a buffer only this frame in flight writes to, and every cluster is left empty.
+			globalLightsCount = static_cast<uint32_t>(m_deferredLights.size());
+
+			while (m_fallbackLights.size() <= currentFrame)
+			{
+				m_fallbackLights.emplace_back(nullptr);
+			}
+
+			auto &fallbackLights = m_fallbackLights[currentFrame];
+
+			if (fallbackLights == nullptr || fallbackLights->GetSize() < lightsSize)
+			{
+				fallbackLights = std::make_unique<StorageBuffer>(lightsSize);
+			}
+
+			void *data;
+			fallbackLights->Map(&data);
+			std::memcpy(data, m_deferredLights.data(), sizeof(DeferredLight) * m_deferredLights.size());
+			fallbackLights->Unmap();
+
+			if (m_emptyClusters == nullptr)
 			{
-				break;
+				std::vector<LightClusters::Cluster> emptyClusters(clusters.size());
+				m_emptyClusters = std::make_unique<StorageBuffer>(clustersSize, emptyClusters.data());
 			}
 		}
 
 		// Updates uniforms.
 		m_uniformScene.Push("view", camera->GetViewMatrix());
-		m_uniformScene.Push("shadowSpace", Shadows::Get()->GetShadowBox().GetToShadowMapSpaceMatrix());
 		m_uniformScene.Push("cameraPosition", camera->GetPosition());
 
-		m_uniformScene.Push("lightsCount", lightCount);
+		m_uniformScene.Push("globalLightsCount", globalLightsCount);
+		m_uniformScene.Push("clusterNear", m_lightClusters.GetSliceNear());
+		m_uniformScene.Push("clusterScale", m_lightClusters.GetSliceScale());
 
 		m_uniformScene.Push("fogColour", m_fog.GetColour());
 		m_uniformScene.Push("fogDensity", m_fog.GetDensity());
 		m_uniformScene.Push("fogGradient", m_fog.GetGradient());
 
+		// Cascades are picked by view depth, each split is the far distance of a cascade.
+		std::vector<Matrix4> shadowSpaces;
+		Vector4 shadowSplits;
+
+		for (uint32_t i = 0; i < Shadows::Cascades; i++)
+		{
+			shadowSpaces.emplace_back(Shadows::Get()->GetShadowSpace(i));
+			shadowSplits[i] = Shadows::Get()->GetCascadeSplit(i);
+		}
+
+		m_uniformScene.Push("shadowSpaces", *shadowSpaces.data(), sizeof(Matrix4) * shadowSpaces.size());
+		m_uniformScene.Push("shadowSplits", shadowSplits);
 		m_uniformScene.Push("shadowDistance", Shadows::Get()->GetShadowBoxDistance());
 		m_uniformScene.Push("shadowTransition", Shadows::Get()->GetShadowTransition());
 		m_uniformScene.Push("shadowBias", Shadows::Get()->GetShadowBias());
 		m_uniformScene.Push("shadowDarkness", Shadows::Get()->GetShadowDarkness());
 		m_uniformScene.Push("shadowPCF", Shadows::Get()->GetShadowPcf());
 
-		// Updates storage buffers.
-		m_storageLights.Push(deferredLights.data(), sizeof(DeferredLight) * MAX_LIGHTS);
-
 		// Updates descriptors.
-		m_descriptorSet.Push("UboScene", m_uniformScene);
-		m_descriptorSet.Push("Lights", m_storageLights);
-		m_descriptorSet.Push("samplerPosition", Renderer::Get()->GetAttachment("position"));
-		m_descriptorSet.Push("samplerDiffuse", Renderer::Get()->GetAttachment("diffuse"));
-		m_descriptorSet.Push("samplerNormal", Renderer::Get()->GetAttachment("normal"));
-		m_descriptorSet.Push("samplerMaterial", Renderer::Get()->GetAttachment("material"));
-		m_descriptorSet.Push("samplerShadows", Renderer::Get()->GetAttachment("shadows"));
-		m_descriptorSet.Push("samplerBrdf", m_brdf);
-		m_descriptorSet.Push("samplerIbl", m_skybox); // m_ibl
-
-		bool updateSuccess = m_descriptorSet.Update(m_pipeline);
+		while (m_descriptorSets.size() <= currentFrame)
+		{
+			m_descriptorSets.emplace_back(m_pipeline);
+		}
+
+		auto &descriptorSet = m_descriptorSets[currentFrame];
+		descriptorSet.Push("UboScene", m_uniformScene);
+
+		if (clustered)
+		{
+			descriptorSet.Push("Lights", ringBuffer, OffsetSize(static_cast<uint32_t>(lightsOffset), static_cast<uint32_t>(lightsSize)));
+			descriptorSet.Push("Clusters", ringBuffer, OffsetSize(static_cast<uint32_t>(clustersOffset), static_cast<uint32_t>(clustersSize)));
+			descriptorSet.Push("LightIndices", ringBuffer, OffsetSize(static_cast<uint32_t>(indicesOffset), static_cast<uint32_t>(indicesSize)));
+		}
+		else
+		{
+			// Cluster counts are all zero, so the zeroed cluster buffer also serves as the index list.
+			descriptorSet.Push("Lights", m_fallbackLights[currentFrame].get());
+			descriptorSet.Push("Clusters", m_emptyClusters.get());
+			descriptorSet.Push("LightIndices", m_emptyClusters.get());
+		}
+
+		descriptorSet.Push("samplerPosition", Renderer::Get()->GetAttachment("position"));
+		descriptorSet.Push("samplerDiffuse", Renderer::Get()->GetAttachment("diffuse"));
+		descriptorSet.Push("samplerNormal", Renderer::Get()->GetAttachment("normal"));
+		descriptorSet.Push("samplerMaterial", Renderer::Get()->GetAttachment("material"));
+		descriptorSet.Push("samplerShadows", Renderer::Get()->GetAttachment("shadows"));
+		descriptorSet.Push("samplerBrdf", m_brdf);
+		descriptorSet.Push("samplerIbl", m_skybox); // m_ibl
+
+		bool updateSuccess = descriptorSet.Update(m_pipeline);
 
 		if (!updateSuccess)
 		{
@@ -113,7 +213,7 @@ namespace acid
 		// Draws the object.
 		m_pipeline.BindPipeline(commandBuffer);
 
-		m_descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
+		descriptorSet.BindDescriptor(commandBuffer, m_pipeline);
 		m_model->CmdRender(commandBuffer);
 	}
 
@@ -121,7 +221,10 @@ namespace acid
 	{
 		std::vector<Shader::Define> result = {};
 		result.emplace_back("USE_IBL", String::To<int32_t>(m_type == Type::Ibl));
-		result.emplace_back("MAX_LIGHTS", String::To(MAX_LIGHTS));
+		result.emplace_back("CLUSTER_TILES_X", String::To(CLUSTER_TILES_X));
+		result.emplace_back("CLUSTER_TILES_Y", String::To(CLUSTER_TILES_Y));
+		result.emplace_back("CLUSTER_SLICES", String::To(CLUSTER_SLICES));
+		result.emplace_back("NUM_CASCADES", String::To(Shadows::Cascades));
 		return result;
 	}
 
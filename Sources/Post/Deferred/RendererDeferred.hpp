@@ -1,15 +1,23 @@
 #pragma once
 
 #include "Lights/Fog.hpp"
+#include "Lights/LightClusters.hpp"
 #include "Models/Model.hpp"
+#include "Renderer/Buffers/StorageBuffer.hpp"
 #include "Renderer/RenderPipeline.hpp"
 #include "Renderer/Handlers/DescriptorsHandler.hpp"
 #include "Renderer/Handlers/UniformHandler.hpp"
 #include "Renderer/Pipelines/PipelineGraphics.hpp"
+#include "Scenes/View.hpp"
 #include "Textures/Cubemap.hpp"
 
 namespace acid
 {
+	class Light;
+
+	/// <summary>
+	/// Shades the deferred attachments with every light, bounded lights are assigned to clusters of the view and only shade the pixels they can reach.
+	/// </summary>
 	class ACID_EXPORT RendererDeferred :
 		public RenderPipeline
 	{
@@ -40,9 +48,14 @@ namespace acid
 
 		static std::shared_ptr<Cubemap> ComputeIbl(const std::shared_ptr<Cubemap> &source);
 
-		DescriptorsHandler m_descriptorSet;
+		std::vector<DescriptorsHandler> m_descriptorSets;
 		UniformHandler m_uniformScene;
-		StorageHandler m_storageLights;
+		View<Light> m_view;
+		LightClusters m_lightClusters;
+		std::vector<DeferredLight> m_deferredLights;
+		// Used when the ring buffer is full, every light is then shaded without cluster culling.
+		std::vector<std::unique_ptr<StorageBuffer>> m_fallbackLights;
+		std::unique_ptr<StorageBuffer> m_emptyClusters;
 
 		Type m_type;
 
@@ -13,6 +13,8 @@ namespace acid
 			PipelineGraphics::Depth::None, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, false, defines),
 		m_model(ModelRectangle::Create(-1.0f, 1.0f))
 	{
+		// Filters pick their ping-pong attachments from the shared switch count, so they must be recorded in order.
+		SetParallel(false);
 	}
 
 	const Descriptor *PostFilter::GetAttachment(const std::string &descriptorName, const Descriptor *descriptor) const
@@ -18,6 +18,8 @@ namespace acid
 		explicit PostPipeline(const Pipeline::Stage &pipelineStage) :
 			RenderPipeline(pipelineStage)
 		{
+			// The filters of a post pipeline share the switch count with every other filter.
+			SetParallel(false);
 		}
 	};
 }
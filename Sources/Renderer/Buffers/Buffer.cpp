@@ -2,17 +2,16 @@
 
 #include <array>
 #include <cstring>
-#include <cassert>
 #include "Renderer/Renderer.hpp"
 
 namespace acid
 {
 	Buffer::Buffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage, const VkMemoryPropertyFlags &properties, const void *data) :
 		m_size(size),
-		m_buffer(VK_NULL_HANDLE),
-		m_bufferMemory(VK_NULL_HANDLE)
+		m_buffer(VK_NULL_HANDLE)
 	{
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
+		auto memoryAllocator = Renderer::Get()->GetMemoryAllocator();
 
 		auto graphicsFamily = logicalDevice->GetGraphicsFamily();
 		auto presentFamily = logicalDevice->GetPresentFamily();
@@ -20,49 +19,39 @@ namespace acid
 
 		std::array<uint32_t, 3> queueFamily = {graphicsFamily, presentFamily, computeFamily};
 
+		// Data for memory that can not be mapped is copied in from a staging buffer.
+		bool staged = data != nullptr && (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0;
+
 		// Create the buffer handle.
 		VkBufferCreateInfo bufferCreateInfo = {};
 		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		bufferCreateInfo.size = size;
-		bufferCreateInfo.usage = usage;
+		bufferCreateInfo.usage = staged ? usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT : usage;
 		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		bufferCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamily.size());
 		bufferCreateInfo.pQueueFamilyIndices = queueFamily.data();
 		Renderer::CheckVk(vkCreateBuffer(logicalDevice->GetLogicalDevice(), &bufferCreateInfo, nullptr, &m_buffer));
 
-		// Create the memory backing up the buffer handle.
+		// Sub-allocate the memory backing up the buffer handle.
 		VkMemoryRequirements memoryRequirements;
 		vkGetBufferMemoryRequirements(logicalDevice->GetLogicalDevice(), m_buffer, &memoryRequirements);
+		m_allocation = memoryAllocator->Allocate(memoryRequirements, properties, true);
 
-		VkMemoryAllocateInfo memoryAllocateInfo = {};
-		memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		memoryAllocateInfo.allocationSize = memoryRequirements.size;
-		memoryAllocateInfo.memoryTypeIndex = FindMemoryType(memoryRequirements.memoryTypeBits, properties);
-		Renderer::CheckVk(vkAllocateMemory(logicalDevice->GetLogicalDevice(), &memoryAllocateInfo, nullptr, &m_bufferMemory));
+		// Attach the memory to the buffer object.
+		Renderer::CheckVk(vkBindBufferMemory(logicalDevice->GetLogicalDevice(), m_buffer, m_allocation.GetMemory(), m_allocation.GetOffset()));
 
-		// If a pointer to the buffer data has been passed, map the buffer and copy over the data.
-		if (data != nullptr)
+		// If a pointer to the buffer data has been passed, copy over the data.
+		if (staged)
+		{
+			Renderer::Get()->GetUploadManager()->UploadBuffer(m_buffer, data, size);
+		}
+		else if (data != nullptr)
 		{
 			void *mapped;
-			Renderer::CheckVk(vkMapMemory(logicalDevice->GetLogicalDevice(), m_bufferMemory, 0, size, 0, &mapped));
+			Map(&mapped);
 			memcpy(mapped, data, size);
-
-			// If host coherency hasn't been requested, do a manual flush to make writes visible.
-			if ((properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0)
-			{
-				VkMappedMemoryRange mappedMemoryRange = {};
-				mappedMemoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-				mappedMemoryRange.memory = m_bufferMemory;
-				mappedMemoryRange.offset = 0;
-				mappedMemoryRange.size = size;
-				vkFlushMappedMemoryRanges(logicalDevice->GetLogicalDevice(), 1, &mappedMemoryRange);
-			}
-
-			vkUnmapMemory(logicalDevice->GetLogicalDevice(), m_bufferMemory);
+			Unmap();
 		}
-
-		// Attach the memory to the buffer object.
-		Renderer::CheckVk(vkBindBufferMemory(logicalDevice->GetLogicalDevice(), m_buffer, m_bufferMemory, 0));
 	}
 
 	Buffer::~Buffer()
@@ -70,42 +59,27 @@ namespace acid
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 
 		vkDestroyBuffer(logicalDevice->GetLogicalDevice(), m_buffer, nullptr);
-		vkFreeMemory(logicalDevice->GetLogicalDevice(), m_bufferMemory, nullptr);
+		Renderer::Get()->GetMemoryAllocator()->Free(m_allocation);
 	}
 
 	void Buffer::Map(void **data)
 	{
-		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
-		Renderer::CheckVk(vkMapMemory(logicalDevice->GetLogicalDevice(), GetBufferMemory(), 0, m_size, 0, data));
+		*data = m_allocation.GetMapped();
+
+		if (*data == nullptr)
+		{
+			Log::Error("Buffer memory is not host visible, it can not be mapped!\n");
+		}
 	}
 
 	void Buffer::Unmap()
 	{
-		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
-		vkUnmapMemory(logicalDevice->GetLogicalDevice(), GetBufferMemory());
+		Renderer::Get()->GetMemoryAllocator()->Flush(m_allocation);
 	}
 
 	uint32_t Buffer::FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties)
 	{
-		auto physicalDevice = Renderer::Get()->GetPhysicalDevice();
-		auto memoryProperties = physicalDevice->GetMemoryProperties();
-
-		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
-		{
-			uint32_t memoryTypeBits = 1 << i;
-			bool isRequiredMemoryType = typeFilter & memoryTypeBits;
-
-			auto properties = memoryProperties.memoryTypes[i].propertyFlags;
-			bool hasRequiredProperties = (properties & requiredProperties) == requiredProperties;
-
-			if (isRequiredMemoryType && hasRequiredProperties)
-			{
-				return i;
-			}
-		}
-
-		assert(false && "Failed to find a valid memory type for buffer!");
-		return 0;
+		return Renderer::Get()->GetMemoryAllocator()->FindMemoryType(typeFilter, requiredProperties);
 	}
 
 	void Buffer::CopyBuffer(const CommandBuffer &commandBuffer, const VkBuffer srcBuffer, const VkBuffer dstBuffer, const VkDeviceSize &size)
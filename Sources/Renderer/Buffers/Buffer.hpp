@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan.h>
 #include "Renderer/Descriptors/DescriptorSet.hpp"
+#include "Renderer/Memory/MemoryAllocator.hpp"
 
 namespace acid
 {
@@ -19,20 +20,27 @@ namespace acid
 		///	<param name="size"> Size of the buffer in bytes </param>
 		///	<param name="usage"> Usage flag bitmask for the buffer (i.e. index, vertex, uniform buffer) </param>
 		///	<param name="properties"> Memory properties for this buffer (i.e. device local, host visible, coherent) </param>
-		///	<param name="data"> Pointer to the data that should be copied to the buffer after creation (optional, if not set, no data is copied over) </param>
+		///	<param name="data"> Pointer to the data that should be copied to the buffer after creation (optional, if not set, no data is copied over), memory that is not host visible is written through a staging upload. </param>
 		Buffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage, const VkMemoryPropertyFlags &properties, const void *data = nullptr);
 
 		virtual ~Buffer();
 
+		/// <summary>
+		/// Gets the host address of the buffer, the memory of host visible buffers stays mapped.
+		/// </summary>
+		/// <param name="data"> The address to write into. </param>
 		void Map(void **data);
 
+		/// <summary>
+		/// Ends host writes started with <seealso cref="#Map"/>, flushing them if the memory is not host coherent.
+		/// </summary>
 		void Unmap();
 
 		const VkDeviceSize &GetSize() const { return m_size; }
 
 		const VkBuffer &GetBuffer() const { return m_buffer; }
 
-		const VkDeviceMemory &GetBufferMemory() const { return m_bufferMemory; }
+		const MemoryAllocation &GetAllocation() const { return m_allocation; }
 
 		static uint32_t FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties);
 
@@ -40,6 +48,6 @@ namespace acid
 	protected:
 		VkDeviceSize m_size;
 		VkBuffer m_buffer;
-		VkDeviceMemory m_bufferMemory;
+		MemoryAllocation m_allocation;
 	};
 }
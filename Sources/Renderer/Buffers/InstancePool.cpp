@@ -0,0 +1,116 @@
+#include "InstancePool.hpp"
+
+#include <algorithm>
+
+namespace acid
+{
+	const VkDeviceSize InstancePool::DefaultSize = 1024 * 1024;
+	const uint32_t InstancePool::BatchInstances = 4096;
+	const uint32_t InstancePool::ShrinkFrames = 600;
+
+	InstancePool::InstancePool(const VkDeviceSize &size) :
+		m_ring(std::make_unique<RingBuffer>(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)),
+		m_frameUsage(0),
+		m_lowFrames(0)
+	{
+	}
+
+	void *InstancePool::Allocate(const VkDeviceSize &size, VkBuffer &buffer, VkDeviceSize &offset)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		auto mapped = m_ring->Allocate(size, offset);
+
+		// A full ring is replaced by one at least twice its size, the replacement starts empty so the range always fits.
+		if (mapped == nullptr)
+		{
+			auto newSize = m_ring->GetSize();
+
+			while (newSize < std::max(2 * m_ring->GetSize(), size + m_ring->GetAlignment()))
+			{
+				newSize *= 2;
+			}
+
+			Resize(newSize);
+			mapped = m_ring->Allocate(size, offset);
+		}
+
+		m_frameUsage += size;
+		buffer = m_ring->GetBuffer();
+		return mapped;
+	}
+
+	void InstancePool::Allocate(const VkDeviceSize &stride, const uint32_t &instances, std::vector<Batch> &batches, std::vector<void *> &mapped)
+	{
+		batches.clear();
+		mapped.clear();
+
+		for (uint32_t first = 0; first < instances; first += BatchInstances)
+		{
+			Batch batch = {};
+			batch.m_instances = std::min(BatchInstances, instances - first);
+			mapped.emplace_back(Allocate(stride * batch.m_instances, batch.m_buffer, batch.m_offset));
+			batches.emplace_back(batch);
+		}
+	}
+
+	void InstancePool::BeginFrame(const uint32_t &frame)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		m_ring->BeginFrame(frame);
+
+		// Replaced rings are released once no frame in flight reads from them.
+		for (auto &retired : m_retired)
+		{
+			retired->BeginFrame(frame);
+		}
+
+		m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(), [](const std::unique_ptr<RingBuffer> &retired)
+		{
+			return retired->IsIdle();
+		}), m_retired.end());
+	}
+
+	void InstancePool::EndFrame(const uint32_t &frame)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		m_ring->EndFrame(frame);
+
+		for (auto &retired : m_retired)
+		{
+			retired->EndFrame(frame);
+		}
+
+		// The ring holds every frame in flight, a frame using under a eighth of it for long enough halves it.
+		if (m_ring->GetSize() > DefaultSize && 8 * m_frameUsage < m_ring->GetSize())
+		{
+			m_lowFrames++;
+
+			if (m_lowFrames >= ShrinkFrames)
+			{
+				Resize(m_ring->GetSize() / 2);
+			}
+		}
+		else
+		{
+			m_lowFrames = 0;
+		}
+
+		m_frameUsage = 0;
+	}
+
+	VkDeviceSize InstancePool::GetSize() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_ring->GetSize();
+	}
+
+	void InstancePool::Resize(const VkDeviceSize &size)
+	{
+		m_retired.emplace_back(std::move(m_ring));
+		m_ring = std::make_unique<RingBuffer>(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+		m_lowFrames = 0;
+	}
+}
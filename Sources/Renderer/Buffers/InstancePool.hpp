@@ -0,0 +1,88 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Helpers/NonCopyable.hpp"
+#include "RingBuffer.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// A pool of per frame instance data shared by every instanced type, bound as vertex buffers.
+	/// Ranges are taken from a ring that grows geometrically when a frame needs more than it holds, and halves after a sustained stretch of low usage.
+	/// A ring that is replaced is kept until the frames in flight reading it have completed, so ranges taken before a resize stay valid.
+	/// </summary>
+	class ACID_EXPORT InstancePool :
+		public NonCopyable
+	{
+	public:
+		/// <summary>
+		/// A range of instances, draws bind the buffer at the offset.
+		/// </summary>
+		struct Batch
+		{
+			VkBuffer m_buffer;
+			VkDeviceSize m_offset;
+			uint32_t m_instances;
+		};
+
+		explicit InstancePool(const VkDeviceSize &size = DefaultSize);
+
+		/// <summary>
+		/// Takes a range for the current frame, the pool grows instead of failing when it is full.
+		/// </summary>
+		/// <param name="size"> The size of the range in bytes. </param>
+		/// <param name="buffer"> The buffer the range was taken from, may change between calls in a frame. </param>
+		/// <param name="offset"> The offset of the range into the buffer. </param>
+		/// <returns> The mapped address of the range. </returns>
+		void *Allocate(const VkDeviceSize &size, VkBuffer &buffer, VkDeviceSize &offset);
+
+		/// <summary>
+		/// Takes ranges for a amount of instances, split into batches of at most <seealso cref="#BatchInstances"/>.
+		/// </summary>
+		/// <param name="stride"> The size of each instance in bytes. </param>
+		/// <param name="instances"> The amount of instances. </param>
+		/// <param name="batches"> The batches that were taken, cleared first. </param>
+		/// <param name="mapped"> The mapped address of each batch. </param>
+		void Allocate(const VkDeviceSize &stride, const uint32_t &instances, std::vector<Batch> &batches, std::vector<void *> &mapped);
+
+		/// <summary>
+		/// Starts a frame, must be called after the fence of the frame has been waited on.
+		/// </summary>
+		/// <param name="frame"> The index of the frame in flight. </param>
+		void BeginFrame(const uint32_t &frame);
+
+		/// <summary>
+		/// Ends a frame, must be called when the frames command buffer is submitted.
+		/// </summary>
+		/// <param name="frame"> The index of the frame in flight. </param>
+		void EndFrame(const uint32_t &frame);
+
+		VkDeviceSize GetSize() const;
+
+		/// <summary>
+		/// The starting size of the pool, it never shrinks below this.
+		/// </summary>
+		static const VkDeviceSize DefaultSize;
+
+		/// <summary>
+		/// The most instances drawn by a single batch.
+		/// </summary>
+		static const uint32_t BatchInstances;
+
+		/// <summary>
+		/// The amount of frames usage has to stay under a eighth of the pool before it halves.
+		/// </summary>
+		static const uint32_t ShrinkFrames;
+	private:
+		void Resize(const VkDeviceSize &size);
+
+		mutable std::mutex m_mutex;
+		std::unique_ptr<RingBuffer> m_ring;
+		std::vector<std::unique_ptr<RingBuffer>> m_retired;
+		VkDeviceSize m_frameUsage;
+		uint32_t m_lowFrames;
+	};
+}
@@ -0,0 +1,111 @@
+#include "RingBuffer.hpp"
+
+#include <algorithm>
+#include "Renderer/Renderer.hpp"
+
+namespace acid
+{
+	const VkDeviceSize RingBuffer::DefaultSize = 16 * 1024 * 1024;
+
+	RingBuffer::RingBuffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage) :
+		Buffer(size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+		m_alignment(std::max<VkDeviceSize>({Renderer::Get()->GetPhysicalDevice()->GetProperties().limits.minUniformBufferOffsetAlignment,
+			Renderer::Get()->GetPhysicalDevice()->GetProperties().limits.minStorageBufferOffsetAlignment, 16})),
+		m_head(0),
+		m_tail(0),
+		m_frameNumber(0)
+	{
+	}
+
+	void *RingBuffer::Allocate(const VkDeviceSize &size, VkDeviceSize &offset)
+	{
+		auto mapped = static_cast<char *>(m_allocation.GetMapped());
+
+		if (mapped == nullptr || size > m_size)
+		{
+			return nullptr;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		// Positions only ever increase, the buffer offset is the position wrapped around the size.
+		auto head = (m_head + m_alignment - 1) / m_alignment * m_alignment;
+
+		// A range can not be split over the end of the buffer, skip to the start instead.
+		if (head % m_size + size > m_size)
+		{
+			head += m_size - head % m_size;
+		}
+
+		if (head + size - m_tail > m_size)
+		{
+			return nullptr;
+		}
+
+		m_head = head + size;
+		offset = head % m_size;
+		return mapped + offset;
+	}
+
+	void RingBuffer::BeginFrame(const uint32_t &frame)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (frame >= m_frameEnds.size())
+		{
+			m_frameEnds.resize(frame + 1, 0);
+		}
+
+		// Frames complete in order, so everything before the end of this frames last submit is no longer read.
+		m_tail = std::max(m_tail, m_frameEnds[frame]);
+	}
+
+	void RingBuffer::EndFrame(const uint32_t &frame)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (frame >= m_frameEnds.size())
+		{
+			m_frameEnds.resize(frame + 1, 0);
+		}
+
+		m_frameEnds[frame] = m_head;
+		m_frameNumber++;
+	}
+
+	uint64_t RingBuffer::GetFrameNumber() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_frameNumber;
+	}
+
+	bool RingBuffer::IsIdle() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_tail == m_head;
+	}
+
+	WriteDescriptorSet RingBuffer::GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType,
+		const VkDescriptorSet &descriptorSet, const std::optional<OffsetSize> &offsetSize) const
+	{
+		VkDescriptorBufferInfo bufferInfo = {};
+		bufferInfo.buffer = m_buffer;
+		bufferInfo.offset = 0;
+		bufferInfo.range = m_size;
+
+		if (offsetSize)
+		{
+			bufferInfo.offset = offsetSize->GetOffset();
+			bufferInfo.range = offsetSize->GetSize();
+		}
+
+		VkWriteDescriptorSet descriptorWrite = {};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = descriptorSet;
+		descriptorWrite.dstBinding = binding;
+		descriptorWrite.dstArrayElement = 0;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.descriptorType = descriptorType;
+		return WriteDescriptorSet(descriptorWrite, bufferInfo);
+	}
+}
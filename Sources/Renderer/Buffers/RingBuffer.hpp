@@ -0,0 +1,76 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Renderer/Descriptors/Descriptor.hpp"
+#include "Buffer.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// A persistently mapped buffer that hands out short lived ranges for per frame uniform, storage, instance and indirect draw data.
+	/// Ranges are taken from a ring, space used by a frame is reused once the fence of that frame in flight has been waited on.
+	/// Uniform ranges are bound with dynamic offsets, so the descriptor set does not need to be rewritten when the offset moves.
+	/// </summary>
+	class ACID_EXPORT RingBuffer :
+		public Descriptor,
+		public Buffer
+	{
+	public:
+		explicit RingBuffer(const VkDeviceSize &size, const VkBufferUsageFlags &usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | 
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+
+		/// <summary>
+		/// Takes a range from the ring, the range is valid until the current frame is reused.
+		/// </summary>
+		/// <param name="size"> The size of the range in bytes. </param>
+		/// <param name="offset"> The offset of the range into the buffer, aligned to <seealso cref="#GetAlignment"/>. </param>
+		/// <returns> The mapped address of the range, or nullptr if the ring is full. </returns>
+		void *Allocate(const VkDeviceSize &size, VkDeviceSize &offset);
+
+		/// <summary>
+		/// Starts a frame, space used the last time this frame was in flight is released.
+		/// Must be called after the fence of the frame has been waited on.
+		/// </summary>
+		/// <param name="frame"> The index of the frame in flight. </param>
+		void BeginFrame(const uint32_t &frame);
+
+		/// <summary>
+		/// Ends a frame, everything allocated so far is owned by the frame until it comes around again.
+		/// Must be called when the frames command buffer is submitted.
+		/// </summary>
+		/// <param name="frame"> The index of the frame in flight. </param>
+		void EndFrame(const uint32_t &frame);
+
+		/// <summary>
+		/// Gets the count of frames ended, ranges taken with the same frame number are read by the same submit and can be shared.
+		/// </summary>
+		/// <returns> The frame number. </returns>
+		uint64_t GetFrameNumber() const;
+
+		/// <summary>
+		/// Gets if every range taken has been released, no frame in flight reads from the ring.
+		/// </summary>
+		/// <returns> If the ring is idle. </returns>
+		bool IsIdle() const;
+
+		const VkDeviceSize &GetAlignment() const { return m_alignment; }
+
+		WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType,
+			const VkDescriptorSet &descriptorSet, const std::optional<OffsetSize> &offsetSize) const override;
+
+		/// <summary>
+		/// The size of the renderers ring buffer.
+		/// </summary>
+		static const VkDeviceSize DefaultSize;
+	private:
+		VkDeviceSize m_alignment;
+
+		mutable std::mutex m_mutex;
+		uint64_t m_head;
+		uint64_t m_tail;
+		std::vector<uint64_t> m_frameEnds;
+		uint64_t m_frameNumber;
+	};
+}
@@ -5,20 +5,18 @@
 
 namespace acid
 {
-	StorageBuffer::StorageBuffer(const VkDeviceSize &size, const void *data) :
-		Buffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, data)
+	StorageBuffer::StorageBuffer(const VkDeviceSize &size, const void *data, const VkBufferUsageFlags &usage, const VkMemoryPropertyFlags &properties) :
+		Buffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | usage, properties, data)
 	{
 	}
 
 	void StorageBuffer::Update(const void *newData)
 	{
-		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
-
 		// Copies the data to the buffer.
 		void *data;
-		vkMapMemory(logicalDevice->GetLogicalDevice(), m_bufferMemory, 0, m_size, 0, &data);
+		Map(&data);
 		memcpy(data, newData, static_cast<std::size_t>(m_size));
-		vkUnmapMemory(logicalDevice->GetLogicalDevice(), m_bufferMemory);
+		Unmap();
 	}
 
 	VkDescriptorSetLayoutBinding StorageBuffer::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType,
@@ -11,7 +11,15 @@ namespace acid
 		public Buffer
 	{
 	public:
-		explicit StorageBuffer(const VkDeviceSize &size, const void *data = nullptr);
+		/// <summary>
+		/// Creates a new storage buffer.
+		/// </summary>
+		/// <param name="size"> The size of the buffer in bytes. </param>
+		/// <param name="data"> The initial data, only used with host visible memory. </param>
+		/// <param name="usage"> Usages added to storage and transfer destination, such as indirect draws. </param>
+		/// <param name="properties"> The memory properties, device local buffers are only written by the GPU and can not be updated from the host. </param>
+		explicit StorageBuffer(const VkDeviceSize &size, const void *data = nullptr, const VkBufferUsageFlags &usage = 0,
+			const VkMemoryPropertyFlags &properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
 		void Update(const void *newData);
 
@@ -5,16 +5,16 @@
 namespace acid
 {
 	CommandBuffer::CommandBuffer(const bool &begin, const VkQueueFlagBits &queueType, const VkCommandBufferLevel &bufferLevel) :
+		m_commandPool(Renderer::Get()->GetCommandPool()),
 		m_queueType(queueType),
 		m_commandBuffer(nullptr),
 		m_running(false)
 	{
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
-		auto commandPool = Renderer::Get()->GetCommandPool();
 
 		VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
 		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		commandBufferAllocateInfo.commandPool = commandPool;
+		commandBufferAllocateInfo.commandPool = m_commandPool->GetCommandPool();
 		commandBufferAllocateInfo.level = bufferLevel;
 		commandBufferAllocateInfo.commandBufferCount = 1;
 		Renderer::CheckVk(vkAllocateCommandBuffers(logicalDevice->GetLogicalDevice(), &commandBufferAllocateInfo, &m_commandBuffer));
@@ -28,9 +28,8 @@ namespace acid
 	CommandBuffer::~CommandBuffer()
 	{
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
-		auto commandPool = Renderer::Get()->GetCommandPool();
 
-		vkFreeCommandBuffers(logicalDevice->GetLogicalDevice(), commandPool, 1, &m_commandBuffer);
+		vkFreeCommandBuffers(logicalDevice->GetLogicalDevice(), m_commandPool->GetCommandPool(), 1, &m_commandBuffer);
 	}
 
 	void CommandBuffer::Begin(const VkCommandBufferUsageFlags &usage)
@@ -43,6 +42,17 @@ namespace acid
 		m_running = true;
 	}
 
+	void CommandBuffer::Begin(const VkCommandBufferInheritanceInfo &inheritanceInfo, const VkCommandBufferUsageFlags &usage)
+	{
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = usage;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+		Renderer::CheckVk(vkBeginCommandBuffer(m_commandBuffer, &beginInfo));
+
+		m_running = true;
+	}
+
 	void CommandBuffer::End()
 	{
 		Renderer::CheckVk(vkEndCommandBuffer(m_commandBuffer));
@@ -55,6 +65,9 @@ namespace acid
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 		auto queueSelected = GetQueue();
 
+		// Work waited on here may read pending uploads, and the compute queue does not see the order of graphics submissions.
+		Renderer::Get()->GetUploadManager()->Wait();
+
 		VkSubmitInfo submitInfo = {};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 		submitInfo.commandBufferCount = 1;
@@ -1,7 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <vulkan/vulkan.h>
-#include "Engine/Exports.hpp"
+#include "CommandPool.hpp"
 
 namespace acid
 {
@@ -9,7 +10,7 @@ namespace acid
 	{
 	public:
 		/// <summary>
-		/// Creates a new command buffer.
+		/// Creates a new command buffer from the command pool of the calling thread.
 		/// </summary>
 		/// <param name="begin"> If recording will start right away, if true <seealso cref="#Begin()"/> is called. </param>
 		/// <param name="queueType"> The queue to run this command buffer on. </param>
@@ -25,6 +26,14 @@ namespace acid
 		/// <param name="usage"> How this command buffer will be used. </param>
 		void Begin(const VkCommandBufferUsageFlags &usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
+		/// <summary>
+		/// Begins the recording state for this secondary command buffer, continuing a subpass of a primary command buffer.
+		/// </summary>
+		/// <param name="inheritanceInfo"> The renderpass, subpass and framebuffer the commands will be executed in. </param>
+		/// <param name="usage"> How this command buffer will be used. </param>
+		void Begin(const VkCommandBufferInheritanceInfo &inheritanceInfo, 
+			const VkCommandBufferUsageFlags &usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT);
+
 		/// <summary>
 		/// Ends the recording state for this command buffer.
 		/// </summary>
@@ -49,6 +58,7 @@ namespace acid
 	private:
 		VkQueue GetQueue() const;
 
+		std::shared_ptr<CommandPool> m_commandPool;
 		VkQueueFlagBits m_queueType;
 		VkCommandBuffer m_commandBuffer;
 		bool m_running;
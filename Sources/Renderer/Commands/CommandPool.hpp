@@ -0,0 +1,26 @@
+#pragma once
+
+#include <thread>
+#include <vulkan/vulkan.h>
+#include "Engine/Exports.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// A command pool owned by one thread, command buffers allocated from it must only be recorded on that thread.
+	/// </summary>
+	class ACID_EXPORT CommandPool
+	{
+	public:
+		explicit CommandPool(const std::thread::id &threadId = std::this_thread::get_id());
+
+		~CommandPool();
+
+		const VkCommandPool &GetCommandPool() const { return m_commandPool; }
+
+		const std::thread::id &GetThreadId() const { return m_threadId; }
+	private:
+		VkCommandPool m_commandPool;
+		std::thread::id m_threadId;
+	};
+}
@@ -37,9 +37,9 @@ namespace acid
 			0, nullptr);
 	}
 
-	void DescriptorSet::BindDescriptor(const CommandBuffer &commandBuffer)
+	void DescriptorSet::BindDescriptor(const CommandBuffer &commandBuffer, const std::vector<uint32_t> &dynamicOffsets)
 	{
 		vkCmdBindDescriptorSets(commandBuffer.GetCommandBuffer(), m_pipelineBindPoint, m_pipelineLayout, 0, 1, 
-			&m_descriptorSet, 0, nullptr);
+			&m_descriptorSet, static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
 	}
 }
@@ -18,7 +18,7 @@ namespace acid
 
 		void Update(const std::vector<VkWriteDescriptorSet> &descriptorWrites);
 
-		void BindDescriptor(const CommandBuffer &commandBuffer);
+		void BindDescriptor(const CommandBuffer &commandBuffer, const std::vector<uint32_t> &dynamicOffsets = {});
 
 		const VkDescriptorSet &GetDescriptorSet() const { return m_descriptorSet; }
 	private:
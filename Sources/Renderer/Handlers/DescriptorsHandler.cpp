@@ -81,7 +81,26 @@ namespace acid
 		}
 
 		uniformHandler.Update(m_shader->GetUniformBlock(descriptorName));
-		Push(descriptorName, uniformHandler.GetUniformBuffer(), offsetSize);
+
+		auto range = offsetSize ? *offsetSize : OffsetSize(0, uniformHandler.GetSize());
+		auto offset = static_cast<uint32_t>(uniformHandler.GetOffset());
+
+		// Pushed descriptors are written with every draw, so they can point straight at the current range.
+		if (m_pushDescriptors)
+		{
+			Push(descriptorName, Renderer::Get()->GetRingBuffer(), OffsetSize(offset + range.GetOffset(), range.GetSize()));
+			return;
+		}
+
+		// Otherwise the descriptor stays the same and the range is selected by a dynamic offset when binding.
+		Push(descriptorName, Renderer::Get()->GetRingBuffer(), range);
+
+		auto location = m_shader->GetDescriptorLocation(descriptorName);
+
+		if (location)
+		{
+			m_dynamicOffsets[*location] = offset;
+		}
 	}
 
 	void DescriptorsHandler::Push(const std::string &descriptorName, StorageHandler &storageHandler, const std::optional<OffsetSize> &offsetSize)
@@ -112,6 +131,7 @@ namespace acid
 			m_shader = pipeline.GetShaderProgram();
 			m_pushDescriptors = pipeline.IsPushDescriptors();
 			m_descriptors.clear();
+			m_dynamicOffsets.clear();
 
 			if (!m_pushDescriptors)
 			{
@@ -171,7 +191,19 @@ namespace acid
 		}
 		else
 		{
-			m_descriptorSet->BindDescriptor(commandBuffer);
+			// Every dynamic binding in the layout takes an offset, in binding order.
+			std::vector<uint32_t> dynamicOffsets;
+
+			for (const auto &descriptor : m_shader->GetDescriptorSetLayouts())
+			{
+				if (descriptor.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+				{
+					auto it = m_dynamicOffsets.find(descriptor.binding);
+					dynamicOffsets.emplace_back(it != m_dynamicOffsets.end() ? it->second : 0);
+				}
+			}
+
+			m_descriptorSet->BindDescriptor(commandBuffer, dynamicOffsets);
 		}
 	}
 }
@@ -49,6 +49,7 @@ namespace acid
 		const Shader *m_shader;
 		bool m_pushDescriptors;
 		std::map<std::string, DescriptorValue> m_descriptors;
+		std::map<uint32_t, uint32_t> m_dynamicOffsets;
 		std::vector<WriteDescriptorSet> m_writeDescriptors;
 		std::vector<VkWriteDescriptorSet> m_writeDescriptorSets;
 		std::unique_ptr<DescriptorSet> m_descriptorSet;
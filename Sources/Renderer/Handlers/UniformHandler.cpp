@@ -1,5 +1,7 @@
 #include "UniformHandler.hpp"
 
+#include "Renderer/Renderer.hpp"
+
 namespace acid
 {
 	UniformHandler::UniformHandler(const bool &multipipeline) :
@@ -7,7 +9,7 @@ namespace acid
 		m_uniformBlock(nullptr),
 		m_size(0),
 		m_data(nullptr),
-		m_uniformBuffer(nullptr),
+		m_offset(0),
 		m_handlerStatus(Buffer::Status::Normal)
 	{
 	}
@@ -17,13 +19,15 @@ namespace acid
 		m_uniformBlock(uniformBlock),
 		m_size(static_cast<uint32_t>(m_uniformBlock->GetSize())),
 		m_data(std::make_unique<char[]>(m_size)),
-		m_uniformBuffer(std::make_unique<UniformBuffer>(static_cast<VkDeviceSize>(m_size))),
+		m_offset(0),
 		m_handlerStatus(Buffer::Status::Normal)
 	{
 	}
 
 	bool UniformHandler::Update(const Shader::UniformBlock *uniformBlock)
 	{
+		bool reset = false;
+
 		if (m_handlerStatus == Buffer::Status::Reset || (m_multipipeline && m_uniformBlock == nullptr) || (!m_multipipeline && m_uniformBlock != uniformBlock))
 		{
 			if ((m_size == 0 && m_uniformBlock == nullptr) || (m_uniformBlock != nullptr && 
@@ -34,17 +38,28 @@ namespace acid
 
 			m_uniformBlock = uniformBlock;
 			m_data = std::make_unique<char[]>(m_size);
-			m_uniformBuffer = std::make_unique<UniformBuffer>(static_cast<VkDeviceSize>(m_size));
 			m_handlerStatus = Buffer::Status::Changed;
-			return false;
+			reset = true;
 		}
 
-		if (m_handlerStatus != Buffer::Status::Normal)
+		auto ringBuffer = Renderer::Get()->GetRingBuffer();
+
+		// A range is only kept for the frame it was taken in, so unchanged data is written again once per frame.
+		if (m_size != 0 && (m_handlerStatus != Buffer::Status::Normal || m_frameNumber != ringBuffer->GetFrameNumber()))
 		{
-			m_uniformBuffer->Update(m_data.get());
+			auto mapped = ringBuffer->Allocate(static_cast<VkDeviceSize>(m_size), m_offset);
+
+			if (mapped == nullptr)
+			{
+				Log::Error("Ring buffer is full, uniform block of size %i could not be written!\n", m_size);
+				return false;
+			}
+
+			memcpy(mapped, m_data.get(), static_cast<std::size_t>(m_size));
+			m_frameNumber = ringBuffer->GetFrameNumber();
 			m_handlerStatus = Buffer::Status::Normal;
 		}
 
-		return true;
+		return !reset;
 	}
 }
@@ -3,12 +3,13 @@
 #include <algorithm>
 #include <cstring>
 #include <memory>
-#include "Renderer/Buffers/UniformBuffer.hpp"
+#include <optional>
+#include "Renderer/Buffers/RingBuffer.hpp"
 
 namespace acid
 {
 	/// <summary>
-	/// Class that handles a uniform buffer.
+	/// Class that handles a uniform block, the block is written into a range of the renderers ring buffer.
 	/// </summary>
 	class ACID_EXPORT UniformHandler
 	{
@@ -54,13 +55,20 @@ namespace acid
 
 		bool Update(const Shader::UniformBlock *uniformBlock);
 
-		const UniformBuffer *GetUniformBuffer() const { return m_uniformBuffer.get(); }
+		/// <summary>
+		/// Gets the offset of the blocks range in the renderers ring buffer, valid for the frame of the last <seealso cref="#Update"/>.
+		/// </summary>
+		/// <returns> The offset in bytes. </returns>
+		const VkDeviceSize &GetOffset() const { return m_offset; }
+
+		const uint32_t &GetSize() const { return m_size; }
 	private:
 		bool m_multipipeline;
 		const Shader::UniformBlock *m_uniformBlock;
 		uint32_t m_size;
 		std::unique_ptr<char[]> m_data;
-		std::unique_ptr<UniformBuffer> m_uniformBuffer;
+		VkDeviceSize m_offset;
+		std::optional<uint64_t> m_frameNumber;
 		Buffer::Status m_handlerStatus;
 	};
 }
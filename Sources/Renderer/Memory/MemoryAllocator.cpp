@@ -0,0 +1,412 @@
+#include "MemoryAllocator.hpp"
+
+#include <algorithm>
+#include <set>
+#include "Renderer/Renderer.hpp"
+
+namespace acid
+{
+	const VkDeviceSize MemoryAllocator::BlockSize = 64 * 1024 * 1024;
+	const VkDeviceSize MemoryAllocator::MinAllocationSize = 256;
+	const uint32_t MemoryAllocator::EmptyFrameLimit = 300;
+
+	struct MemoryBlock
+	{
+		VkDeviceMemory m_memory;
+		VkDeviceSize m_size;
+		void *m_mapped;
+		uint32_t m_memoryType;
+		bool m_linear;
+		// The free offsets of each buddy level, level 0 is the whole block and each level halves the size.
+		std::vector<std::set<VkDeviceSize>> m_freeLists;
+		VkDeviceSize m_usedSize;
+		uint32_t m_allocationCount;
+		uint32_t m_emptyFrames;
+	};
+
+	static VkDeviceSize NextPowerOfTwo(const VkDeviceSize &value)
+	{
+		VkDeviceSize result = 1;
+
+		while (result < value)
+		{
+			result <<= 1;
+		}
+
+		return result;
+	}
+
+	static VkDeviceSize AlignUp(const VkDeviceSize &value, const VkDeviceSize &alignment)
+	{
+		return alignment == 0 ? value : (value + alignment - 1) / alignment * alignment;
+	}
+
+	MemoryAllocator::MemoryAllocator(const LogicalDevice *logicalDevice, const PhysicalDevice *physicalDevice) :
+		m_logicalDevice(logicalDevice),
+		m_physicalDevice(physicalDevice)
+	{
+		auto &memoryProperties = m_physicalDevice->GetMemoryProperties();
+
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+		{
+			// Blocks must be a power of two for the buddy split, small heaps are not filled by a single block.
+			auto heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size;
+			VkDeviceSize blockSize = BlockSize;
+
+			while (blockSize > MinAllocationSize && blockSize > heapSize / 8)
+			{
+				blockSize >>= 1;
+			}
+
+			m_blockSizes.emplace_back(blockSize);
+		}
+
+		m_blocks.resize(memoryProperties.memoryTypeCount);
+		m_dedicatedCounts.resize(memoryProperties.memoryTypeCount);
+		m_dedicatedSizes.resize(memoryProperties.memoryTypeCount);
+	}
+
+	MemoryAllocator::~MemoryAllocator()
+	{
+		for (auto &blocks : m_blocks)
+		{
+			for (auto &block : blocks)
+			{
+				FreeMemory(block->m_memory, block->m_mapped);
+			}
+		}
+	}
+
+	MemoryAllocation MemoryAllocator::Allocate(const VkMemoryRequirements &requirements, const VkMemoryPropertyFlags &properties, const bool &linear)
+	{
+		auto memoryType = FindMemoryType(requirements.memoryTypeBits, properties);
+		auto blockSize = m_blockSizes[memoryType];
+
+		// Buddy ranges are aligned to their own size, so rounding the size up to the alignment also aligns the offset.
+		auto size = NextPowerOfTwo(std::max({requirements.size, requirements.alignment, MinAllocationSize}));
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		MemoryAllocation allocation;
+		allocation.m_size = requirements.size;
+		allocation.m_memoryType = memoryType;
+
+		if (size > blockSize / 2)
+		{
+			allocation.m_memory = AllocateMemory(requirements.size, memoryType, &allocation.m_mapped);
+			m_dedicatedCounts[memoryType]++;
+			m_dedicatedSizes[memoryType] += requirements.size;
+			return allocation;
+		}
+
+		uint32_t level = 0;
+
+		while ((blockSize >> level) > size)
+		{
+			level++;
+		}
+
+		for (uint32_t attempt = 0; attempt < 2; attempt++)
+		{
+			for (auto &block : m_blocks[memoryType])
+			{
+				if (block->m_linear != linear)
+				{
+					continue;
+				}
+
+				// Finds the smallest free range that fits, then splits it down to the requested level.
+				auto found = static_cast<int32_t>(level);
+
+				while (found >= 0 && block->m_freeLists[found].empty())
+				{
+					found--;
+				}
+
+				if (found < 0)
+				{
+					continue;
+				}
+
+				auto offset = *block->m_freeLists[found].begin();
+				block->m_freeLists[found].erase(block->m_freeLists[found].begin());
+
+				for (auto split = static_cast<uint32_t>(found) + 1; split <= level; split++)
+				{
+					block->m_freeLists[split].emplace(offset + (blockSize >> split));
+				}
+
+				block->m_usedSize += size;
+				block->m_allocationCount++;
+				block->m_emptyFrames = 0;
+
+				allocation.m_memory = block->m_memory;
+				allocation.m_offset = offset;
+				allocation.m_mapped = block->m_mapped != nullptr ? static_cast<uint8_t *>(block->m_mapped) + offset : nullptr;
+				allocation.m_block = block.get();
+				allocation.m_level = level;
+				return allocation;
+			}
+
+			CreateBlock(memoryType, linear);
+		}
+
+		Log::Error("Failed to sub-allocate %i bytes from memory type %i\n", static_cast<int32_t>(size), memoryType);
+		return allocation;
+	}
+
+	void MemoryAllocator::Free(const MemoryAllocation &allocation)
+	{
+		if (!allocation.IsValid())
+		{
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (allocation.m_block == nullptr)
+		{
+			FreeMemory(allocation.m_memory, allocation.m_mapped);
+			m_dedicatedCounts[allocation.m_memoryType]--;
+			m_dedicatedSizes[allocation.m_memoryType] -= allocation.m_size;
+			return;
+		}
+
+		auto block = allocation.m_block;
+		auto offset = allocation.m_offset;
+		auto level = allocation.m_level;
+
+		block->m_usedSize -= block->m_size >> level;
+		block->m_allocationCount--;
+
+		// Merges with the buddy range while it is free.
+		while (level > 0)
+		{
+			auto buddy = offset ^ (block->m_size >> level);
+			auto it = block->m_freeLists[level].find(buddy);
+
+			if (it == block->m_freeLists[level].end())
+			{
+				break;
+			}
+
+			block->m_freeLists[level].erase(it);
+			offset = std::min(offset, buddy);
+			level--;
+		}
+
+		block->m_freeLists[level].emplace(offset);
+	}
+
+	void MemoryAllocator::Flush(const MemoryAllocation &allocation)
+	{
+		auto &memoryProperties = m_physicalDevice->GetMemoryProperties();
+
+		if (!allocation.IsValid() || memoryProperties.memoryTypes[allocation.m_memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+		{
+			return;
+		}
+
+		// Flushed ranges must be aligned to the atom size, neighbouring ranges being flushed as well is harmless.
+		auto atomSize = m_physicalDevice->GetProperties().limits.nonCoherentAtomSize;
+		auto start = allocation.m_offset / atomSize * atomSize;
+
+		VkMappedMemoryRange mappedMemoryRange = {};
+		mappedMemoryRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		mappedMemoryRange.memory = allocation.m_memory;
+		mappedMemoryRange.offset = start;
+		mappedMemoryRange.size = AlignUp(allocation.m_offset + allocation.m_size - start, atomSize);
+
+		if (allocation.m_block != nullptr)
+		{
+			mappedMemoryRange.size = std::min(mappedMemoryRange.size, allocation.m_block->m_size - start);
+		}
+		else
+		{
+			mappedMemoryRange.size = VK_WHOLE_SIZE;
+		}
+
+		Renderer::CheckVk(vkFlushMappedMemoryRanges(m_logicalDevice->GetLogicalDevice(), 1, &mappedMemoryRange));
+	}
+
+	void MemoryAllocator::BeginFrame()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		for (auto &blocks : m_blocks)
+		{
+			for (auto &block : blocks)
+			{
+				if (block->m_allocationCount == 0)
+				{
+					block->m_emptyFrames++;
+				}
+			}
+		}
+
+		ReleaseEmptyBlocks(EmptyFrameLimit);
+	}
+
+	void MemoryAllocator::Defragment()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		ReleaseEmptyBlocks(0);
+	}
+
+	MemoryAllocator::Stats MemoryAllocator::GetStats() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		Stats result;
+
+		for (uint32_t i = 0; i < m_blocks.size(); i++)
+		{
+			auto stats = GetBlockStats(i);
+			result.m_blockCount += stats.m_blockCount;
+			result.m_allocationCount += stats.m_allocationCount;
+			result.m_dedicatedCount += stats.m_dedicatedCount;
+			result.m_reservedSize += stats.m_reservedSize;
+			result.m_usedSize += stats.m_usedSize;
+			result.m_largestFree = std::max(result.m_largestFree, stats.m_largestFree);
+		}
+
+		return result;
+	}
+
+	MemoryAllocator::Stats MemoryAllocator::GetStats(const uint32_t &memoryType) const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return GetBlockStats(memoryType);
+	}
+
+	uint32_t MemoryAllocator::FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties) const
+	{
+		auto &memoryProperties = m_physicalDevice->GetMemoryProperties();
+
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+		{
+			uint32_t memoryTypeBits = 1 << i;
+
+			if (typeFilter & memoryTypeBits && (memoryProperties.memoryTypes[i].propertyFlags & requiredProperties) == requiredProperties)
+			{
+				return i;
+			}
+		}
+
+		Log::Error("Failed to find a valid memory type!\n");
+		return 0;
+	}
+
+	VkDeviceMemory MemoryAllocator::AllocateMemory(const VkDeviceSize &size, const uint32_t &memoryType, void **mapped)
+	{
+		auto &memoryProperties = m_physicalDevice->GetMemoryProperties();
+
+		VkMemoryAllocateInfo memoryAllocateInfo = {};
+		memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		memoryAllocateInfo.allocationSize = size;
+		memoryAllocateInfo.memoryTypeIndex = memoryType;
+
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		Renderer::CheckVk(vkAllocateMemory(m_logicalDevice->GetLogicalDevice(), &memoryAllocateInfo, nullptr, &memory));
+
+		*mapped = nullptr;
+
+		// A memory object can only be mapped once, so host visible memory is kept mapped and shared by every allocation in it.
+		if (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		{
+			Renderer::CheckVk(vkMapMemory(m_logicalDevice->GetLogicalDevice(), memory, 0, VK_WHOLE_SIZE, 0, mapped));
+		}
+
+		return memory;
+	}
+
+	void MemoryAllocator::FreeMemory(const VkDeviceMemory &memory, void *mapped)
+	{
+		if (mapped != nullptr)
+		{
+			vkUnmapMemory(m_logicalDevice->GetLogicalDevice(), memory);
+		}
+
+		vkFreeMemory(m_logicalDevice->GetLogicalDevice(), memory, nullptr);
+	}
+
+	MemoryBlock *MemoryAllocator::CreateBlock(const uint32_t &memoryType, const bool &linear)
+	{
+		auto blockSize = m_blockSizes[memoryType];
+		uint32_t levels = 1;
+
+		while ((blockSize >> (levels - 1)) > MinAllocationSize)
+		{
+			levels++;
+		}
+
+		auto block = std::make_unique<MemoryBlock>();
+		block->m_size = blockSize;
+		block->m_memoryType = memoryType;
+		block->m_linear = linear;
+		block->m_freeLists.resize(levels);
+		block->m_freeLists[0].emplace(0);
+		block->m_usedSize = 0;
+		block->m_allocationCount = 0;
+		block->m_emptyFrames = 0;
+		block->m_memory = AllocateMemory(blockSize, memoryType, &block->m_mapped);
+		return m_blocks[memoryType].emplace_back(std::move(block)).get();
+	}
+
+	void MemoryAllocator::ReleaseEmptyBlocks(const uint32_t &frameLimit)
+	{
+		for (auto &blocks : m_blocks)
+		{
+			// The first empty block of a type is kept, so a allocation pattern that frees and allocates does not reallocate device memory.
+			bool keptEmpty = false;
+
+			for (auto it = blocks.begin(); it != blocks.end();)
+			{
+				auto &block = *it;
+
+				if (block->m_allocationCount != 0)
+				{
+					++it;
+					continue;
+				}
+
+				if (!keptEmpty || block->m_emptyFrames < frameLimit)
+				{
+					keptEmpty = true;
+					++it;
+					continue;
+				}
+
+				FreeMemory(block->m_memory, block->m_mapped);
+				it = blocks.erase(it);
+			}
+		}
+	}
+
+	MemoryAllocator::Stats MemoryAllocator::GetBlockStats(const uint32_t &memoryType) const
+	{
+		Stats result;
+		result.m_dedicatedCount = m_dedicatedCounts[memoryType];
+		result.m_allocationCount = m_dedicatedCounts[memoryType];
+		result.m_reservedSize = m_dedicatedSizes[memoryType];
+		result.m_usedSize = m_dedicatedSizes[memoryType];
+
+		for (const auto &block : m_blocks[memoryType])
+		{
+			result.m_blockCount++;
+			result.m_allocationCount += block->m_allocationCount;
+			result.m_reservedSize += block->m_size;
+			result.m_usedSize += block->m_usedSize;
+
+			for (uint32_t level = 0; level < block->m_freeLists.size(); level++)
+			{
+				if (!block->m_freeLists[level].empty())
+				{
+					result.m_largestFree = std::max(result.m_largestFree, block->m_size >> level);
+					break;
+				}
+			}
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Helpers/NonCopyable.hpp"
+#include "Engine/Exports.hpp"
+
+namespace acid
+{
+	class LogicalDevice;
+	class PhysicalDevice;
+	struct MemoryBlock;
+
+	/// <summary>
+	/// A range of device memory handed out by a <seealso cref="MemoryAllocator"/>, resources are bound at its offset into the shared memory object.
+	/// </summary>
+	class ACID_EXPORT MemoryAllocation
+	{
+	public:
+		MemoryAllocation() = default;
+
+		const VkDeviceMemory &GetMemory() const { return m_memory; }
+
+		const VkDeviceSize &GetOffset() const { return m_offset; }
+
+		const VkDeviceSize &GetSize() const { return m_size; }
+
+		/// <summary>
+		/// Gets the host address of this allocation, host visible memory stays mapped for its whole lifetime.
+		/// </summary>
+		/// <returns> The mapped address, or nullptr if the memory is not host visible. </returns>
+		void *GetMapped() const { return m_mapped; }
+
+		const uint32_t &GetMemoryType() const { return m_memoryType; }
+
+		bool IsValid() const { return m_memory != VK_NULL_HANDLE; }
+	private:
+		friend class MemoryAllocator;
+
+		VkDeviceMemory m_memory = VK_NULL_HANDLE;
+		VkDeviceSize m_offset = 0;
+		VkDeviceSize m_size = 0;
+		void *m_mapped = nullptr;
+		uint32_t m_memoryType = 0;
+		MemoryBlock *m_block = nullptr;
+		uint32_t m_level = 0;
+	};
+
+	/// <summary>
+	/// Sub-allocates device memory from large blocks kept per memory type, instead of one device allocation per resource.
+	/// Blocks are split with a buddy allocator, linear resources (buffers, linear images) and optimal images use separate blocks so they never share a granularity page.
+	/// Allocations larger than half a block get their own device allocation.
+	/// </summary>
+	class ACID_EXPORT MemoryAllocator :
+		public NonCopyable
+	{
+	public:
+		/// <summary>
+		/// Memory usage of the allocator.
+		/// </summary>
+		struct Stats
+		{
+			uint32_t m_blockCount = 0;
+			uint32_t m_allocationCount = 0;
+			uint32_t m_dedicatedCount = 0;
+			VkDeviceSize m_reservedSize = 0;
+			VkDeviceSize m_usedSize = 0;
+			VkDeviceSize m_largestFree = 0;
+		};
+
+		MemoryAllocator(const LogicalDevice *logicalDevice, const PhysicalDevice *physicalDevice);
+
+		~MemoryAllocator();
+
+		/// <summary>
+		/// Allocates memory for a resource.
+		/// </summary>
+		/// <param name="requirements"> The memory requirements of the resource. </param>
+		/// <param name="properties"> The required memory properties. </param>
+		/// <param name="linear"> If the resource is a buffer or a linearly tiled image. </param>
+		/// <returns> The allocation, must be passed to <seealso cref="#Free"/>. </returns>
+		MemoryAllocation Allocate(const VkMemoryRequirements &requirements, const VkMemoryPropertyFlags &properties, const bool &linear = true);
+
+		/// <summary>
+		/// Returns a allocation to its block, and merges it with its free neighbours.
+		/// </summary>
+		/// <param name="allocation"> The allocation to free. </param>
+		void Free(const MemoryAllocation &allocation);
+
+		/// <summary>
+		/// Flushes host writes to a allocation, only needed if the memory is not host coherent.
+		/// </summary>
+		/// <param name="allocation"> The allocation to flush. </param>
+		void Flush(const MemoryAllocation &allocation);
+
+		/// <summary>
+		/// Starts a frame, blocks that have been empty for a while are released.
+		/// </summary>
+		void BeginFrame();
+
+		/// <summary>
+		/// Releases every empty block, keeping one block per memory type.
+		/// </summary>
+		void Defragment();
+
+		/// <summary>
+		/// Gets the usage of all memory types.
+		/// </summary>
+		/// <returns> The stats. </returns>
+		Stats GetStats() const;
+
+		/// <summary>
+		/// Gets the usage of a memory type.
+		/// </summary>
+		/// <param name="memoryType"> The memory type index. </param>
+		/// <returns> The stats. </returns>
+		Stats GetStats(const uint32_t &memoryType) const;
+
+		/// <summary>
+		/// Finds a memory type that matches a filter and has all required properties.
+		/// </summary>
+		/// <param name="typeFilter"> The bits of the allowed memory types. </param>
+		/// <param name="requiredProperties"> The required memory properties. </param>
+		/// <returns> The memory type index. </returns>
+		uint32_t FindMemoryType(const uint32_t &typeFilter, const VkMemoryPropertyFlags &requiredProperties) const;
+
+		/// <summary>
+		/// The largest size of a block, smaller heaps use an eighth of the heap.
+		/// </summary>
+		static const VkDeviceSize BlockSize;
+
+		/// <summary>
+		/// The smallest range handed out from a block.
+		/// </summary>
+		static const VkDeviceSize MinAllocationSize;
+
+		/// <summary>
+		/// The amount of frames a block stays empty before it is released.
+		/// </summary>
+		static const uint32_t EmptyFrameLimit;
+	private:
+		VkDeviceMemory AllocateMemory(const VkDeviceSize &size, const uint32_t &memoryType, void **mapped);
+
+		void FreeMemory(const VkDeviceMemory &memory, void *mapped);
+
+		MemoryBlock *CreateBlock(const uint32_t &memoryType, const bool &linear);
+
+		void ReleaseEmptyBlocks(const uint32_t &frameLimit);
+
+		Stats GetBlockStats(const uint32_t &memoryType) const;
+
+		const LogicalDevice *m_logicalDevice;
+		const PhysicalDevice *m_physicalDevice;
+
+		mutable std::mutex m_mutex;
+		std::vector<VkDeviceSize> m_blockSizes;
+		std::vector<std::vector<std::unique_ptr<MemoryBlock>>> m_blocks;
+		std::vector<uint32_t> m_dedicatedCounts;
+		std::vector<VkDeviceSize> m_dedicatedSizes;
+	};
+}
@@ -0,0 +1,341 @@
+#include "UploadManager.hpp"
+
+#include <cstring>
+#include <limits>
+#include "Renderer/Renderer.hpp"
+#include "Textures/Texture.hpp"
+
+namespace acid
+{
+	const VkDeviceSize UploadManager::StagingSize = 8 * 1024 * 1024;
+
+	// Covers the texel size of every uncompressed format, buffer to image copies must start on a texel.
+	static const VkDeviceSize STAGING_ALIGNMENT = 16;
+
+	UploadManager::UploadManager(const LogicalDevice *logicalDevice) :
+		m_logicalDevice(logicalDevice),
+		m_transferFamily(logicalDevice->GetTransferFamily()),
+		m_graphicsFamily(logicalDevice->GetGraphicsFamily()),
+		m_transferPool(VK_NULL_HANDLE),
+		m_graphicsPool(VK_NULL_HANDLE),
+		m_batchIndex(0)
+	{
+		VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		commandPoolCreateInfo.queueFamilyIndex = m_graphicsFamily;
+		Renderer::CheckVk(vkCreateCommandPool(m_logicalDevice->GetLogicalDevice(), &commandPoolCreateInfo, nullptr, &m_graphicsPool));
+
+		if (IsDedicatedTransfer())
+		{
+			commandPoolCreateInfo.queueFamilyIndex = m_transferFamily;
+			Renderer::CheckVk(vkCreateCommandPool(m_logicalDevice->GetLogicalDevice(), &commandPoolCreateInfo, nullptr, &m_transferPool));
+		}
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo = {};
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		VkFenceCreateInfo fenceCreateInfo = {};
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		for (auto &batch : m_batches)
+		{
+			VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
+			commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			commandBufferAllocateInfo.commandPool = m_graphicsPool;
+			commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			commandBufferAllocateInfo.commandBufferCount = 1;
+			Renderer::CheckVk(vkAllocateCommandBuffers(m_logicalDevice->GetLogicalDevice(), &commandBufferAllocateInfo, &batch.m_graphicsBuffer));
+
+			if (IsDedicatedTransfer())
+			{
+				commandBufferAllocateInfo.commandPool = m_transferPool;
+				Renderer::CheckVk(vkAllocateCommandBuffers(m_logicalDevice->GetLogicalDevice(), &commandBufferAllocateInfo, &batch.m_transferBuffer));
+				Renderer::CheckVk(vkCreateSemaphore(m_logicalDevice->GetLogicalDevice(), &semaphoreCreateInfo, nullptr, &batch.m_semaphore));
+			}
+
+			Renderer::CheckVk(vkCreateFence(m_logicalDevice->GetLogicalDevice(), &fenceCreateInfo, nullptr, &batch.m_fence));
+		}
+	}
+
+	UploadManager::~UploadManager()
+	{
+		for (auto &batch : m_batches)
+		{
+			if (batch.m_submitted)
+			{
+				WaitBatch(batch);
+			}
+
+			vkDestroyFence(m_logicalDevice->GetLogicalDevice(), batch.m_fence, nullptr);
+			vkDestroySemaphore(m_logicalDevice->GetLogicalDevice(), batch.m_semaphore, nullptr);
+		}
+
+		vkDestroyCommandPool(m_logicalDevice->GetLogicalDevice(), m_transferPool, nullptr);
+		vkDestroyCommandPool(m_logicalDevice->GetLogicalDevice(), m_graphicsPool, nullptr);
+	}
+
+	void UploadManager::UploadBuffer(const VkBuffer &buffer, const void *data, const VkDeviceSize &size, const VkDeviceSize &offset)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto &batch = BeginBatch();
+
+		VkDeviceSize stagingOffset;
+		auto &stagingBuffer = AllocateStaging(batch, data, size, stagingOffset);
+
+		VkBufferCopy copyRegion = {};
+		copyRegion.srcOffset = stagingOffset;
+		copyRegion.dstOffset = offset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(GetCopyBuffer(batch), stagingBuffer.GetBuffer(), buffer, 1, &copyRegion);
+
+		if (!IsDedicatedTransfer())
+		{
+			// Made visible by the memory barrier recorded when the batch is submitted.
+			return;
+		}
+
+		VkBufferMemoryBarrier bufferMemoryBarrier = {};
+		bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		bufferMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		bufferMemoryBarrier.dstAccessMask = 0;
+		bufferMemoryBarrier.srcQueueFamilyIndex = m_transferFamily;
+		bufferMemoryBarrier.dstQueueFamilyIndex = m_graphicsFamily;
+		bufferMemoryBarrier.buffer = buffer;
+		bufferMemoryBarrier.offset = offset;
+		bufferMemoryBarrier.size = size;
+		vkCmdPipelineBarrier(batch.m_transferBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &bufferMemoryBarrier, 0, nullptr);
+
+		// Acquires ownership on the graphics queue, after it has waited on the batches semaphore.
+		bufferMemoryBarrier.srcAccessMask = 0;
+		bufferMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+		vkCmdPipelineBarrier(batch.m_graphicsBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 1, &bufferMemoryBarrier, 0, nullptr);
+	}
+
+	void UploadManager::UploadImage(const VkImage &image, const VkFormat &format, const void *pixels, const VkDeviceSize &size, const uint32_t &width, const uint32_t &height,
+		const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount, const VkImageLayout &dstImageLayout)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto &batch = BeginBatch();
+
+		if (pixels == nullptr)
+		{
+			Texture::TransitionImageLayout(batch.m_graphicsBuffer, image, format, VK_IMAGE_LAYOUT_UNDEFINED, dstImageLayout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, baseArrayLayer, layerCount);
+			return;
+		}
+
+		VkDeviceSize stagingOffset;
+		auto &stagingBuffer = AllocateStaging(batch, pixels, size, stagingOffset);
+		auto copyBuffer = GetCopyBuffer(batch);
+
+		Texture::TransitionImageLayout(copyBuffer, image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, baseArrayLayer, layerCount);
+		Texture::CopyBufferToImage(copyBuffer, stagingBuffer.GetBuffer(), image, width, height, baseArrayLayer, layerCount, stagingOffset);
+
+		if (IsDedicatedTransfer())
+		{
+			// Ownership moves to the graphics queue, the layout stays the same as blits and transitions are graphics work.
+			VkImageMemoryBarrier imageMemoryBarrier = {};
+			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			imageMemoryBarrier.dstAccessMask = 0;
+			imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			imageMemoryBarrier.srcQueueFamilyIndex = m_transferFamily;
+			imageMemoryBarrier.dstQueueFamilyIndex = m_graphicsFamily;
+			imageMemoryBarrier.image = image;
+			imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+			imageMemoryBarrier.subresourceRange.levelCount = mipLevels;
+			imageMemoryBarrier.subresourceRange.baseArrayLayer = baseArrayLayer;
+			imageMemoryBarrier.subresourceRange.layerCount = layerCount;
+			vkCmdPipelineBarrier(batch.m_transferBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+
+			imageMemoryBarrier.srcAccessMask = 0;
+			imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+			vkCmdPipelineBarrier(batch.m_graphicsBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+		}
+
+		if (mipLevels > 1)
+		{
+			Texture::CreateMipmaps(batch.m_graphicsBuffer, image, width, height, dstImageLayout, mipLevels, baseArrayLayer, layerCount);
+		}
+		else
+		{
+			Texture::TransitionImageLayout(batch.m_graphicsBuffer, image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, dstImageLayout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, baseArrayLayer, layerCount);
+		}
+	}
+
+	void UploadManager::TransitionImage(const VkImage &image, const VkFormat &format, const VkImageLayout &srcImageLayout, const VkImageLayout &dstImageLayout,
+		const VkImageAspectFlags &aspectMask, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto &batch = BeginBatch();
+
+		Texture::TransitionImageLayout(batch.m_graphicsBuffer, image, format, srcImageLayout, dstImageLayout, aspectMask, mipLevels, baseArrayLayer, layerCount);
+	}
+
+	void UploadManager::Flush()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		SubmitBatch();
+	}
+
+	void UploadManager::Wait()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		SubmitBatch();
+
+		for (auto &batch : m_batches)
+		{
+			if (batch.m_submitted)
+			{
+				WaitBatch(batch);
+			}
+		}
+	}
+
+	UploadManager::Batch &UploadManager::BeginBatch()
+	{
+		auto &batch = m_batches[m_batchIndex];
+
+		if (batch.m_recording)
+		{
+			return batch;
+		}
+
+		if (batch.m_submitted)
+		{
+			WaitBatch(batch);
+		}
+
+		VkCommandBufferBeginInfo beginInfo = {};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		Renderer::CheckVk(vkBeginCommandBuffer(batch.m_graphicsBuffer, &beginInfo));
+
+		if (IsDedicatedTransfer())
+		{
+			Renderer::CheckVk(vkBeginCommandBuffer(batch.m_transferBuffer, &beginInfo));
+		}
+
+		batch.m_recording = true;
+		batch.m_transferUsed = false;
+		return batch;
+	}
+
+	const Buffer &UploadManager::AllocateStaging(Batch &batch, const void *data, const VkDeviceSize &size, VkDeviceSize &offset)
+	{
+		Buffer *stagingBuffer;
+
+		if (size > StagingSize)
+		{
+			batch.m_dedicatedBuffers.emplace_back(std::make_unique<Buffer>(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+			stagingBuffer = batch.m_dedicatedBuffers.back().get();
+			offset = 0;
+		}
+		else
+		{
+			offset = (batch.m_stagingOffset + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+
+			if (batch.m_stagingBuffers.empty() || offset + size > StagingSize)
+			{
+				batch.m_stagingBuffers.emplace_back(std::make_unique<Buffer>(StagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+					VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+				offset = 0;
+			}
+
+			stagingBuffer = batch.m_stagingBuffers.back().get();
+			batch.m_stagingOffset = offset + size;
+		}
+
+		void *mapped;
+		stagingBuffer->Map(&mapped);
+		memcpy(static_cast<uint8_t *>(mapped) + offset, data, size);
+		stagingBuffer->Unmap();
+		return *stagingBuffer;
+	}
+
+	VkCommandBuffer UploadManager::GetCopyBuffer(Batch &batch) const
+	{
+		if (!IsDedicatedTransfer())
+		{
+			return batch.m_graphicsBuffer;
+		}
+
+		batch.m_transferUsed = true;
+		return batch.m_transferBuffer;
+	}
+
+	void UploadManager::SubmitBatch()
+	{
+		auto &batch = m_batches[m_batchIndex];
+
+		if (!batch.m_recording)
+		{
+			return;
+		}
+
+		std::vector<VkSemaphore> waitSemaphores;
+		std::vector<VkPipelineStageFlags> waitStages;
+
+		if (IsDedicatedTransfer())
+		{
+			Renderer::CheckVk(vkEndCommandBuffer(batch.m_transferBuffer));
+
+			if (batch.m_transferUsed)
+			{
+				VkSubmitInfo submitInfo = {};
+				submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+				submitInfo.commandBufferCount = 1;
+				submitInfo.pCommandBuffers = &batch.m_transferBuffer;
+				submitInfo.signalSemaphoreCount = 1;
+				submitInfo.pSignalSemaphores = &batch.m_semaphore;
+				Renderer::CheckVk(vkQueueSubmit(m_logicalDevice->GetTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE));
+
+				waitSemaphores.emplace_back(batch.m_semaphore);
+				waitStages.emplace_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+			}
+		}
+		else
+		{
+			// Copies recorded on the graphics queue are made visible to everything submitted after the batch.
+			VkMemoryBarrier memoryBarrier = {};
+			memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+			vkCmdPipelineBarrier(batch.m_graphicsBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+		}
+
+		Renderer::CheckVk(vkEndCommandBuffer(batch.m_graphicsBuffer));
+
+		VkSubmitInfo submitInfo = {};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+		submitInfo.pWaitSemaphores = waitSemaphores.data();
+		submitInfo.pWaitDstStageMask = waitStages.data();
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &batch.m_graphicsBuffer;
+		Renderer::CheckVk(vkQueueSubmit(m_logicalDevice->GetGraphicsQueue(), 1, &submitInfo, batch.m_fence));
+
+		batch.m_recording = false;
+		batch.m_submitted = true;
+		m_batchIndex = (m_batchIndex + 1) % m_batches.size();
+	}
+
+	void UploadManager::WaitBatch(Batch &batch)
+	{
+		Renderer::CheckVk(vkWaitForFences(m_logicalDevice->GetLogicalDevice(), 1, &batch.m_fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+		Renderer::CheckVk(vkResetFences(m_logicalDevice->GetLogicalDevice(), 1, &batch.m_fence));
+
+		// One staging chunk is kept for the next batch, the rest were only needed for a burst of loading.
+		if (batch.m_stagingBuffers.size() > 1)
+		{
+			batch.m_stagingBuffers.resize(1);
+		}
+
+		batch.m_dedicatedBuffers.clear();
+		batch.m_stagingOffset = 0;
+		batch.m_submitted = false;
+	}
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include "Helpers/NonCopyable.hpp"
+#include "Renderer/Buffers/Buffer.hpp"
+
+namespace acid
+{
+	class LogicalDevice;
+
+	/// <summary>
+	/// Batches resource uploads into a few submissions, instead of a blocking submit per copy.
+	/// Copies are recorded on the transfer queue when the device has a dedicated transfer family, ownership is then released to the graphics queue,
+	/// which waits on a semaphore and finishes the upload (mipmaps and layout transitions). Staging memory is taken linearly from chunks owned by each batch,
+	/// and recycled once the batches fence has signalled.
+	/// </summary>
+	class ACID_EXPORT UploadManager :
+		public NonCopyable
+	{
+	public:
+		explicit UploadManager(const LogicalDevice *logicalDevice);
+
+		~UploadManager();
+
+		/// <summary>
+		/// Records a copy of data into a device local buffer.
+		/// </summary>
+		/// <param name="buffer"> The destination buffer, must have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT. </param>
+		/// <param name="data"> The data to copy, it is copied into staging memory before returning. </param>
+		/// <param name="size"> The size of the data in bytes. </param>
+		/// <param name="offset"> The offset into the destination buffer. </param>
+		void UploadBuffer(const VkBuffer &buffer, const void *data, const VkDeviceSize &size, const VkDeviceSize &offset = 0);
+
+		/// <summary>
+		/// Records a copy of pixels into a image, then generates mipmaps and transitions the image into its final layout.
+		/// </summary>
+		/// <param name="image"> The destination image, starting in a undefined layout. </param>
+		/// <param name="format"> The format of the image. </param>
+		/// <param name="pixels"> The pixels of every layer, if nullptr the image is only transitioned. </param>
+		/// <param name="size"> The size of the pixels in bytes. </param>
+		/// <param name="width"> The width of the image. </param>
+		/// <param name="height"> The height of the image. </param>
+		/// <param name="mipLevels"> The mip levels of the image, levels past the first are blitted from it. </param>
+		/// <param name="baseArrayLayer"> The first layer to write. </param>
+		/// <param name="layerCount"> The amount of layers to write. </param>
+		/// <param name="dstImageLayout"> The layout the image is left in. </param>
+		void UploadImage(const VkImage &image, const VkFormat &format, const void *pixels, const VkDeviceSize &size, const uint32_t &width, const uint32_t &height,
+			const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount, const VkImageLayout &dstImageLayout);
+
+		/// <summary>
+		/// Records a image layout transition in the current batch.
+		/// </summary>
+		void TransitionImage(const VkImage &image, const VkFormat &format, const VkImageLayout &srcImageLayout, const VkImageLayout &dstImageLayout,
+			const VkImageAspectFlags &aspectMask, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount);
+
+		/// <summary>
+		/// Submits the recorded uploads without waiting for them. Work submitted to the graphics queue afterwards sees the uploaded data.
+		/// </summary>
+		void Flush();
+
+		/// <summary>
+		/// Submits the recorded uploads and waits for every submitted batch to complete.
+		/// </summary>
+		void Wait();
+
+		/// <summary>
+		/// The size of each staging chunk, larger uploads get a dedicated staging buffer.
+		/// </summary>
+		static const VkDeviceSize StagingSize;
+	private:
+		struct Batch
+		{
+			VkCommandBuffer m_transferBuffer = VK_NULL_HANDLE;
+			VkCommandBuffer m_graphicsBuffer = VK_NULL_HANDLE;
+			VkSemaphore m_semaphore = VK_NULL_HANDLE;
+			VkFence m_fence = VK_NULL_HANDLE;
+			std::vector<std::unique_ptr<Buffer>> m_stagingBuffers;
+			std::vector<std::unique_ptr<Buffer>> m_dedicatedBuffers;
+			VkDeviceSize m_stagingOffset = 0;
+			bool m_recording = false;
+			bool m_transferUsed = false;
+			bool m_submitted = false;
+		};
+
+		Batch &BeginBatch();
+
+		const Buffer &AllocateStaging(Batch &batch, const void *data, const VkDeviceSize &size, VkDeviceSize &offset);
+
+		VkCommandBuffer GetCopyBuffer(Batch &batch) const;
+
+		void SubmitBatch();
+
+		void WaitBatch(Batch &batch);
+
+		bool IsDedicatedTransfer() const { return m_transferFamily != m_graphicsFamily; }
+
+		const LogicalDevice *m_logicalDevice;
+		uint32_t m_transferFamily;
+		uint32_t m_graphicsFamily;
+		VkCommandPool m_transferPool;
+		VkCommandPool m_graphicsPool;
+
+		std::mutex m_mutex;
+		std::array<Batch, 3> m_batches;
+		std::size_t m_batchIndex;
+	};
+}
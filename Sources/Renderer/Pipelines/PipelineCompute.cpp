@@ -9,13 +9,14 @@
 namespace acid
 {
 	PipelineCompute::PipelineCompute(std::string shaderStage, const uint32_t &width, const uint32_t &height, const uint32_t &workgroupSize, 
-		const bool &pushDescriptors, std::vector<Shader::Define> defines) :
+		const bool &pushDescriptors, std::vector<Shader::Define> defines, const uint32_t &descriptorSets) :
 		m_shaderStage(std::move(shaderStage)),
 		m_width(width),
 		m_height(height),
 		m_workgroupSize(workgroupSize),
 		m_pushDescriptors(pushDescriptors),
 		m_defines(std::move(defines)),
+		m_descriptorSets(descriptorSets),
 		m_shader(std::make_unique<Shader>(m_shaderStage)),
 		m_shaderModule(VK_NULL_HANDLE),
 		m_shaderStageCreateInfo({}),
@@ -60,8 +61,18 @@ namespace acid
 
 	bool PipelineCompute::CmdRender(const CommandBuffer &commandBuffer) const
 	{
-		auto groupCountX = static_cast<uint32_t>(std::ceil(static_cast<float>(m_width) / static_cast<float>(m_workgroupSize)));
-		auto groupCountY = static_cast<uint32_t>(std::ceil(static_cast<float>(m_height) / static_cast<float>(m_workgroupSize)));
+		return CmdRender(commandBuffer, m_width, m_height);
+	}
+
+	bool PipelineCompute::CmdRender(const CommandBuffer &commandBuffer, const uint32_t &width, const uint32_t &height) const
+	{
+		if (width == 0 || height == 0)
+		{
+			return false;
+		}
+
+		auto groupCountX = static_cast<uint32_t>(std::ceil(static_cast<float>(width) / static_cast<float>(m_workgroupSize)));
+		auto groupCountY = static_cast<uint32_t>(std::ceil(static_cast<float>(height) / static_cast<float>(m_workgroupSize)));
 		vkCmdDispatch(commandBuffer.GetCommandBuffer(), groupCountX, groupCountY, 1);
 		return true;
 	}
@@ -119,10 +130,16 @@ namespace acid
 
 		auto descriptorPools = m_shader->GetDescriptorPools();
 
+		// Leaves room for the descriptors of every set the pipeline may allocate.
+		for (auto &descriptorPool : descriptorPools)
+		{
+			descriptorPool.descriptorCount *= m_descriptorSets;
+		}
+
 		VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
 		descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 		descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-		descriptorPoolCreateInfo.maxSets = 16384;
+		descriptorPoolCreateInfo.maxSets = m_descriptorSets;
 		descriptorPoolCreateInfo.poolSizeCount = static_cast<uint32_t>(descriptorPools.size());
 		descriptorPoolCreateInfo.pPoolSizes = descriptorPools.data();
 		Renderer::CheckVk(vkCreateDescriptorPool(logicalDevice->GetLogicalDevice(), &descriptorPoolCreateInfo, nullptr, &m_descriptorPool));
@@ -21,8 +21,9 @@ namespace acid
 		/// <param name="workgroupSize"> The amount of workgroups to use. </param>
 		/// <param name="pushDescriptors"> If no actual descriptor sets are allocated but instead pushed. </param>
 		/// <param name="defines"> A list of defines added to the top of each shader. </param>
+		/// <param name="descriptorSets"> The amount of descriptor sets that can be allocated from the pipeline at once. </param>
 		explicit PipelineCompute(std::string shaderStage, const uint32_t &width, const uint32_t &height, const uint32_t &workgroupSize = 16, 
-			const bool &pushDescriptors = false, std::vector<Shader::Define> defines = {});
+			const bool &pushDescriptors = false, std::vector<Shader::Define> defines = {}, const uint32_t &descriptorSets = 16384);
 
 		~PipelineCompute();
 
@@ -38,8 +39,19 @@ namespace acid
 
 		const std::vector<Shader::Define> &GetDefines() const { return m_defines; }
 
+		const uint32_t &GetDescriptorSets() const { return m_descriptorSets; }
+
 		bool CmdRender(const CommandBuffer &commandBuffer) const;
 
+		/// <summary>
+		/// Dispatches enough workgroups to cover a extent that is only known when recording, such as a count of objects.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into. </param>
+		/// <param name="width"> The width to cover. </param>
+		/// <param name="height"> The height to cover, shaders with a local_size_y of 1 should use 1. </param>
+		/// <returns> If the dispatch was recorded. </returns>
+		bool CmdRender(const CommandBuffer &commandBuffer, const uint32_t &width, const uint32_t &height) const;
+
 		const Shader *GetShaderProgram() const override { return m_shader.get(); }
 
 		const VkDescriptorSetLayout &GetDescriptorSetLayout() const override { return m_descriptorSetLayout; }
@@ -68,6 +80,7 @@ namespace acid
 		uint32_t m_workgroupSize;
 		bool m_pushDescriptors;
 		std::vector<Shader::Define> m_defines;
+		uint32_t m_descriptorSets;
 
 		std::unique_ptr<Shader> m_shader;
 
@@ -43,41 +43,22 @@ namespace acid
 		m_viewportState({}),
 		m_multisampleState({}),
 		m_dynamicState({}),
-		m_tessellationState({})
+		m_tessellationState({}),
+		m_buildJob(nullptr)
 	{
-#if defined(ACID_VERBOSE)
-		auto debugStart = Engine::GetTime();
-#endif
-
 		std::sort(m_vertexInputs.begin(), m_vertexInputs.end());
-		CreateShaderProgram();
-		CreateDescriptorLayout();
-		CreateDescriptorPool();
-		CreatePipelineLayout();
-		CreateAttributes();
 
-		switch (m_mode)
+		// Pipelines constructed together (renderers, material variants) compile and build in parallel.
+		m_buildJob = Engine::Get()->GetThreadPool().Submit([this]()
 		{
-		case Mode::Polygon:
-			CreatePipelinePolygon();
-			break;
-		case Mode::Mrt:
-			CreatePipelineMrt();
-			break;
-		default:
-			assert(false);
-			break;
-		}
-
-#if defined(ACID_VERBOSE)
-		auto debugEnd = Engine::GetTime();
-	//	Log::Out("%s\n", m_shader->ToString().c_str());
-		Log::Out("Pipeline '%s' created in %ims\n", m_shaderStages.back().c_str(), (debugEnd - debugStart).AsMilliseconds());
-#endif
+			Build();
+		});
 	}
 
 	PipelineGraphics::~PipelineGraphics()
 	{
+		WaitReady();
+
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 
 		for (const auto &shaderModule : m_modules)
@@ -91,6 +72,14 @@ namespace acid
 		vkDestroyDescriptorSetLayout(logicalDevice->GetLogicalDevice(), m_descriptorSetLayout, nullptr);
 	}
 
+	void PipelineGraphics::WaitReady() const
+	{
+		if (!m_buildJob->IsFinished())
+		{
+			Engine::Get()->GetThreadPool().Wait(m_buildJob);
+		}
+	}
+
 	const DepthStencil *PipelineGraphics::GetDepthStencil(const std::optional<uint32_t> &stage) const
 	{
 		return Renderer::Get()->GetRenderStage(stage ? *stage : m_stage.first)->GetDepthStencil();
@@ -122,6 +111,41 @@ namespace acid
 		return Renderer::Get()->GetRenderStage(stage ? *stage : m_stage.first)->GetAspectRatio();
 	}
 
+	void PipelineGraphics::Build()
+	{
+#if defined(ACID_VERBOSE)
+		auto debugStart = Engine::GetTime();
+#endif
+
+		CreateShaderProgram();
+		CreateDescriptorLayout();
+		CreateDescriptorPool();
+		CreatePipelineLayout();
+		CreateAttributes();
+
+		switch (m_mode)
+		{
+		case Mode::Polygon:
+			CreatePipelinePolygon();
+			break;
+		case Mode::Mrt:
+			CreatePipelineMrt();
+			break;
+		case Mode::Additive:
+			CreatePipelineAdditive();
+			break;
+		default:
+			assert(false);
+			break;
+		}
+
+#if defined(ACID_VERBOSE)
+		auto debugEnd = Engine::GetTime();
+	//	Log::Out("%s\n", m_shader->ToString().c_str());
+		Log::Out("Pipeline '%s' created in %ims\n", m_shaderStages.back().c_str(), (debugEnd - debugStart).AsMilliseconds());
+#endif
+	}
+
 	void PipelineGraphics::CreateShaderProgram()
 	{
 		std::stringstream defineBlock;
@@ -158,7 +182,7 @@ namespace acid
 			m_modules.emplace_back(shaderModule);
 		}
 
-		m_shader->ProcessShader();
+		m_shader->ProcessShader(m_pushDescriptors);
 	}
 
 	void PipelineGraphics::CreateDescriptorLayout()
@@ -180,7 +204,7 @@ namespace acid
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 
 	//	auto &descriptorPools = m_shader->GetDescriptorPools();
-		std::vector<VkDescriptorPoolSize> descriptorPools(6); // TODO: Cleanup!
+		std::vector<VkDescriptorPoolSize> descriptorPools(7); // TODO: Cleanup!
 		descriptorPools[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
 		descriptorPools[0].descriptorCount = 4096;
 		descriptorPools[1].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -193,6 +217,8 @@ namespace acid
 		descriptorPools[4].descriptorCount = 2048;
 		descriptorPools[5].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 		descriptorPools[5].descriptorCount = 2048;
+		descriptorPools[6].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		descriptorPools[6].descriptorCount = 2048;
 
 		VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
 		descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -424,4 +450,12 @@ namespace acid
 
 		CreatePipeline();
 	}
+
+	void PipelineGraphics::CreatePipelineAdditive()
+	{
+		// Colour is added onto the target, so draws blend the same in any order.
+		m_blendAttachmentStates[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+
+		CreatePipeline();
+	}
 }
@@ -8,6 +8,7 @@
 #include <vector>
 #include "Maths/Vector2.hpp"
 #include "Serialized/Metadata.hpp"
+#include "Threads/Job.hpp"
 #include "Pipeline.hpp"
 
 namespace acid
@@ -24,7 +25,7 @@ namespace acid
 	public:
 		enum class Mode
 		{
-			Polygon, Mrt
+			Polygon, Mrt, Additive
 		};
 
 		enum class Depth
@@ -118,18 +119,32 @@ namespace acid
 
 		const std::vector<Shader::Define> &GetDefines() const { return m_defines; }
 
-		const Shader *GetShaderProgram() const override { return m_shader.get(); }
+		/// <summary>
+		/// Gets if the shaders and pipeline have been built. Building runs on the thread pool once the pipeline is constructed,
+		/// getters that need the built objects wait for it.
+		/// </summary>
+		/// <returns> If the pipeline is ready. </returns>
+		bool IsReady() const { return m_buildJob->IsFinished(); }
+
+		/// <summary>
+		/// Waits until the pipeline has been built, running other thread pool jobs while waiting.
+		/// </summary>
+		void WaitReady() const;
 
-		const VkDescriptorSetLayout &GetDescriptorSetLayout() const override { return m_descriptorSetLayout; }
+		const Shader *GetShaderProgram() const override { WaitReady(); return m_shader.get(); }
 
-		const VkDescriptorPool &GetDescriptorPool() const override { return m_descriptorPool; }
+		const VkDescriptorSetLayout &GetDescriptorSetLayout() const override { WaitReady(); return m_descriptorSetLayout; }
 
-		const VkPipeline &GetPipeline() const override { return m_pipeline; }
+		const VkDescriptorPool &GetDescriptorPool() const override { WaitReady(); return m_descriptorPool; }
 
-		const VkPipelineLayout &GetPipelineLayout() const override { return m_pipelineLayout; }
+		const VkPipeline &GetPipeline() const override { WaitReady(); return m_pipeline; }
+
+		const VkPipelineLayout &GetPipelineLayout() const override { WaitReady(); return m_pipelineLayout; }
 
 		const VkPipelineBindPoint &GetPipelineBindPoint() const override { return m_pipelineBindPoint; }
 	private:
+		void Build();
+
 		void CreateShaderProgram();
 
 		void CreateDescriptorLayout();
@@ -146,6 +161,8 @@ namespace acid
 
 		void CreatePipelineMrt();
 
+		void CreatePipelineAdditive();
+
 		Stage m_stage;
 		std::vector<std::string> m_shaderStages;
 		std::vector<Shader::VertexInput> m_vertexInputs;
@@ -181,6 +198,8 @@ namespace acid
 		VkPipelineMultisampleStateCreateInfo m_multisampleState;
 		VkPipelineDynamicStateCreateInfo m_dynamicState;
 		VkPipelineTessellationStateCreateInfo m_tessellationState;
+
+		std::shared_ptr<Job> m_buildJob;
 	};
 
 	class ACID_EXPORT PipelineGraphicsCreate
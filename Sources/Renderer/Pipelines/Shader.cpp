@@ -1,5 +1,9 @@
 #include "Shader.hpp"
 
+#include <cstring>
+#include <future>
+#include <iomanip>
+#include <mutex>
 #include <utility>
 #include <SPIRV/GlslangToSpv.h>
 #include <glslang/Public/ShaderLang.h>
@@ -13,6 +17,58 @@
 
 namespace acid
 {
+	const std::string Shader::CachePath = "Cache/Shaders";
+	const uint32_t Shader::CacheVersion = 1;
+
+	struct Shader::CompiledStage
+	{
+		std::vector<uint32_t> m_spirv;
+		Reflection m_reflection;
+	};
+
+	static std::mutex COMPILED_MUTEX;
+	static std::map<std::string, std::shared_future<std::shared_ptr<const Shader::CompiledStage>>> COMPILED_STAGES;
+
+	template<typename T>
+	static void WriteCacheValue(std::vector<char> &data, const T &value)
+	{
+		auto bytes = reinterpret_cast<const char *>(&value);
+		data.insert(data.end(), bytes, bytes + sizeof(T));
+	}
+
+	static void WriteCacheString(std::vector<char> &data, const std::string &value)
+	{
+		WriteCacheValue(data, static_cast<uint32_t>(value.size()));
+		data.insert(data.end(), value.begin(), value.end());
+	}
+
+	template<typename T>
+	static bool ReadCacheValue(const std::vector<char> &data, std::size_t &offset, T &value)
+	{
+		if (offset + sizeof(T) > data.size())
+		{
+			return false;
+		}
+
+		std::memcpy(&value, data.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	static bool ReadCacheString(const std::vector<char> &data, std::size_t &offset, std::string &value)
+	{
+		uint32_t size;
+
+		if (!ReadCacheValue(data, offset, size) || offset + size > data.size())
+		{
+			return false;
+		}
+
+		value.assign(data.data() + offset, size);
+		offset += size;
+		return true;
+	}
+
 	Shader::Shader(std::string name) :
 		m_name(std::move(name)),
 		m_lastDescriptorBinding(0)
@@ -34,7 +90,7 @@ namespace acid
 		return false;
 	}
 
-	void Shader::ProcessShader()
+	void Shader::ProcessShader(const bool &pushDescriptors)
 	{
 		std::map<VkDescriptorType, uint32_t> descriptorPoolCounts = {};
 
@@ -46,7 +102,8 @@ namespace acid
 			switch (uniformBlock->GetType())
 			{
 			case UniformBlock::Type::Uniform:
-				descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+				// Uniform blocks are written into the renderers ring buffer, the range is selected when binding.
+				descriptorType = pushDescriptors ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 				m_descriptorSetLayouts.emplace_back(UniformBuffer::GetDescriptorSetLayout(static_cast<uint32_t>(uniformBlock->GetBinding()), 
 					descriptorType, uniformBlock->GetStageFlags(), 1));
 				break;
@@ -441,6 +498,68 @@ namespace acid
 	{
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 
+		auto compiledStage = GetCompiledStage(shaderCode, stageFlag);
+		LoadReflection(compiledStage->m_reflection, stageFlag);
+
+		VkShaderModuleCreateInfo shaderModuleCreateInfo = {};
+		shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		shaderModuleCreateInfo.codeSize = compiledStage->m_spirv.size() * sizeof(uint32_t);
+		shaderModuleCreateInfo.pCode = compiledStage->m_spirv.data();
+		
+		VkShaderModule shaderModule;
+		Renderer::CheckVk(vkCreateShaderModule(logicalDevice->GetLogicalDevice(), &shaderModuleCreateInfo, nullptr, &shaderModule));
+		return shaderModule;
+	}
+
+	std::shared_ptr<const Shader::CompiledStage> Shader::GetCompiledStage(const std::string &shaderCode, const VkShaderStageFlags &stageFlag)
+	{
+		// The code has its defines and includes expanded, so its hash covers everything that changes the compiled output.
+		auto cacheFilename = GetCacheFilename(shaderCode, stageFlag);
+
+		std::promise<std::shared_ptr<const CompiledStage>> promise;
+		std::shared_future<std::shared_ptr<const CompiledStage>> future;
+		bool compile = false;
+
+		{
+			std::lock_guard<std::mutex> lock(COMPILED_MUTEX);
+			auto it = COMPILED_STAGES.find(cacheFilename);
+
+			if (it != COMPILED_STAGES.end())
+			{
+				future = it->second;
+			}
+			else
+			{
+				// The first pipeline to request a stage compiles it, others building at the same time wait for the result.
+				future = promise.get_future().share();
+				COMPILED_STAGES.emplace(cacheFilename, future);
+				compile = true;
+			}
+		}
+
+		if (compile)
+		{
+			auto compiledStage = std::make_shared<CompiledStage>();
+
+			if (!ReadCache(cacheFilename, compiledStage->m_spirv, compiledStage->m_reflection))
+			{
+				compiledStage->m_spirv.clear();
+				compiledStage->m_reflection = {};
+
+				if (CompileShader(shaderCode, stageFlag, compiledStage->m_spirv, compiledStage->m_reflection))
+				{
+					WriteCache(cacheFilename, compiledStage->m_spirv, compiledStage->m_reflection);
+				}
+			}
+
+			promise.set_value(compiledStage);
+		}
+
+		return future.get();
+	}
+
+	bool Shader::CompileShader(const std::string &shaderCode, const VkShaderStageFlags &stageFlag, std::vector<uint32_t> &spirv, Reflection &reflection)
+	{
 		// Starts converting GLSL to SPIR-V.
 		EShLanguage language = GetEshLanguage(stageFlag);
 		glslang::TProgram program;
@@ -461,12 +580,14 @@ namespace acid
 		shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
 
 		const int defaultVersion = glslang::EShTargetOpenGL_450;
+		bool success = true;
 
 		if (!shader.parse(&resources, defaultVersion, false, messages))
 		{
 			Log::Out("%s\n", shader.getInfoLog());
 			Log::Out("%s\n", shader.getInfoDebugLog());
 			Log::Error("SPRIV shader compile failed!\n");
+			success = false;
 		}
 
 		program.addShader(&shader);
@@ -474,11 +595,12 @@ namespace acid
 		if (!program.link(messages) || !program.mapIO())
 		{
 			Log::Error("Error while linking shader program.\n");
+			success = false;
 		}
 
 		program.buildReflection();
 	//	program.dumpReflection();
-		LoadProgram(program, stageFlag);
+		reflection = ReflectProgram(program);
 
 		glslang::SpvOptions spvOptions;
 #if defined(ACID_VERBOSE)
@@ -492,17 +614,177 @@ namespace acid
 #endif
 
 		spv::SpvBuildLogger logger;
-		std::vector<uint32_t> spirv;
 		GlslangToSpv(*program.getIntermediate((EShLanguage)language), spirv, &logger, &spvOptions);
+		return success;
+	}
 
-		VkShaderModuleCreateInfo shaderModuleCreateInfo = {};
-		shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		shaderModuleCreateInfo.codeSize = spirv.size() * sizeof(uint32_t);
-		shaderModuleCreateInfo.pCode = spirv.data();
-		
-		VkShaderModule shaderModule;
-		Renderer::CheckVk(vkCreateShaderModule(logicalDevice->GetLogicalDevice(), &shaderModuleCreateInfo, nullptr, &shaderModule));
-		return shaderModule;
+	std::string Shader::GetCacheFilename(const std::string &shaderCode, const VkShaderStageFlags &stageFlag)
+	{
+		// 64 bit FNV-1a, unlike std::hash it is the same across runs and platforms.
+		uint64_t hash = 14695981039346656037ull;
+
+		auto hashByte = [&hash](const uint8_t &byte)
+		{
+			hash ^= byte;
+			hash *= 1099511628211ull;
+		};
+
+		for (const auto &c : shaderCode)
+		{
+			hashByte(static_cast<uint8_t>(c));
+		}
+
+		for (uint32_t i = 0; i < sizeof(uint32_t); i++)
+		{
+			hashByte(static_cast<uint8_t>(stageFlag >> (8 * i)));
+		}
+
+#if defined(ACID_VERBOSE)
+		// Verbose builds compile with debug info and without the optimizer.
+		hashByte(1);
+#endif
+
+		std::stringstream result;
+		result << FileSystem::GetWorkingDirectory() << "/" << CachePath << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".spv";
+		return result.str();
+	}
+
+	bool Shader::ReadCache(const std::string &filename, std::vector<uint32_t> &spirv, Reflection &reflection)
+	{
+		if (!FileSystem::Exists(filename))
+		{
+			return false;
+		}
+
+		auto data = FileSystem::ReadBinaryFile(filename);
+
+		if (!data)
+		{
+			return false;
+		}
+
+		std::size_t offset = 0;
+		uint32_t version;
+		uint32_t count;
+
+		if (!ReadCacheValue(*data, offset, version) || version != CacheVersion)
+		{
+			return false;
+		}
+
+		if (!ReadCacheValue(*data, offset, count) || offset + count * sizeof(uint32_t) > data->size())
+		{
+			return false;
+		}
+
+		spirv.resize(count);
+		std::memcpy(spirv.data(), data->data() + offset, count * sizeof(uint32_t));
+		offset += count * sizeof(uint32_t);
+
+		if (!ReadCacheValue(*data, offset, count))
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			Reflection::UniformBlockInfo info;
+			uint32_t type;
+
+			if (!ReadCacheString(*data, offset, info.m_name) || !ReadCacheValue(*data, offset, info.m_binding) || !ReadCacheValue(*data, offset, info.m_size) ||
+				!ReadCacheValue(*data, offset, type))
+			{
+				return false;
+			}
+
+			info.m_type = static_cast<UniformBlock::Type>(type);
+			reflection.m_uniformBlocks.emplace_back(info);
+		}
+
+		if (!ReadCacheValue(*data, offset, count))
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			Reflection::UniformInfo info;
+
+			if (!ReadCacheString(*data, offset, info.m_name) || !ReadCacheValue(*data, offset, info.m_binding) || !ReadCacheValue(*data, offset, info.m_offset) ||
+				!ReadCacheValue(*data, offset, info.m_size) || !ReadCacheValue(*data, offset, info.m_glType) || !ReadCacheValue(*data, offset, info.m_readOnly) ||
+				!ReadCacheValue(*data, offset, info.m_writeOnly))
+			{
+				return false;
+			}
+
+			reflection.m_uniforms.emplace_back(info);
+		}
+
+		if (!ReadCacheValue(*data, offset, count))
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			Reflection::AttributeInfo info;
+
+			if (!ReadCacheString(*data, offset, info.m_name) || !ReadCacheValue(*data, offset, info.m_set) || !ReadCacheValue(*data, offset, info.m_location) ||
+				!ReadCacheValue(*data, offset, info.m_size) || !ReadCacheValue(*data, offset, info.m_glType))
+			{
+				return false;
+			}
+
+			reflection.m_attributes.emplace_back(info);
+		}
+
+		return offset == data->size();
+	}
+
+	void Shader::WriteCache(const std::string &filename, const std::vector<uint32_t> &spirv, const Reflection &reflection)
+	{
+		std::vector<char> data;
+		WriteCacheValue(data, CacheVersion);
+		WriteCacheValue(data, static_cast<uint32_t>(spirv.size()));
+		auto spirvBytes = reinterpret_cast<const char *>(spirv.data());
+		data.insert(data.end(), spirvBytes, spirvBytes + spirv.size() * sizeof(uint32_t));
+
+		WriteCacheValue(data, static_cast<uint32_t>(reflection.m_uniformBlocks.size()));
+
+		for (const auto &info : reflection.m_uniformBlocks)
+		{
+			WriteCacheString(data, info.m_name);
+			WriteCacheValue(data, info.m_binding);
+			WriteCacheValue(data, info.m_size);
+			WriteCacheValue(data, static_cast<uint32_t>(info.m_type));
+		}
+
+		WriteCacheValue(data, static_cast<uint32_t>(reflection.m_uniforms.size()));
+
+		for (const auto &info : reflection.m_uniforms)
+		{
+			WriteCacheString(data, info.m_name);
+			WriteCacheValue(data, info.m_binding);
+			WriteCacheValue(data, info.m_offset);
+			WriteCacheValue(data, info.m_size);
+			WriteCacheValue(data, info.m_glType);
+			WriteCacheValue(data, info.m_readOnly);
+			WriteCacheValue(data, info.m_writeOnly);
+		}
+
+		WriteCacheValue(data, static_cast<uint32_t>(reflection.m_attributes.size()));
+
+		for (const auto &info : reflection.m_attributes)
+		{
+			WriteCacheString(data, info.m_name);
+			WriteCacheValue(data, info.m_set);
+			WriteCacheValue(data, info.m_location);
+			WriteCacheValue(data, info.m_size);
+			WriteCacheValue(data, info.m_glType);
+		}
+
+		FileSystem::Create(filename);
+		FileSystem::WriteBinaryFile(filename, data);
 	}
 
 	std::string Shader::ToString() const
@@ -566,55 +848,82 @@ namespace acid
 		}
 	}
 
-	void Shader::LoadProgram(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag)
+	Shader::Reflection Shader::ReflectProgram(const glslang::TProgram &program)
 	{
+		Reflection reflection;
+
 		for (int32_t i = program.getNumLiveUniformBlocks() - 1; i >= 0; i--)
 		{
-			LoadUniformBlock(program, stageFlag, i);
+			auto type = UniformBlock::Type::Uniform;
+
+			if (strcmp(program.getUniformBlockTType(i)->getStorageQualifierString(), "buffer") == 0)
+			{
+				type = UniformBlock::Type::Storage;
+			}
+
+			if (program.getUniformBlockTType(i)->getQualifier().layoutPushConstant)
+			{
+				type = UniformBlock::Type::Push;
+			}
+
+			reflection.m_uniformBlocks.emplace_back(Reflection::UniformBlockInfo{program.getUniformBlockName(i), program.getUniformBlockBinding(i), 
+				program.getUniformBlockSize(i), type});
 		}
 
 		for (int32_t i = 0; i < program.getNumLiveUniformVariables(); i++)
 		{
-			LoadUniform(program, stageFlag, i);
+			auto &qualifier = program.getUniformTType(i)->getQualifier();
+			reflection.m_uniforms.emplace_back(Reflection::UniformInfo{program.getUniformName(i), program.getUniformBinding(i), program.getUniformBufferOffset(i), 
+				ComputeSize(program.getUniformTType(i)), program.getUniformType(i), qualifier.readonly, qualifier.writeonly});
 		}
 
 		for (int32_t i = 0; i < program.getNumLiveAttributes(); i++)
 		{
-			LoadVertexAttribute(program, stageFlag, i);
+			auto &qualifier = program.getAttributeTType(i)->getQualifier();
+			reflection.m_attributes.emplace_back(Reflection::AttributeInfo{program.getAttributeName(i), qualifier.layoutSet, qualifier.layoutLocation, 
+				ComputeSize(program.getAttributeTType(i)), program.getAttributeType(i)});
 		}
+
+		return reflection;
 	}
 
-	void Shader::LoadUniformBlock(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag, const int32_t &i)
+	void Shader::LoadReflection(const Reflection &reflection, const VkShaderStageFlags &stageFlag)
 	{
-		for (auto &[uniformBlockName, uniformBlock] : m_uniformBlocks)
+		for (const auto &info : reflection.m_uniformBlocks)
 		{
-			if (uniformBlockName == program.getUniformBlockName(i))
-			{
-				uniformBlock->m_stageFlags |= stageFlag;
-				return;
-			}
+			LoadUniformBlock(info, stageFlag);
 		}
 
-		auto type = UniformBlock::Type::Uniform;
+		for (const auto &info : reflection.m_uniforms)
+		{
+			LoadUniform(info, stageFlag);
+		}
 
-		if (strcmp(program.getUniformBlockTType(i)->getStorageQualifierString(), "buffer") == 0)
+		for (const auto &info : reflection.m_attributes)
 		{
-			type = UniformBlock::Type::Storage;
+			LoadVertexAttribute(info);
 		}
+	}
 
-		if (program.getUniformBlockTType(i)->getQualifier().layoutPushConstant)
+	void Shader::LoadUniformBlock(const Reflection::UniformBlockInfo &info, const VkShaderStageFlags &stageFlag)
+	{
+		for (auto &[uniformBlockName, uniformBlock] : m_uniformBlocks)
 		{
-			type = UniformBlock::Type::Push;
+			if (uniformBlockName == info.m_name)
+			{
+				uniformBlock->m_stageFlags |= stageFlag;
+				return;
+			}
 		}
 
-		m_uniformBlocks.emplace(program.getUniformBlockName(i), std::make_unique<UniformBlock>(program.getUniformBlockBinding(i), program.getUniformBlockSize(i), stageFlag, type));
+		m_uniformBlocks.emplace(info.m_name, std::make_unique<UniformBlock>(info.m_binding, info.m_size, stageFlag, info.m_type));
 	}
 
-	void Shader::LoadUniform(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag, const int32_t &i)
+	void Shader::LoadUniform(const Reflection::UniformInfo &info, const VkShaderStageFlags &stageFlag)
 	{
-		if (program.getUniformBinding(i) == -1)
+		if (info.m_binding == -1)
 		{
-			auto splitName = String::Split(program.getUniformName(i), ".");
+			auto splitName = String::Split(info.m_name, ".");
 
 			if (splitName.size() == 2)
 			{
@@ -622,8 +931,8 @@ namespace acid
 				{
 					if (uniformBlockName == splitName.at(0))
 					{
-						uniformBlock->m_uniforms.emplace(splitName.at(1), std::make_unique<Uniform>(program.getUniformBinding(i), 
-							program.getUniformBufferOffset(i), ComputeSize(program.getUniformTType(i)), program.getUniformType(i), false, false, stageFlag));
+						uniformBlock->m_uniforms.emplace(splitName.at(1), std::make_unique<Uniform>(info.m_binding, 
+							info.m_offset, info.m_size, info.m_glType, false, false, stageFlag));
 						return;
 					}
 				}
@@ -632,33 +941,28 @@ namespace acid
 
 		for (auto &[uniformName, uniform] : m_uniforms)
 		{
-			if (uniformName == program.getUniformName(i))
+			if (uniformName == info.m_name)
 			{
 				uniform->m_stageFlags |= stageFlag;
 				return;
 			}
 		}
 
-		auto &qualifier = program.getUniformTType(i)->getQualifier();
-		m_uniforms.emplace(program.getUniformName(i), std::make_unique<Uniform>(program.getUniformBinding(i), program.getUniformBufferOffset(i), -1, 
-			program.getUniformType(i), qualifier.readonly, qualifier.writeonly, stageFlag));
+		m_uniforms.emplace(info.m_name, std::make_unique<Uniform>(info.m_binding, info.m_offset, -1, 
+			info.m_glType, info.m_readOnly, info.m_writeOnly, stageFlag));
 	}
 
-	void Shader::LoadVertexAttribute(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag, const int32_t &i)
+	void Shader::LoadVertexAttribute(const Reflection::AttributeInfo &info)
 	{
-		std::string name = program.getAttributeName(i);
-
 		for (const auto &[attributeName, attribute] : m_attributes)
 		{
-			if (attributeName == name)
+			if (attributeName == info.m_name)
 			{
 				return;
 			}
 		}
 
-		auto &qualifier = program.getAttributeTType(i)->getQualifier();
-		m_attributes.emplace(name, std::make_unique<Attribute>(qualifier.layoutSet, qualifier.layoutLocation,
-			ComputeSize(program.getAttributeTType(i)), program.getAttributeType(i)));
+		m_attributes.emplace(info.m_name, std::make_unique<Attribute>(info.m_set, info.m_location, info.m_size, info.m_glType));
 	}
 
 	int32_t Shader::ComputeSize(const glslang::TType *ttype)
@@ -210,7 +210,11 @@ namespace acid
 
 		bool ReportedNotFound(const std::string &name, const bool &reportIfFound) const;
 
-		void ProcessShader();
+		/// <summary>
+		/// Builds the descriptor layouts and pools from the reflected shader stages.
+		/// </summary>
+		/// <param name="pushDescriptors"> If the descriptors are pushed, uniform blocks then can not use dynamic offsets. </param>
+		void ProcessShader(const bool &pushDescriptors = false);
 
 		static VkFormat GlTypeToVk(const int32_t &type);
 
@@ -246,19 +250,94 @@ namespace acid
 
 		static std::string ProcessIncludes(const std::string &shaderCode);
 
+		/// <summary>
+		/// Creates a shader module for a stage and merges its reflection into this shader.
+		/// The SPIR-V and reflection are cached on disk by a hash of the code, so unchanged stages skip compilation.
+		/// </summary>
+		/// <param name="shaderCode"> The GLSL code, with defines and includes already inserted. </param>
+		/// <param name="stageFlag"> The stage of the code. </param>
+		/// <returns> The shader module. </returns>
 		VkShaderModule ProcessShader(const std::string &shaderCode, const VkShaderStageFlags &stageFlag);
 
 		std::string ToString() const;
+
+		/// <summary>
+		/// The directory compiled stages are cached in, relative to the working directory.
+		/// </summary>
+		static const std::string CachePath;
+
+		/// <summary>
+		/// The version of the cache file layout, older files are recompiled.
+		/// </summary>
+		static const uint32_t CacheVersion;
+
+		/// <summary>
+		/// The SPIR-V and reflection of a stage, shared by every pipeline using the same code.
+		/// </summary>
+		struct CompiledStage;
 	private:
+		/// <summary>
+		/// The reflected interface of a single stage, in the order glslang reports it.
+		/// </summary>
+		struct Reflection
+		{
+			struct UniformBlockInfo
+			{
+				std::string m_name;
+				int32_t m_binding;
+				int32_t m_size;
+				UniformBlock::Type m_type;
+			};
+
+			struct UniformInfo
+			{
+				std::string m_name;
+				int32_t m_binding;
+				int32_t m_offset;
+				int32_t m_size;
+				int32_t m_glType;
+				bool m_readOnly;
+				bool m_writeOnly;
+			};
+
+			struct AttributeInfo
+			{
+				std::string m_name;
+				int32_t m_set;
+				int32_t m_location;
+				int32_t m_size;
+				int32_t m_glType;
+			};
+
+			std::vector<UniformBlockInfo> m_uniformBlocks;
+			std::vector<UniformInfo> m_uniforms;
+			std::vector<AttributeInfo> m_attributes;
+		};
+
 		static void IncrementDescriptorPool(std::map<VkDescriptorType, uint32_t> &descriptorPoolCounts, const VkDescriptorType &type);
 
-		void LoadProgram(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag);
+		/// <summary>
+		/// Gets the SPIR-V and reflection of a stage, each distinct stage is compiled or read from disk once per run.
+		/// </summary>
+		static std::shared_ptr<const CompiledStage> GetCompiledStage(const std::string &shaderCode, const VkShaderStageFlags &stageFlag);
+
+		static bool CompileShader(const std::string &shaderCode, const VkShaderStageFlags &stageFlag, std::vector<uint32_t> &spirv, Reflection &reflection);
+
+		static Reflection ReflectProgram(const glslang::TProgram &program);
+
+		static std::string GetCacheFilename(const std::string &shaderCode, const VkShaderStageFlags &stageFlag);
+
+		static bool ReadCache(const std::string &filename, std::vector<uint32_t> &spirv, Reflection &reflection);
+
+		static void WriteCache(const std::string &filename, const std::vector<uint32_t> &spirv, const Reflection &reflection);
+
+		void LoadReflection(const Reflection &reflection, const VkShaderStageFlags &stageFlag);
 
-		void LoadUniformBlock(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag, const int32_t &i);
+		void LoadUniformBlock(const Reflection::UniformBlockInfo &info, const VkShaderStageFlags &stageFlag);
 
-		void LoadUniform(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag, const int32_t &i);
+		void LoadUniform(const Reflection::UniformInfo &info, const VkShaderStageFlags &stageFlag);
 
-		void LoadVertexAttribute(const glslang::TProgram &program, const VkShaderStageFlags &stageFlag, const int32_t &i);
+		void LoadVertexAttribute(const Reflection::AttributeInfo &info);
 
 		static int32_t ComputeSize(const glslang::TType *ttype);
 
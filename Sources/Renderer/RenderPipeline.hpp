@@ -17,16 +17,27 @@ namespace acid
 		/// <param name="stage"> The stage this renderer will be used in. </param>
 		explicit RenderPipeline(Pipeline::Stage stage) :
 			m_stage(std::move(stage)),
-			m_enabled(true)
+			m_enabled(true),
+			m_parallel(true)
 		{
 		}
 
 		virtual ~RenderPipeline() = default;
 
+		/// <summary>
+		/// Runs before the renderpass this pipeline is used in begins, on the calling thread.
+		/// Used to record work that can not be recorded inside a renderpass, such as compute dispatches.
+		/// </summary>
+		/// <param name="commandBuffer"> The primary command buffer of the frame. </param>
+		virtual void PreRender(const CommandBuffer &commandBuffer) {}
+
 		/// <summary>
 		/// Runs the render pipeline in the current renderpass.
+		/// Parallel pipelines of the same subpass are recorded at the same time on the thread pool, each into its own secondary command buffer.
+		/// They may only read shared state such as the scene, which is only restructured during its own update and never while recording.
+		/// Pipelines that change state other pipelines read must be recorded serially with <seealso cref="#SetParallel"/>.
 		/// </summary>
-		/// <param name="commandBuffer"> The command buffer to record render command into. </param>
+		/// <param name="commandBuffer"> The secondary command buffer to record render command into. </param>
 		virtual void Render(const CommandBuffer &commandBuffer) = 0;
 
 		const Pipeline::Stage &GetStage() const { return m_stage; }
@@ -34,8 +45,17 @@ namespace acid
 		const bool &IsEnabled() const { return m_enabled; };
 
 		void SetEnabled(const bool &enable) { m_enabled = enable; }
+
+		/// <summary>
+		/// Gets if this pipeline can be recorded on the thread pool, pipelines that are not are recorded in order on the rendering thread.
+		/// </summary>
+		/// <returns> If the pipeline is recorded in parallel. </returns>
+		const bool &IsParallel() const { return m_parallel; }
+
+		void SetParallel(const bool &parallel) { m_parallel = parallel; }
 	private:
 		Pipeline::Stage m_stage;
 		bool m_enabled;
+		bool m_parallel;
 	};
 }
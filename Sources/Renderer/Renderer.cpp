@@ -1,26 +1,39 @@
 #include "Renderer.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <SPIRV/GlslangToSpv.h>
+#include "Engine/Profiler.hpp"
 #include "Files/FileSystem.hpp"
+#include "Scenes/Scenes.hpp"
 #include "RenderPipeline.hpp"
 
 namespace acid
 {
+	const std::string Renderer::PipelineCachePath = "Cache/Pipelines.bin";
+
 	Renderer::Renderer() :
 		m_renderManager(nullptr),
 		m_swapchain(nullptr),
 		m_pipelineCache(VK_NULL_HANDLE),
-		m_commandPool(VK_NULL_HANDLE),
 		m_currentFrame(0),
 		m_instance(std::make_unique<Instance>()),
 		m_physicalDevice(std::make_unique<PhysicalDevice>(m_instance.get())),
 		m_surface(std::make_unique<Surface>(m_instance.get(), m_physicalDevice.get())),
-		m_logicalDevice(std::make_unique<LogicalDevice>(m_instance.get(), m_physicalDevice.get(), m_surface.get()))
+		m_logicalDevice(std::make_unique<LogicalDevice>(m_instance.get(), m_physicalDevice.get(), m_surface.get())),
+		m_memoryAllocator(std::make_unique<MemoryAllocator>(m_logicalDevice.get(), m_physicalDevice.get())),
+		m_ringBuffer(nullptr),
+		m_instancePool(nullptr),
+		m_uploadManager(std::make_unique<UploadManager>(m_logicalDevice.get()))
 	{
+		// Presents to the window surface created on the main thread.
+		AddWrite<Renderer>();
+		// Render pipelines read the scene while recording in parallel, so the scene must not update at the same time.
+		AddRead<Scenes>();
+		SetMainThread(true);
+
 		glslang::InitializeProcess();
 
-		CreateCommandPool();
 		CreatePipelineCache();
 	}
 
@@ -30,8 +43,18 @@ namespace acid
 
 		CheckVk(vkQueueWaitIdle(graphicsQueue));
 
+		// Released before the memory allocator, as their buffers and images return memory to it.
+		m_renderManager = nullptr;
+		m_renderStages.clear();
+		m_commandBuffers.clear();
+		m_secondaryBuffers.clear();
+		m_ringBuffer = nullptr;
+		m_instancePool = nullptr;
+		m_uploadManager = nullptr;
+
 		glslang::FinalizeProcess();
 
+		SavePipelineCache();
 		vkDestroyPipelineCache(m_logicalDevice->GetLogicalDevice(), m_pipelineCache, nullptr);
 
 		for (size_t i = 0; i < m_flightFences.size(); i++)
@@ -41,7 +64,7 @@ namespace acid
 			vkDestroySemaphore(m_logicalDevice->GetLogicalDevice(), m_presentCompletes[i], nullptr);
 		}
 
-		vkDestroyCommandPool(m_logicalDevice->GetLogicalDevice(), m_commandPool, nullptr);
+		m_commandPools.clear();
 	}
 
 	void Renderer::Update()
@@ -92,7 +115,7 @@ namespace acid
 				// Starts the next renderpass.
 				auto renderStage = GetRenderStage(*renderpass);
 				renderStage->Update();
-				auto startResult = StartRenderpass(*renderStage);
+				auto startResult = StartRenderpass(*renderStage, *renderpass);
 
 				if (!startResult)
 				{
@@ -114,22 +137,14 @@ namespace acid
 
 				for (uint32_t d = 0; d < difference; d++)
 				{
-					vkCmdNextSubpass(m_commandBuffers[m_swapchain->GetActiveImageIndex()]->GetCommandBuffer(), VK_SUBPASS_CONTENTS_INLINE);
+					vkCmdNextSubpass(m_commandBuffers[m_swapchain->GetActiveImageIndex()]->GetCommandBuffer(), VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 				}
 
 				subpass = key.second;
 			}
 
-			// Renders subpass render pipeline.
-			for (auto &renderPipeline : renderPipelines)
-			{
-				if (!renderPipeline->IsEnabled())
-				{
-					continue;
-				}
-
-				renderPipeline->Render(*m_commandBuffers[m_swapchain->GetActiveImageIndex()]);
-			}
+			// Renders subpass render pipelines.
+			RecordSubpass(*renderStage, subpass, renderPipelines);
 		}
 
 		// Ends the last renderpass.
@@ -231,8 +246,8 @@ namespace acid
 
 		VkImage srcImage = m_swapchain->GetActiveImage();
 		VkImage dstImage;
-		VkDeviceMemory dstImageMemory;
-		bool supportsBlit = Texture::CopyImage(srcImage, dstImage, dstImageMemory, width, height, true, 0, 1);
+		MemoryAllocation dstAllocation;
+		bool supportsBlit = Texture::CopyImage(srcImage, dstImage, dstAllocation, width, height, true, 0, 1);
 
 		// Get layout of the image (including row pitch).
 		VkImageSubresource imageSubresource = {};
@@ -244,10 +259,8 @@ namespace acid
 		// Creates the screenshot image file.
 		FileSystem::Create(filename);
 
-		// Map image memory so we can start copying from it.
-		char *data;
-		vkMapMemory(m_logicalDevice->GetLogicalDevice(), dstImageMemory, 0, VK_WHOLE_SIZE, 0, (void **)&data);
-		data += subresourceLayout.offset;
+		// The image memory stays mapped, so we can start copying from it.
+		auto data = static_cast<char *>(dstAllocation.GetMapped()) + subresourceLayout.offset;
 
 		// If source is BGR (destination is always RGB) and we can't use blit (which does automatic conversion), we'll have to manually swizzle color components
 		bool colourSwizzle = false;
@@ -281,9 +294,8 @@ namespace acid
 		Texture::WritePixels(filename, pixels.get(), width, height, 4);
 
 		// Clean up resources.
-		vkUnmapMemory(m_logicalDevice->GetLogicalDevice(), dstImageMemory);
-		vkFreeMemory(m_logicalDevice->GetLogicalDevice(), dstImageMemory, nullptr);
 		vkDestroyImage(m_logicalDevice->GetLogicalDevice(), dstImage, nullptr);
+		m_memoryAllocator->Free(dstAllocation);
 
 #if defined(ACID_VERBOSE)
 		auto debugEnd = Engine::GetTime();
@@ -311,6 +323,13 @@ namespace acid
 		m_renderStages.clear();
 		m_swapchain = std::make_unique<Swapchain>(displayExtent);
 
+		// Created once the renderer is registered, as buffers find the renderer through the module manager.
+		if (m_ringBuffer == nullptr)
+		{
+			m_ringBuffer = std::make_unique<RingBuffer>(RingBuffer::DefaultSize);
+			m_instancePool = std::make_unique<InstancePool>();
+		}
+
 		if (m_flightFences.size() != m_swapchain->GetImageCount())
 		{
 			for (size_t i = 0; i < m_flightFences.size(); i++)
@@ -353,6 +372,19 @@ namespace acid
 		RecreateAttachmentsMap();
 	}
 
+	std::shared_ptr<CommandPool> Renderer::GetCommandPool(const std::thread::id &threadId)
+	{
+		std::unique_lock<std::mutex> lock(m_commandPoolMutex);
+		auto it = m_commandPools.find(threadId);
+
+		if (it != m_commandPools.end())
+		{
+			return it->second;
+		}
+
+		return m_commandPools.emplace(threadId, std::make_shared<CommandPool>(threadId)).first->second;
+	}
+
 	const Descriptor *Renderer::GetAttachment(const std::string &name) const
 	{
 		auto it = m_attachments.find(name);
@@ -365,24 +397,63 @@ namespace acid
 		return it->second;
 	}
 
-	void Renderer::CreateCommandPool()
+	void Renderer::CreatePipelineCache()
 	{
-		auto graphicsFamily = m_logicalDevice->GetGraphicsFamily();
+		auto filename = FileSystem::GetWorkingDirectory() + "/" + PipelineCachePath;
+		auto header = GetPipelineCacheHeader();
+		std::vector<char> cacheData;
 
-		VkCommandPoolCreateInfo commandPoolCreateInfo = {};
-		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-		commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-		commandPoolCreateInfo.queueFamilyIndex = graphicsFamily;
-		CheckVk(vkCreateCommandPool(m_logicalDevice->GetLogicalDevice(), &commandPoolCreateInfo, nullptr, &m_commandPool));
-	}
+		if (FileSystem::Exists(filename))
+		{
+			auto fileData = FileSystem::ReadBinaryFile(filename);
+
+			// Data from another device or driver version is dropped, some drivers do not validate it themselves.
+			if (fileData && fileData->size() > header.size() && std::equal(header.begin(), header.end(), fileData->begin()))
+			{
+				cacheData.assign(fileData->begin() + header.size(), fileData->end());
+			}
+		}
 
-	void Renderer::CreatePipelineCache()
-	{
 		VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
 		pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		pipelineCacheCreateInfo.initialDataSize = cacheData.size();
+		pipelineCacheCreateInfo.pInitialData = cacheData.data();
 		CheckVk(vkCreatePipelineCache(m_logicalDevice->GetLogicalDevice(), &pipelineCacheCreateInfo, nullptr, &m_pipelineCache));
 	}
 
+	void Renderer::SavePipelineCache()
+	{
+		std::size_t dataSize;
+		CheckVk(vkGetPipelineCacheData(m_logicalDevice->GetLogicalDevice(), m_pipelineCache, &dataSize, nullptr));
+
+		auto fileData = GetPipelineCacheHeader();
+		auto headerSize = fileData.size();
+		fileData.resize(headerSize + dataSize);
+		CheckVk(vkGetPipelineCacheData(m_logicalDevice->GetLogicalDevice(), m_pipelineCache, &dataSize, fileData.data() + headerSize));
+		fileData.resize(headerSize + dataSize);
+
+		auto filename = FileSystem::GetWorkingDirectory() + "/" + PipelineCachePath;
+		FileSystem::Create(filename);
+		FileSystem::WriteBinaryFile(filename, fileData);
+	}
+
+	std::vector<char> Renderer::GetPipelineCacheHeader() const
+	{
+		auto &properties = m_physicalDevice->GetProperties();
+
+		std::vector<char> header;
+		auto append = [&header](const void *data, const std::size_t &size)
+		{
+			header.insert(header.end(), static_cast<const char *>(data), static_cast<const char *>(data) + size);
+		};
+
+		append(&properties.vendorID, sizeof(properties.vendorID));
+		append(&properties.deviceID, sizeof(properties.deviceID));
+		append(&properties.driverVersion, sizeof(properties.driverVersion));
+		append(properties.pipelineCacheUUID, VK_UUID_SIZE);
+		return header;
+	}
+
 	void Renderer::RecreatePass(RenderStage &renderStage)
 	{
 		auto graphicsQueue = m_logicalDevice->GetGraphicsQueue();
@@ -416,7 +487,7 @@ namespace acid
 		}
 	}
 
-	bool Renderer::StartRenderpass(RenderStage &renderStage)
+	bool Renderer::StartRenderpass(RenderStage &renderStage, const uint32_t &renderpass)
 	{
 		if (renderStage.IsOutOfDate())
 		{
@@ -427,9 +498,39 @@ namespace acid
 		if (!m_commandBuffers[m_swapchain->GetActiveImageIndex()]->IsRunning())
 		{
 			CheckVk(vkWaitForFences(m_logicalDevice->GetLogicalDevice(), 1, &m_flightFences[m_currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max()));
+			m_memoryAllocator->BeginFrame();
+			m_ringBuffer->BeginFrame(static_cast<uint32_t>(m_currentFrame));
+			m_instancePool->BeginFrame(static_cast<uint32_t>(m_currentFrame));
+
+			// The secondary command buffers recorded the last time this frame was in flight can be recorded again.
+			for (auto &[key, secondaryBuffers] : m_secondaryBuffers)
+			{
+				if (key.second == m_currentFrame)
+				{
+					secondaryBuffers.m_used = 0;
+				}
+			}
+
 			m_commandBuffers[m_swapchain->GetActiveImageIndex()]->Begin(VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
 		}
 
+		// Work that can not be recorded inside a renderpass, such as compute dispatches, is recorded ahead of it.
+		for (const auto &[key, renderPipelines] : m_renderManager->GetRendererContainer().GetStages())
+		{
+			if (key.first != renderpass)
+			{
+				continue;
+			}
+
+			for (const auto &renderPipeline : renderPipelines)
+			{
+				if (renderPipeline->IsEnabled())
+				{
+					renderPipeline->PreRender(*m_commandBuffers[m_swapchain->GetActiveImageIndex()]);
+				}
+			}
+		}
+
 		VkRect2D renderArea = {};
 		renderArea.offset = {0, 0};
 		renderArea.extent = {
@@ -437,20 +538,6 @@ namespace acid
 			renderStage.GetHeight()
 		};
 
-		VkViewport viewport = {};
-		viewport.x = 0.0f;
-		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(renderArea.extent.width);
-		viewport.height = static_cast<float>(renderArea.extent.height);
-		viewport.minDepth = 0.0f;
-		viewport.maxDepth = 1.0f;
-		vkCmdSetViewport(m_commandBuffers[m_swapchain->GetActiveImageIndex()]->GetCommandBuffer(), 0, 1, &viewport);
-
-		VkRect2D scissor = {};
-		scissor.offset = {0, 0};
-		scissor.extent = renderArea.extent;
-		vkCmdSetScissor(m_commandBuffers[m_swapchain->GetActiveImageIndex()]->GetCommandBuffer(), 0, 1, &scissor);
-
 		auto clearValues = renderStage.GetClearValues();
 
 		VkRenderPassBeginInfo renderPassBeginInfo = {};
@@ -460,11 +547,118 @@ namespace acid
 		renderPassBeginInfo.renderArea = renderArea;
 		renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 		renderPassBeginInfo.pClearValues = clearValues.data();
-		vkCmdBeginRenderPass(m_commandBuffers[m_swapchain->GetActiveImageIndex()]->GetCommandBuffer(), &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		vkCmdBeginRenderPass(m_commandBuffers[m_swapchain->GetActiveImageIndex()]->GetCommandBuffer(), &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 
 		return true;
 	}
 
+	void Renderer::RecordSubpass(const RenderStage &renderStage, const uint32_t &subpass, const std::vector<std::unique_ptr<RenderPipeline>> &renderPipelines)
+	{
+		auto &threadPool = Engine::Get()->GetThreadPool();
+
+		VkCommandBufferInheritanceInfo inheritanceInfo = {};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritanceInfo.renderPass = renderStage.GetRenderpass()->GetRenderpass();
+		inheritanceInfo.subpass = subpass;
+		inheritanceInfo.framebuffer = renderStage.GetActiveFramebuffer(m_swapchain->GetActiveImageIndex());
+
+		VkExtent2D extent = {
+			renderStage.GetWidth(),
+			renderStage.GetHeight()
+		};
+
+		// Each pipeline is recorded into a secondary command buffer from the pool of the thread running its job.
+		std::vector<CommandBuffer *> secondaryBuffers(renderPipelines.size(), nullptr);
+		std::vector<std::shared_ptr<Job>> jobs;
+
+		auto recordPipeline = [this, &renderPipelines, &secondaryBuffers, &inheritanceInfo, &extent](const std::size_t &i)
+		{
+			auto &renderPipeline = *renderPipelines[i];
+			ACID_PROFILE_SCOPE(typeid(renderPipeline).name());
+
+			auto &commandBuffer = GetSecondaryBuffer();
+			commandBuffer.Begin(inheritanceInfo);
+
+			// Dynamic state is not inherited from the primary command buffer.
+			VkViewport viewport = {};
+			viewport.x = 0.0f;
+			viewport.y = 0.0f;
+			viewport.width = static_cast<float>(extent.width);
+			viewport.height = static_cast<float>(extent.height);
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+			vkCmdSetViewport(commandBuffer.GetCommandBuffer(), 0, 1, &viewport);
+
+			VkRect2D scissor = {};
+			scissor.offset = {0, 0};
+			scissor.extent = extent;
+			vkCmdSetScissor(commandBuffer.GetCommandBuffer(), 0, 1, &scissor);
+
+			renderPipeline.Render(commandBuffer);
+			commandBuffer.End();
+			secondaryBuffers[i] = &commandBuffer;
+		};
+
+		for (std::size_t i = 0; i < renderPipelines.size(); i++)
+		{
+			if (!renderPipelines[i]->IsEnabled() || !renderPipelines[i]->IsParallel())
+			{
+				continue;
+			}
+
+			jobs.emplace_back(threadPool.Submit([&recordPipeline, i]()
+			{
+				recordPipeline(i);
+			}));
+		}
+
+		// Pipelines that share state between each other are recorded in the order they were added on this thread, while the jobs run.
+		for (std::size_t i = 0; i < renderPipelines.size(); i++)
+		{
+			if (renderPipelines[i]->IsEnabled() && !renderPipelines[i]->IsParallel())
+			{
+				recordPipeline(i);
+			}
+		}
+
+		for (const auto &job : jobs)
+		{
+			threadPool.Wait(job);
+		}
+
+		// Executed in the order the pipelines were added, so the draw order does not depend on which thread recorded a pipeline.
+		std::vector<VkCommandBuffer> commandBuffers;
+
+		for (const auto &secondaryBuffer : secondaryBuffers)
+		{
+			if (secondaryBuffer != nullptr)
+			{
+				commandBuffers.emplace_back(secondaryBuffer->GetCommandBuffer());
+			}
+		}
+
+		if (!commandBuffers.empty())
+		{
+			vkCmdExecuteCommands(m_commandBuffers[m_swapchain->GetActiveImageIndex()]->GetCommandBuffer(), 
+				static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+		}
+	}
+
+	CommandBuffer &Renderer::GetSecondaryBuffer()
+	{
+		std::unique_lock<std::mutex> lock(m_commandPoolMutex);
+		auto &secondaryBuffers = m_secondaryBuffers[{std::this_thread::get_id(), m_currentFrame}];
+		lock.unlock();
+
+		// Only the calling thread takes buffers from its own entry, so the rest needs no lock.
+		if (secondaryBuffers.m_used == secondaryBuffers.m_commandBuffers.size())
+		{
+			secondaryBuffers.m_commandBuffers.emplace_back(std::make_unique<CommandBuffer>(false, VK_QUEUE_GRAPHICS_BIT, VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+		}
+
+		return *secondaryBuffers.m_commandBuffers[secondaryBuffers.m_used++];
+	}
+
 	void Renderer::EndRenderpass(RenderStage &renderStage)
 	{
 		auto presentQueue = m_logicalDevice->GetPresentQueue();
@@ -477,7 +671,11 @@ namespace acid
 		}
 
 		m_commandBuffers[m_swapchain->GetActiveImageIndex()]->End();
+		// Uploads are submitted ahead of the frame on the same queue, so the frame reads them without the CPU waiting.
+		m_uploadManager->Flush();
 		m_commandBuffers[m_swapchain->GetActiveImageIndex()]->Submit(m_presentCompletes[m_currentFrame], m_renderCompletes[m_currentFrame], m_flightFences[m_currentFrame]);
+		m_ringBuffer->EndFrame(static_cast<uint32_t>(m_currentFrame));
+		m_instancePool->EndFrame(static_cast<uint32_t>(m_currentFrame));
 		VkResult presentResult = m_swapchain->QueuePresent(presentQueue, m_renderCompletes[m_currentFrame]);
 
 		if (!(presentResult == VK_SUCCESS || presentResult == VK_SUBOPTIMAL_KHR))
@@ -1,13 +1,20 @@
 #pragma once
 
+#include <mutex>
+#include <thread>
 #include <vulkan/vulkan.h>
 #include "Engine/Engine.hpp"
 #include "Commands/CommandBuffer.hpp"
+#include "Commands/CommandPool.hpp"
 #include "Devices/Instance.hpp"
 #include "Devices/LogicalDevice.hpp"
 #include "Devices/PhysicalDevice.hpp"
 #include "Devices/Surface.hpp"
 #include "Devices/Window.hpp"
+#include "Memory/MemoryAllocator.hpp"
+#include "Memory/UploadManager.hpp"
+#include "Buffers/InstancePool.hpp"
+#include "Buffers/RingBuffer.hpp"
 #include "RenderManager.hpp"
 #include "RenderStage.hpp"
 
@@ -61,7 +68,12 @@ namespace acid
 
 		const Swapchain *GetSwapchain() const { return m_swapchain.get(); }
 
-		const VkCommandPool &GetCommandPool() const { return m_commandPool; }
+		/// <summary>
+		/// Gets the command pool of a thread, creating it on first use.
+		/// </summary>
+		/// <param name="threadId"> The thread that will record command buffers from the pool. </param>
+		/// <returns> The command pool. </returns>
+		std::shared_ptr<CommandPool> GetCommandPool(const std::thread::id &threadId = std::this_thread::get_id());
 
 		const VkPipelineCache &GetPipelineCache() const { return m_pipelineCache; }
 
@@ -70,26 +82,72 @@ namespace acid
 		const Surface *GetSurface() const { return m_surface.get(); }
 
 		const LogicalDevice *GetLogicalDevice() const { return m_logicalDevice.get(); }
-	private:
-		void CreateCommandPool();
 
+		MemoryAllocator *GetMemoryAllocator() const { return m_memoryAllocator.get(); }
+
+		RingBuffer *GetRingBuffer() const { return m_ringBuffer.get(); }
+
+		InstancePool *GetInstancePool() const { return m_instancePool.get(); }
+
+		UploadManager *GetUploadManager() const { return m_uploadManager.get(); }
+
+		/// <summary>
+		/// Gets the index of the frame in flight being recorded, less than the swapchain image count.
+		/// Resources rewritten every frame can be kept once per frame in flight and indexed by this.
+		/// </summary>
+		/// <returns> The current frame index. </returns>
+		const std::size_t &GetCurrentFrame() const { return m_currentFrame; }
+
+		/// <summary>
+		/// The file the pipeline cache is kept in between runs, relative to the working directory.
+		/// </summary>
+		static const std::string PipelineCachePath;
+	private:
 		void CreatePipelineCache();
 
+		/// <summary>
+		/// Writes the pipeline cache to disk, prefixed by the device and driver it is valid for.
+		/// </summary>
+		void SavePipelineCache();
+
+		std::vector<char> GetPipelineCacheHeader() const;
+
 		void RecreatePass(RenderStage &renderStage);
 
 		void RecreateAttachmentsMap();
 
-		bool StartRenderpass(RenderStage &renderStage);
+		/// <summary>
+		/// Begins the frames command buffer if needed, records the pre render work of the renderpass pipelines, then starts the renderpass.
+		/// </summary>
+		bool StartRenderpass(RenderStage &renderStage, const uint32_t &renderpass);
 
 		void EndRenderpass(RenderStage &renderStage);
 
+		/// <summary>
+		/// Records the enabled pipelines of a subpass in parallel, then executes them from the primary command buffer in order.
+		/// </summary>
+		void RecordSubpass(const RenderStage &renderStage, const uint32_t &subpass, const std::vector<std::unique_ptr<RenderPipeline>> &renderPipelines);
+
+		/// <summary>
+		/// Takes an unused secondary command buffer of the calling thread for the current frame.
+		/// </summary>
+		CommandBuffer &GetSecondaryBuffer();
+
+		struct SecondaryBuffers
+		{
+			std::vector<std::unique_ptr<CommandBuffer>> m_commandBuffers;
+			std::size_t m_used = 0;
+		};
+
 		std::unique_ptr<RenderManager> m_renderManager;
 		std::vector<std::unique_ptr<RenderStage>> m_renderStages;
 		std::map<std::string, const Descriptor *> m_attachments;
 		std::unique_ptr<Swapchain> m_swapchain;
 
 		VkPipelineCache m_pipelineCache;
-		VkCommandPool m_commandPool;
+		std::map<std::thread::id, std::shared_ptr<CommandPool>> m_commandPools;
+		std::map<std::pair<std::thread::id, std::size_t>, SecondaryBuffers> m_secondaryBuffers;
+		std::mutex m_commandPoolMutex;
 		std::vector<VkSemaphore> m_presentCompletes;
 		std::vector<VkSemaphore> m_renderCompletes;
 		std::vector<VkFence> m_flightFences;
@@ -101,5 +159,9 @@ namespace acid
 		std::unique_ptr<PhysicalDevice> m_physicalDevice;
 		std::unique_ptr<Surface> m_surface;
 		std::unique_ptr<LogicalDevice> m_logicalDevice;
+		std::unique_ptr<MemoryAllocator> m_memoryAllocator;
+		std::unique_ptr<RingBuffer> m_ringBuffer;
+		std::unique_ptr<InstancePool> m_instancePool;
+		std::unique_ptr<UploadManager> m_uploadManager;
 	};
 }
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "Helpers/Delegate.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// A handle to a resource being loaded by <seealso cref="Resources#LoadAsync"/>. The handle can be used right away, it resolves to the fallback until the resource has loaded.
+	/// Copies of a handle share the same load.
+	/// </summary>
+	/// <param name="T"> The resource type. </param>
+	template<typename T>
+	class AsyncResource
+	{
+	public:
+		/// <summary>
+		/// Creates a new handle.
+		/// </summary>
+		/// <param name="fallback"> The resource used until the load has finished, may be nullptr. </param>
+		explicit AsyncResource(std::shared_ptr<T> fallback = nullptr) :
+			m_state(std::make_shared<State>())
+		{
+			m_state->m_fallback = std::move(fallback);
+		}
+
+		/// <summary>
+		/// Gets the loaded resource, or the fallback if it has not loaded yet.
+		/// </summary>
+		/// <returns> The resource to use. </returns>
+		std::shared_ptr<T> Get() const
+		{
+			if (m_state->m_loaded.load(std::memory_order_acquire))
+			{
+				return m_state->m_resource;
+			}
+
+			return m_state->m_fallback;
+		}
+
+		/// <summary>
+		/// Gets if the resource has loaded, and <seealso cref="#Get"/> no longer returns the fallback.
+		/// </summary>
+		/// <returns> If the resource has loaded. </returns>
+		bool IsLoaded() const { return m_state->m_loaded.load(std::memory_order_acquire); }
+
+		/// <summary>
+		/// Gets the delegate called on the main thread when the resource has loaded, it is not called for loads that finished before connecting.
+		/// </summary>
+		/// <returns> The delegate. </returns>
+		Delegate<void(std::shared_ptr<T>)> &GetOnLoaded() { return m_state->m_onLoaded; }
+
+		T *operator->() const { return Get().get(); }
+
+		explicit operator bool() const { return Get() != nullptr; }
+	private:
+		friend class Resources;
+
+		struct State
+		{
+			std::shared_ptr<T> m_fallback;
+			std::shared_ptr<T> m_resource;
+			std::atomic<bool> m_loaded{false};
+			Delegate<void(std::shared_ptr<T>)> m_onLoaded;
+		};
+
+		void SetLoaded(const std::shared_ptr<T> &resource) const
+		{
+			m_state->m_resource = resource;
+			m_state->m_loaded.store(true, std::memory_order_release);
+			m_state->m_onLoaded(resource);
+		}
+
+		std::shared_ptr<State> m_state;
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include "Engine/Exports.hpp"
 
 namespace acid
@@ -16,6 +17,14 @@ namespace acid
 
 		virtual ~Resource() = default;
 
+		/// <summary>
+		/// Used by asynchronous loads after the resource has been decoded and before it is loaded, may be called from a worker thread.
+		/// Implementations read and decode their files here so <seealso cref="#Load"/> only has to create device objects.
+		/// </summary>
+		virtual void Prepare()
+		{
+		}
+
 		/// <summary>
 		/// Used by the resource after it has been decoded, and in constructors.
 		/// </summary>
@@ -23,6 +32,18 @@ namespace acid
 		{
 		}
 
+		/// <summary>
+		/// Gets the amount of host memory used by this resource, used for resource budgets.
+		/// </summary>
+		/// <returns> The size in bytes. </returns>
+		virtual std::size_t GetCpuSize() const { return 0; }
+
+		/// <summary>
+		/// Gets the amount of device memory used by this resource, used for resource budgets.
+		/// </summary>
+		/// <returns> The size in bytes. </returns>
+		virtual std::size_t GetGpuSize() const { return 0; }
+
 		/// <summary>
 		/// Used to decode this resource from a loaded data format.
 		/// </summary>
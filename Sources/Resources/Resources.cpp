@@ -1,76 +1,357 @@
 #include "Resources.hpp"
 
+#include <algorithm>
+#include <tuple>
+
 namespace acid
 {
 	Resources::Resources() :
-		m_timerPurge(Time::Seconds(4.0f))
+		m_timerPurge(Time::Seconds(1.0f)),
+		m_keepAlive(Time::Seconds(30.0f)),
+		m_hits(0),
+		m_misses(0),
+		m_loadBudget(Time::Milliseconds(4))
 	{
+		AddWrite<Resources>();
+		// Prepared resources are loaded on the main thread, where device queues are used.
+		SetMainThread(true);
 	}
 
 	void Resources::Update()
 	{
+		UpdateLoads();
+
 		if (m_timerPurge.IsPassedTime())
 		{
 			m_timerPurge.ResetStartTime();
+			Purge();
+		}
+	}
+
+	std::shared_ptr<Resource> Resources::Find(const Metadata &metadata) const
+	{
+		return FindCounted(metadata, nullptr);
+	}
+
+	std::shared_ptr<Resource> Resources::Find(const Metadata &metadata, const std::type_index &type) const
+	{
+		return FindCounted(metadata, &type);
+	}
+
+	void Resources::Add(const Metadata &metadata, const std::shared_ptr<Resource> &resource)
+	{
+		auto hash = metadata.GetHash();
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+		if (Find(metadata, hash) != m_resources.end())
+		{
+			return;
+		}
+
+		m_resources.emplace(std::piecewise_construct, std::forward_as_tuple(hash),
+			std::forward_as_tuple(std::unique_ptr<Metadata>(metadata.Clone()), resource, Engine::GetTime().AsMicroseconds()));
+	}
+
+	void Resources::Remove(const std::shared_ptr<Resource> &resource)
+	{
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+		for (auto it = m_resources.begin(); it != m_resources.end();)
+		{
+			if ((*it).second.m_resource == resource)
+			{
+				it = m_resources.erase(it);
+				continue;
+			}
+
+			++it;
+		}
+	}
+
+	void Resources::LoadAsync(const Metadata &metadata, const std::function<std::shared_ptr<Resource>()> &create, const std::function<void(const std::shared_ptr<Resource> &)> &onLoaded)
+	{
+		auto hash = metadata.GetHash();
+		std::shared_ptr<Resource> found = nullptr;
 
-			std::lock_guard<std::mutex> lock(m_mutex);
+		{
+			std::lock_guard<std::mutex> loadsLock(m_loadsMutex);
+
+			{
+				std::shared_lock<std::shared_mutex> lock(m_mutex);
+				auto it = Find(metadata, hash);
+
+				if (it != m_resources.end())
+				{
+					found = it->second.m_resource;
+				}
+			}
 
-			for (auto it = m_resources.begin(); it != m_resources.end();)
+			if (found == nullptr)
 			{
-				if ((*it).second.use_count() <= 1)
+				for (const auto &load : m_loads)
 				{
-					it = m_resources.erase(it);
-					continue;
+					if (load->m_hash == hash && *load->m_metadata == metadata)
+					{
+						load->m_onLoaded.emplace_back(onLoaded);
+						return;
+					}
 				}
 
-				++it;
+				auto load = std::make_shared<PendingLoad>();
+				load->m_hash = hash;
+				load->m_metadata.reset(metadata.Clone());
+				load->m_resource = create();
+				load->m_onLoaded.emplace_back(onLoaded);
+				m_loads.emplace_back(load);
+
+				Engine::Get()->GetThreadPool().Submit([load]()
+				{
+					load->m_resource->Decode(*load->m_metadata);
+					load->m_resource->Prepare();
+					load->m_prepared.store(true, std::memory_order_release);
+				});
+				return;
 			}
 		}
+
+		onLoaded(found);
 	}
 
-	std::shared_ptr<Resource> Resources::Find(const Metadata &metadata) const
+	uint32_t Resources::GetPendingCount()
+	{
+		std::lock_guard<std::mutex> lock(m_loadsMutex);
+		return static_cast<uint32_t>(m_loads.size());
+	}
+
+	void Resources::UpdateLoads()
 	{
-		for (const auto &[key, resource] : m_resources)
+		auto start = Engine::GetTime();
+
+		while (Engine::GetTime() - start < m_loadBudget)
 		{
-			if (*key == metadata)
+			std::shared_ptr<PendingLoad> load = nullptr;
+
+			{
+				std::lock_guard<std::mutex> lock(m_loadsMutex);
+
+				// Loads are finished in the order they were started.
+				auto it = std::find_if(m_loads.begin(), m_loads.end(), [](const std::shared_ptr<PendingLoad> &load)
+				{
+					return load->m_prepared.load(std::memory_order_acquire);
+				});
+
+				if (it == m_loads.end())
+				{
+					return;
+				}
+
+				load = *it;
+			}
+
+			// A blocking create of the same metadata may have finished first, its resource is shared instead.
+			auto resource = Find(*load->m_metadata);
+
+			if (resource == nullptr)
+			{
+				load->m_resource->Load();
+				resource = load->m_resource;
+			}
+
+			std::vector<std::function<void(const std::shared_ptr<Resource> &)>> onLoaded;
+
+			{
+				std::lock_guard<std::mutex> lock(m_loadsMutex);
+				Add(*load->m_metadata, resource);
+				m_loads.erase(std::find(m_loads.begin(), m_loads.end(), load));
+				onLoaded.swap(load->m_onLoaded);
+			}
+
+			for (const auto &function : onLoaded)
 			{
-				return resource;
+				function(resource);
 			}
 		}
+	}
 
-		return nullptr;
-		/*auto it = m_resources.find(metadata);
+	void Resources::SetBudget(const std::type_index &type, const std::optional<std::size_t> &budget)
+	{
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
 
-		if (it == m_resources.end())
+		if (budget)
+		{
+			m_budgets[type] = *budget;
+		}
+		else
 		{
-			return nullptr;
+			m_budgets.erase(type);
 		}
+	}
 
-		return it->second;*/
+	Resources::Stats Resources::GetStats() const
+	{
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+		auto result = m_totalStats;
+		result.m_hits = m_hits;
+		result.m_misses = m_misses;
+		return result;
 	}
 
-	void Resources::Add(const Metadata &metadata, const std::shared_ptr<Resource> &resource)
+	Resources::Stats Resources::GetStats(const std::type_index &type) const
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+		auto it = m_typeStats.find(type);
+		auto result = it != m_typeStats.end() ? it->second : Stats();
 
-		if (Find(metadata) != nullptr)
+		std::lock_guard<std::mutex> countersLock(m_countersMutex);
+		auto counters = m_typeCounters.find(type);
+
+		if (counters != m_typeCounters.end())
 		{
-			return;
+			result.m_hits = counters->second.first;
+			result.m_misses = counters->second.second;
 		}
 
-		m_resources.emplace(metadata.Clone(), resource);
+		return result;
 	}
 
-	void Resources::Remove(const std::shared_ptr<Resource> &resource)
+	void Resources::Purge()
+	{
+		auto now = Engine::GetTime().AsMicroseconds();
+		auto keepAlive = m_keepAlive.AsMicroseconds();
+
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+		for (auto &[type, stats] : m_typeStats)
+		{
+			stats.m_count = 0;
+			stats.m_cpuSize = 0;
+			stats.m_gpuSize = 0;
+		}
+
+		m_totalStats.m_count = 0;
+		m_totalStats.m_cpuSize = 0;
+		m_totalStats.m_gpuSize = 0;
+
+		std::vector<std::unordered_multimap<std::size_t, Entry>::iterator> unused;
+
+		auto evict = [this](const std::unordered_multimap<std::size_t, Entry>::iterator &it)
+		{
+			m_typeStats[it->second.m_type].m_evictions++;
+			m_totalStats.m_evictions++;
+			return m_resources.erase(it);
+		};
+
+		for (auto it = m_resources.begin(); it != m_resources.end();)
+		{
+			auto &entry = it->second;
+
+			if (entry.m_resource.use_count() > 1)
+			{
+				// Referenced resources count as used, so their age starts when the last reference is dropped.
+				entry.m_lastUsed.store(now, std::memory_order_relaxed);
+			}
+			else if (now - entry.m_lastUsed.load(std::memory_order_relaxed) > keepAlive)
+			{
+				it = evict(it);
+				continue;
+			}
+			else
+			{
+				unused.emplace_back(it);
+			}
+
+			auto &stats = m_typeStats[entry.m_type];
+			stats.m_count++;
+			stats.m_cpuSize += entry.m_resource->GetCpuSize();
+			stats.m_gpuSize += entry.m_resource->GetGpuSize();
+			++it;
+		}
+
+		for (const auto &[type, stats] : m_typeStats)
+		{
+			m_totalStats.m_count += stats.m_count;
+			m_totalStats.m_cpuSize += stats.m_cpuSize;
+			m_totalStats.m_gpuSize += stats.m_gpuSize;
+		}
+
+		std::sort(unused.begin(), unused.end(), [](const std::unordered_multimap<std::size_t, Entry>::iterator &a, const std::unordered_multimap<std::size_t, Entry>::iterator &b)
+		{
+			return a->second.m_lastUsed.load(std::memory_order_relaxed) < b->second.m_lastUsed.load(std::memory_order_relaxed);
+		});
+
+		for (const auto &it : unused)
+		{
+			auto &stats = m_typeStats[it->second.m_type];
+			auto budget = m_budgets.find(it->second.m_type);
+			bool overType = budget != m_budgets.end() && stats.m_cpuSize + stats.m_gpuSize > budget->second;
+			bool overTotal = m_totalBudget && m_totalStats.m_cpuSize + m_totalStats.m_gpuSize > *m_totalBudget;
+
+			if (!overType && !overTotal)
+			{
+				continue;
+			}
+
+			auto cpuSize = it->second.m_resource->GetCpuSize();
+			auto gpuSize = it->second.m_resource->GetGpuSize();
+			stats.m_count--;
+			stats.m_cpuSize -= cpuSize;
+			stats.m_gpuSize -= gpuSize;
+			m_totalStats.m_count--;
+			m_totalStats.m_cpuSize -= cpuSize;
+			m_totalStats.m_gpuSize -= gpuSize;
+			evict(it);
+		}
+	}
+
+	std::unordered_multimap<std::size_t, Resources::Entry>::const_iterator Resources::Find(const Metadata &metadata,
+		const std::size_t &hash) const
+	{
+		// Trees are only compared when their hashes collide.
+		auto [begin, end] = m_resources.equal_range(hash);
+
+		for (auto it = begin; it != end; ++it)
+		{
+			if (*it->second.m_metadata == metadata)
+			{
+				return it;
+			}
+		}
+
+		return m_resources.end();
+	}
+
+	std::shared_ptr<Resource> Resources::FindCounted(const Metadata &metadata, const std::type_index *type) const
 	{
-		std::lock_guard<std::mutex> lock(m_mutex);
+		auto hash = metadata.GetHash();
+		std::shared_ptr<Resource> result = nullptr;
 
-		for (auto it = m_resources.begin(); it != m_resources.end(); ++it) // TODO: Clean remove.
 		{
-			if ((*it).second == resource)
+			std::shared_lock<std::shared_mutex> lock(m_mutex);
+			auto it = Find(metadata, hash);
+
+			if (it != m_resources.end())
 			{
-				m_resources.erase(it);
+				it->second.m_lastUsed.store(Engine::GetTime().AsMicroseconds(), std::memory_order_relaxed);
+				result = it->second.m_resource;
 			}
 		}
+
+		if (result == nullptr)
+		{
+			m_misses++;
+		}
+		else
+		{
+			m_hits++;
+		}
+
+		if (type != nullptr)
+		{
+			std::lock_guard<std::mutex> countersLock(m_countersMutex);
+			auto &counters = m_typeCounters[*type];
+			(result == nullptr ? counters.second : counters.first)++;
+		}
+
+		return result;
 	}
 }
@@ -1,22 +1,44 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 #include "Engine/Engine.hpp"
 #include "Maths/Timer.hpp"
 #include "Serialized/Metadata.hpp"
+#include "AsyncResource.hpp"
 #include "Resource.hpp"
 
 namespace acid
 {
 	/// <summary>
-	/// A module used for managing resources.
+	/// A module used for managing resources. Resources no longer referenced outside of this module are kept for a while in case they are used again,
+	/// and are evicted least recently used first when a memory budget is exceeded.
 	/// </summary>
 	class ACID_EXPORT Resources :
 		public Module
 	{
 	public:
+		/// <summary>
+		/// Counters and memory usage of the resources.
+		/// </summary>
+		struct Stats
+		{
+			uint64_t m_hits = 0;
+			uint64_t m_misses = 0;
+			uint64_t m_evictions = 0;
+			uint32_t m_count = 0;
+			std::size_t m_cpuSize = 0;
+			std::size_t m_gpuSize = 0;
+		};
+
 		/// <summary>
 		/// Gets this engine instance.
 		/// </summary>
@@ -27,14 +49,191 @@ namespace acid
 
 		void Update() override;
 
+		/// <summary>
+		/// Finds a resource by the metadata it was added with, lookups only take a shared lock so they can run from any thread at the same time.
+		/// </summary>
+		/// <param name="metadata"> The metadata to find. </param>
+		/// <returns> The resource, or nullptr if none was found. </returns>
 		std::shared_ptr<Resource> Find(const Metadata &metadata) const;
 
+		/// <summary>
+		/// Finds a resource by the metadata it was added with, counting the hit or miss against the type.
+		/// </summary>
+		/// <param name="metadata"> The metadata to find. </param>
+		/// <param name="type"> The resource type being looked up. </param>
+		/// <returns> The resource, or nullptr if none was found. </returns>
+		std::shared_ptr<Resource> Find(const Metadata &metadata, const std::type_index &type) const;
+
+		/// <summary>
+		/// Finds a resource by the metadata it was added with, counting the hit or miss against the type.
+		/// </summary>
+		/// <param name="T"> The resource type being looked up. </param>
+		/// <param name="metadata"> The metadata to find. </param>
+		/// <returns> The resource, or nullptr if none was found or it is not of the type. </returns>
+		template<typename T>
+		std::shared_ptr<T> Find(const Metadata &metadata) const { return std::dynamic_pointer_cast<T>(Find(metadata, typeid(T))); }
+
 		void Add(const Metadata &metadata, const std::shared_ptr<Resource> &resource);
 
 		void Remove(const std::shared_ptr<Resource> &resource);
+
+		/// <summary>
+		/// Starts loading a resource without blocking. The resource is decoded and prepared on the engines thread pool,
+		/// then loaded on the main thread during a later update, and added to the resources.
+		/// Loads of the same metadata that are already in flight are shared.
+		/// </summary>
+		/// <param name="T"> The resource type, must be default constructible without loading. </param>
+		/// <param name="metadata"> The metadata to decode the resource from. </param>
+		/// <param name="fallback"> The resource used by the handle until the load has finished. </param>
+		/// <returns> A handle to the resource. </returns>
+		template<typename T>
+		AsyncResource<T> LoadAsync(const Metadata &metadata, const std::shared_ptr<T> &fallback = nullptr)
+		{
+			AsyncResource<T> result(fallback);
+			LoadAsync(metadata, []()
+			{
+				return std::make_shared<T>();
+			}, [result](const std::shared_ptr<Resource> &resource)
+			{
+				result.SetLoaded(std::dynamic_pointer_cast<T>(resource));
+			});
+			return result;
+		}
+
+		/// <summary>
+		/// Starts loading a resource without blocking.
+		/// </summary>
+		/// <param name="metadata"> The metadata to decode the resource from. </param>
+		/// <param name="create"> Creates the empty resource, called only if no load of the metadata exists. </param>
+		/// <param name="onLoaded"> Called with the resource once it has loaded, on the main thread unless it was already loaded. </param>
+		void LoadAsync(const Metadata &metadata, const std::function<std::shared_ptr<Resource>()> &create, const std::function<void(const std::shared_ptr<Resource> &)> &onLoaded);
+
+		/// <summary>
+		/// Gets the amount of asynchronous loads that have not finished.
+		/// </summary>
+		/// <returns> The pending load count. </returns>
+		uint32_t GetPendingCount();
+
+		/// <summary>
+		/// Gets the time spent each update loading prepared resources, at least one resource is loaded per update.
+		/// </summary>
+		/// <returns> The load budget. </returns>
+		const Time &GetLoadBudget() const { return m_loadBudget; }
+
+		void SetLoadBudget(const Time &loadBudget) { m_loadBudget = loadBudget; }
+
+		/// <summary>
+		/// Sets the amount of CPU and GPU memory the resources of a type may use before unreferenced ones are evicted.
+		/// </summary>
+		/// <param name="type"> The resource type. </param>
+		/// <param name="budget"> The budget in bytes, or no value for no budget. </param>
+		void SetBudget(const std::type_index &type, const std::optional<std::size_t> &budget);
+
+		/// <summary>
+		/// Sets the amount of CPU and GPU memory the resources of a type may use before unreferenced ones are evicted.
+		/// </summary>
+		/// <param name="T"> The resource type. </param>
+		/// <param name="budget"> The budget in bytes, or no value for no budget. </param>
+		template<typename T>
+		void SetBudget(const std::optional<std::size_t> &budget) { SetBudget(typeid(T), budget); }
+
+		/// <summary>
+		/// Gets the amount of CPU and GPU memory all resources may use before unreferenced ones are evicted.
+		/// </summary>
+		/// <returns> The total budget in bytes, or no value for no budget. </returns>
+		const std::optional<std::size_t> &GetTotalBudget() const { return m_totalBudget; }
+
+		void SetTotalBudget(const std::optional<std::size_t> &totalBudget) { m_totalBudget = totalBudget; }
+
+		/// <summary>
+		/// Gets how long a unreferenced resource is kept after it was last used, even when within budget.
+		/// </summary>
+		/// <returns> The keep alive time. </returns>
+		const Time &GetKeepAlive() const { return m_keepAlive; }
+
+		void SetKeepAlive(const Time &keepAlive) { m_keepAlive = keepAlive; }
+
+		/// <summary>
+		/// Gets the counters and memory usage of all resources, the usage is measured each purge.
+		/// </summary>
+		/// <returns> The stats. </returns>
+		Stats GetStats() const;
+
+		/// <summary>
+		/// Gets the counters and memory usage of the resources of a type, the usage is measured each purge.
+		/// </summary>
+		/// <param name="type"> The resource type. </param>
+		/// <returns> The stats, hits and misses are only counted for typed lookups. </returns>
+		Stats GetStats(const std::type_index &type) const;
 	private:
-		std::mutex m_mutex;
-		std::map<std::unique_ptr<Metadata>, std::shared_ptr<Resource>> m_resources;
+		struct Entry
+		{
+			Entry(std::unique_ptr<Metadata> metadata, std::shared_ptr<Resource> resource, const int64_t &lastUsed) :
+				m_metadata(std::move(metadata)),
+				m_resource(std::move(resource)),
+				m_type(typeid(*m_resource)),
+				m_lastUsed(lastUsed)
+			{
+			}
+
+			std::unique_ptr<Metadata> m_metadata;
+			std::shared_ptr<Resource> m_resource;
+			std::type_index m_type;
+			mutable std::atomic<int64_t> m_lastUsed;
+		};
+
+		struct PendingLoad
+		{
+			std::size_t m_hash;
+			std::unique_ptr<Metadata> m_metadata;
+			std::shared_ptr<Resource> m_resource;
+			std::vector<std::function<void(const std::shared_ptr<Resource> &)>> m_onLoaded;
+			std::atomic<bool> m_prepared{false};
+		};
+
+		/// <summary>
+		/// Loads prepared resources on the main thread until the load budget is used.
+		/// </summary>
+		void UpdateLoads();
+
+		/// <summary>
+		/// Measures the memory used by resources, and evicts unreferenced resources that have expired or are over budget.
+		/// </summary>
+		void Purge();
+
+		/// <summary>
+		/// Finds the entry of a metadata tree, must be called with the resources locked.
+		/// </summary>
+		/// <param name="metadata"> The metadata to find. </param>
+		/// <param name="hash"> The metadatas structural hash. </param>
+		/// <returns> The entry, or the end of the resources. </returns>
+		std::unordered_multimap<std::size_t, Entry>::const_iterator Find(const Metadata &metadata, const std::size_t &hash) const;
+
+		/// <summary>
+		/// Finds a resource and counts the hit or miss, against the type if one is given.
+		/// </summary>
+		/// <param name="metadata"> The metadata to find. </param>
+		/// <param name="type"> The resource type being looked up, or nullptr to only count the totals. </param>
+		/// <returns> The resource, or nullptr if none was found. </returns>
+		std::shared_ptr<Resource> FindCounted(const Metadata &metadata, const std::type_index *type) const;
+
+		mutable std::shared_mutex m_mutex;
+		std::unordered_multimap<std::size_t, Entry> m_resources;
 		Timer m_timerPurge;
+
+		std::map<std::type_index, std::size_t> m_budgets;
+		std::optional<std::size_t> m_totalBudget;
+		Time m_keepAlive;
+
+		mutable std::atomic<uint64_t> m_hits;
+		mutable std::atomic<uint64_t> m_misses;
+		mutable std::mutex m_countersMutex;
+		mutable std::map<std::type_index, std::pair<uint64_t, uint64_t>> m_typeCounters;
+		std::map<std::type_index, Stats> m_typeStats;
+		Stats m_totalStats;
+
+		std::mutex m_loadsMutex;
+		std::vector<std::shared_ptr<PendingLoad>> m_loads;
+		Time m_loadBudget;
 	};
 }
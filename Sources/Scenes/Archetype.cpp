@@ -0,0 +1,79 @@
+#include "Archetype.hpp"
+
+#include <algorithm>
+#include <utility>
+#include "Entity.hpp"
+
+namespace acid
+{
+	Archetype::Archetype(std::vector<ComponentId> signature) :
+		m_signature(std::move(signature)),
+		m_columns(m_signature.size()),
+		m_dirty(false)
+	{
+	}
+
+	void Archetype::Add(Entity *entity)
+	{
+		entity->m_archetype = this;
+		entity->m_archetypeIndex = static_cast<uint32_t>(m_entities.size());
+		m_entities.emplace_back(entity);
+		m_dirty = true;
+	}
+
+	void Archetype::Remove(Entity *entity)
+	{
+		auto index = entity->m_archetypeIndex;
+		auto last = m_entities.back();
+		m_entities[index] = last;
+		last->m_archetypeIndex = index;
+		m_entities.pop_back();
+
+		entity->m_archetype = nullptr;
+		m_dirty = true;
+	}
+
+	bool Archetype::Has(const ComponentId &id) const
+	{
+		return std::binary_search(m_signature.begin(), m_signature.end(), id);
+	}
+
+	const std::vector<void *> &Archetype::GetColumn(const ComponentId &id)
+	{
+		if (m_dirty)
+		{
+			Rebuild();
+		}
+
+		auto it = std::lower_bound(m_signature.begin(), m_signature.end(), id);
+		return m_columns[it - m_signature.begin()];
+	}
+
+	void Archetype::Rebuild()
+	{
+		for (auto &column : m_columns)
+		{
+			column.clear();
+		}
+
+		for (const auto &entity : m_entities)
+		{
+			// Matches are sorted by id, so the column index only moves forward.
+			auto column = m_signature.begin();
+
+			for (const auto &[id, component] : entity->m_matches)
+			{
+				column = std::lower_bound(column, m_signature.end(), id);
+
+				if (column == m_signature.end() || *column != id)
+				{
+					continue;
+				}
+
+				m_columns[column - m_signature.begin()].emplace_back(component);
+			}
+		}
+
+		m_dirty = false;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include "Helpers/NonCopyable.hpp"
+#include "ComponentTypes.hpp"
+
+namespace acid
+{
+	class Entity;
+
+	/// <summary>
+	/// A group of entities that share the same component signature. The components of each type in the signature are packed into a dense column.
+	/// </summary>
+	class ACID_EXPORT Archetype :
+		public NonCopyable
+	{
+	public:
+		/// <summary>
+		/// Creates a new archetype.
+		/// </summary>
+		/// <param name="signature"> The sorted component type ids every entity in this archetype has. </param>
+		explicit Archetype(std::vector<ComponentId> signature);
+
+		/// <summary>
+		/// Adds a entity to this archetype.
+		/// </summary>
+		/// <param name="entity"> The entity to add. </param>
+		void Add(Entity *entity);
+
+		/// <summary>
+		/// Removes a entity from this archetype, the last entity is swapped into its place.
+		/// </summary>
+		/// <param name="entity"> The entity to remove. </param>
+		void Remove(Entity *entity);
+
+		/// <summary>
+		/// Marks the columns to be rebuilt, used when a entities components changed without changing its signature.
+		/// </summary>
+		void SetDirty() { m_dirty = true; }
+
+		/// <summary>
+		/// Gets if the signature contains a component type.
+		/// </summary>
+		/// <param name="id"> The component type id. </param>
+		/// <returns> If the type is in the signature. </returns>
+		bool Has(const ComponentId &id) const;
+
+		/// <summary>
+		/// Gets the dense column of components of a type, each pointer is already cast to the type.
+		/// </summary>
+		/// <param name="id"> The component type id, must be in the signature. </param>
+		/// <returns> The components column. </returns>
+		const std::vector<void *> &GetColumn(const ComponentId &id);
+
+		const std::vector<ComponentId> &GetSignature() const { return m_signature; }
+
+		const std::vector<Entity *> &GetEntities() const { return m_entities; }
+	private:
+		void Rebuild();
+
+		std::vector<ComponentId> m_signature;
+		std::vector<Entity *> m_entities;
+		std::vector<std::vector<void *>> m_columns;
+		bool m_dirty;
+	};
+}
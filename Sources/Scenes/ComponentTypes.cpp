@@ -0,0 +1,64 @@
+#include "ComponentTypes.hpp"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace acid
+{
+	struct ComponentTypesData
+	{
+		std::mutex m_mutex;
+		std::map<std::type_index, ComponentId> m_ids;
+		std::vector<std::function<void *(Component *)>> m_casts;
+		std::atomic<uint32_t> m_count;
+	};
+
+	static ComponentTypesData &GetData()
+	{
+		static ComponentTypesData data;
+		return data;
+	}
+
+	uint32_t ComponentTypes::GetCount()
+	{
+		return GetData().m_count.load(std::memory_order_acquire);
+	}
+
+	uint32_t ComponentTypes::Match(Component *component, std::vector<std::pair<ComponentId, void *>> &matches)
+	{
+		auto &data = GetData();
+		std::lock_guard<std::mutex> lock(data.m_mutex);
+
+		for (ComponentId id = 0; id < data.m_casts.size(); id++)
+		{
+			auto casted = data.m_casts[id](component);
+
+			if (casted != nullptr)
+			{
+				matches.emplace_back(id, casted);
+			}
+		}
+
+		return static_cast<uint32_t>(data.m_casts.size());
+	}
+
+	ComponentId ComponentTypes::Register(const std::type_index &type, const std::function<void *(Component *)> &cast)
+	{
+		auto &data = GetData();
+		std::lock_guard<std::mutex> lock(data.m_mutex);
+
+		auto it = data.m_ids.find(type);
+
+		if (it != data.m_ids.end())
+		{
+			return it->second;
+		}
+
+		auto id = static_cast<ComponentId>(data.m_casts.size());
+		data.m_ids.emplace(type, id);
+		data.m_casts.emplace_back(cast);
+		data.m_count.store(static_cast<uint32_t>(data.m_casts.size()), std::memory_order_release);
+		return id;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <typeindex>
+#include <utility>
+#include <vector>
+#include "Engine/Exports.hpp"
+
+namespace acid
+{
+	class Component;
+
+	/// <summary>
+	/// A id that represents a component type, or a base type shared between components.
+	/// </summary>
+	using ComponentId = uint32_t;
+
+	/// <summary>
+	/// A registry that assigns ids to component types. Each type looks up its id once, after that type checks are a integer compare instead of a dynamic cast.
+	/// </summary>
+	class ACID_EXPORT ComponentTypes
+	{
+	public:
+		/// <summary>
+		/// Gets the id of a component type, the id is cached per type after the first call.
+		/// </summary>
+		/// <param name="T"> The component type, may be a base class of components. </param>
+		/// <returns> The types id. </returns>
+		template<typename T>
+		static ComponentId Get()
+		{
+			static const ComponentId id = Register(typeid(T), [](Component *component) -> void *
+			{
+				return dynamic_cast<T *>(component);
+			});
+			return id;
+		}
+
+		/// <summary>
+		/// Gets the amount of types that have been registered.
+		/// </summary>
+		/// <returns> The registered type count. </returns>
+		static uint32_t GetCount();
+
+		/// <summary>
+		/// Finds every registered type a component can be cast to.
+		/// </summary>
+		/// <param name="component"> The component to match. </param>
+		/// <param name="matches"> The list the type ids and cast component pointers will be appended to. </param>
+		/// <returns> The registered type count the component was matched against. </returns>
+		static uint32_t Match(Component *component, std::vector<std::pair<ComponentId, void *>> &matches);
+	private:
+		/// <summary>
+		/// Registers a type, types are keyed by their type index so all modules share the same id.
+		/// </summary>
+		/// <param name="type"> The types index. </param>
+		/// <param name="cast"> A function that casts a component to the type, or returns nullptr. </param>
+		/// <returns> The types id. </returns>
+		static ComponentId Register(const std::type_index &type, const std::function<void *(Component *)> &cast);
+	};
+}
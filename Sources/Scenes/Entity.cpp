@@ -1,16 +1,28 @@
 #include "Entity.hpp"
 
+#include <algorithm>
+#include <mutex>
 #include "Files/FileSystem.hpp"
 #include "Scenes.hpp"
+#include "EntityCommands.hpp"
 #include "EntityPrefab.hpp"
+#include "SceneStructure.hpp"
 
 namespace acid
 {
+	static std::mutex WORLD_TRANSFORM_MUTEX;
+
 	Entity::Entity(const Transform &transform) :
 		m_name(""),
 		m_localTransform(transform),
+		m_worldDirty(true),
 		m_parent(nullptr),
-		m_removed(false)
+		m_removed(false),
+		m_matchesCount(0),
+		m_structure(nullptr),
+		m_archetype(nullptr),
+		m_archetypeIndex(0),
+		m_restructure(false)
 	{
 	}
 
@@ -50,31 +62,43 @@ namespace acid
 
 	void Entity::Update()
 	{
-		for (auto it = m_components.begin(); it != m_components.end();)
+		// Removed components are only erased after the loop, the matches still point at them until they are rebuilt.
+		for (std::size_t i = 0; i < m_components.size(); i++)
 		{
-			if ((*it)->IsRemoved())
+			auto component = m_components[i].get();
+
+			if (component->IsRemoved())
 			{
-				it = m_components.erase(it);
 				continue;
 			}
 
-			if ((*it)->GetParent() != this)
+			if (component->GetParent() != this)
 			{
-				(*it)->SetParent(this);
+				component->SetParent(this);
 			}
 
-			if ((*it)->IsEnabled())
+			if (component->IsEnabled())
 			{
-				if (!(*it)->m_started)
+				if (!component->m_started)
 				{
-					(*it)->Start();
-					(*it)->m_started = true;
+					component->Start();
+					component->m_started = true;
 				}
 
-				(*it)->Update();
+				component->Update();
 			}
+		}
 
-			++it;
+		// Components can be removed by a later component in the same update, so every component is checked again.
+		auto removed = std::remove_if(m_components.begin(), m_components.end(), [](const std::unique_ptr<Component> &c)
+		{
+			return c->IsRemoved();
+		});
+
+		if (removed != m_components.end())
+		{
+			m_components.erase(removed, m_components.end());
+			UpdateMatches();
 		}
 	}
 
@@ -85,35 +109,77 @@ namespace acid
 			return nullptr;
 		}
 
+		if (auto commands = GetCommands(); commands != nullptr)
+		{
+			commands->AddComponent(this, component);
+			return component;
+		}
+
 		component->SetParent(this);
 		m_components.emplace_back(component);
+		UpdateMatches();
 		return component;
 	}
 
 	void Entity::RemoveComponent(Component *component)
 	{
+		if (auto commands = GetCommands(); commands != nullptr)
+		{
+			commands->RemoveComponent(this, component);
+			return;
+		}
+
 		m_components.erase(std::remove_if(m_components.begin(), m_components.end(), [&](std::unique_ptr<Component> &c)
 		{
 			return c.get() == component;
 		}), m_components.end());
+		UpdateMatches();
 	}
 
 	void Entity::RemoveComponent(const std::string &name)
 	{
-		m_components.erase(std::remove_if(m_components.begin(), m_components.end(), [&](std::unique_ptr<Component> &c)
+		auto matches = [&](const std::unique_ptr<Component> &c)
 		{
 			auto componentName = Scenes::Get()->GetComponentRegister().FindName(c.get());
 			return componentName && name == *componentName;
-		}), m_components.end());
+		};
+
+		if (auto commands = GetCommands(); commands != nullptr)
+		{
+			for (const auto &component : m_components)
+			{
+				if (matches(component))
+				{
+					commands->RemoveComponent(this, component.get());
+				}
+			}
+
+			return;
+		}
+
+		m_components.erase(std::remove_if(m_components.begin(), m_components.end(), matches), m_components.end());
+		UpdateMatches();
+	}
+
+	const Transform &Entity::GetWorldTransform() const
+	{
+		// Components updated in parallel chunks can reach the same dirty parents, the recompute writes shared caches so it is serialized.
+		if (EntityCommands::GetRecording() != nullptr)
+		{
+			std::lock_guard<std::mutex> lock(WORLD_TRANSFORM_MUTEX);
+			return UpdateWorldTransform();
+		}
+
+		return UpdateWorldTransform();
 	}
 
-	Transform Entity::GetWorldTransform() const
+	const Transform &Entity::UpdateWorldTransform() const
 	{
-		if (m_localTransform.IsDirty())
+		if (IsWorldDirty())
 		{
 			if (m_parent != nullptr)
 			{
-				m_worldTransform = m_parent->GetWorldTransform() * m_localTransform;
+				m_worldTransform = m_parent->UpdateWorldTransform() * m_localTransform;
 			}
 			else
 			{
@@ -122,10 +188,11 @@ namespace acid
 
 			for (const auto &child : m_children)
 			{
-				child->m_localTransform.SetDirty(true);
+				child->m_worldDirty = true;
 			}
 
 			m_localTransform.SetDirty(false);
+			m_worldDirty = false;
 		}
 
 		return m_worldTransform;
@@ -133,11 +200,42 @@ namespace acid
 
 	Matrix4 Entity::GetWorldMatrix() const
 	{
-		return GetWorldTransform().GetWorldMatrix();
+		// The world transform caches its matrix, so building it is serialized the same as the transform.
+		if (EntityCommands::GetRecording() != nullptr)
+		{
+			std::lock_guard<std::mutex> lock(WORLD_TRANSFORM_MUTEX);
+			return UpdateWorldTransform().GetWorldMatrix();
+		}
+
+		return UpdateWorldTransform().GetWorldMatrix();
+	}
+
+	void Entity::SetRemoved(const bool &removed)
+	{
+		if (auto commands = GetCommands(); commands != nullptr)
+		{
+			commands->SetRemoved(this, removed);
+			return;
+		}
+
+		m_removed = removed;
 	}
 
 	void Entity::SetParent(Entity *parent)
 	{
+		if (auto commands = GetCommands(); commands != nullptr)
+		{
+			commands->SetParent(this, parent);
+			return;
+		}
+
+		if (m_structure != nullptr)
+		{
+			m_structure->m_hierarchy.MarkRelink();
+		}
+
+		m_worldDirty = true;
+
 		if (m_parent != nullptr)
 		{
 			m_parent->RemoveChild(this);
@@ -160,4 +258,69 @@ namespace acid
 	{
 		m_children.erase(std::remove(m_children.begin(), m_children.end(), child), m_children.end());
 	}
+
+	void Entity::UpdateMatches()
+	{
+		m_matches.clear();
+		m_matchesCount = ComponentTypes::GetCount();
+
+		for (const auto &component : m_components)
+		{
+			// Types registered while matching were not tested against the earlier components.
+			m_matchesCount = std::min(m_matchesCount, ComponentTypes::Match(component.get(), m_matches));
+		}
+
+		// Groups the matches by type, keeping the component order within each type.
+		std::stable_sort(m_matches.begin(), m_matches.end(), [](const std::pair<ComponentId, void *> &a, const std::pair<ComponentId, void *> &b)
+		{
+			return a.first < b.first;
+		});
+
+		m_signature.clear();
+
+		for (const auto &[id, component] : m_matches)
+		{
+			if (m_signature.empty() || m_signature.back() != id)
+			{
+				m_signature.emplace_back(id);
+			}
+		}
+
+		if (m_structure != nullptr)
+		{
+			m_structure->MarkRestructure(this);
+		}
+	}
+
+	EntityCommands *Entity::GetCommands() const
+	{
+		// Entities outside of a structure are not visible to other jobs, so they are changed immediately.
+		if (m_structure == nullptr)
+		{
+			return nullptr;
+		}
+
+		return EntityCommands::GetRecording();
+	}
+
+	bool Entity::IsWorldDirty() const
+	{
+		for (auto entity = this; entity != nullptr; entity = entity->m_parent)
+		{
+			if (entity->m_localTransform.IsDirty() || entity->m_worldDirty)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::vector<std::pair<ComponentId, void *>>::const_iterator Entity::FindMatches(const ComponentId &id) const
+	{
+		return std::lower_bound(m_matches.begin(), m_matches.end(), id, [](const std::pair<ComponentId, void *> &a, const ComponentId &b)
+		{
+			return a.first < b;
+		});
+	}
 }
@@ -5,9 +5,14 @@
 #include "Helpers/NonCopyable.hpp"
 #include "Maths/Transform.hpp"
 #include "Component.hpp"
+#include "ComponentTypes.hpp"
 
 namespace acid
 {
+	class Archetype;
+	class EntityCommands;
+	class SceneStructure;
+
 	/// <summary>
 	/// A class that represents a objects that acts as a component container.
 	/// </summary>
@@ -54,21 +59,41 @@ namespace acid
 		T *GetComponent(const bool &allowDisabled = false) const
 		{
 			T *alternative = nullptr;
+			auto id = ComponentTypes::Get<T>();
 
-			for (const auto &component : m_components)
+			if (id >= m_matchesCount)
 			{
-				auto casted = dynamic_cast<T *>(component.get());
-
-				if (casted != nullptr)
+				// The type was registered after the matches were built.
+				for (const auto &component : m_components)
 				{
-					if (allowDisabled && !casted->IsEnabled())
+					auto casted = dynamic_cast<T *>(component.get());
+
+					if (casted != nullptr)
 					{
-						alternative = casted;
-						continue;
+						if (allowDisabled && !casted->IsEnabled())
+						{
+							alternative = casted;
+							continue;
+						}
+
+						return casted;
 					}
+				}
 
-					return casted;
+				return alternative;
+			}
+
+			for (auto it = FindMatches(id); it != m_matches.end() && it->first == id; ++it)
+			{
+				auto casted = static_cast<T *>(it->second);
+
+				if (allowDisabled && !casted->IsEnabled())
+				{
+					alternative = casted;
+					continue;
 				}
+
+				return casted;
 			}
 
 			return alternative;
@@ -84,21 +109,26 @@ namespace acid
 		std::vector<T *> GetComponents(const bool &allowDisabled = false) const
 		{
 			std::vector<T *> result = {};
+			auto id = ComponentTypes::Get<T>();
 
-			for (const auto &component : m_components)
+			if (id >= m_matchesCount)
 			{
-				auto casted = dynamic_cast<T *>(component.get());
-
-				if (casted != nullptr)
+				for (const auto &component : m_components)
 				{
-					if (allowDisabled && !casted->IsEnabled())
+					auto casted = dynamic_cast<T *>(component.get());
+
+					if (casted != nullptr)
 					{
 						result.emplace_back(casted);
-						continue;
 					}
-
-					result.emplace_back(casted);
 				}
+
+				return result;
+			}
+
+			for (auto it = FindMatches(id); it != m_matches.end() && it->first == id; ++it)
+			{
+				result.emplace_back(static_cast<T *>(it->second));
 			}
 
 			return result;
@@ -147,15 +177,9 @@ namespace acid
 		template<typename T>
 		void RemoveComponent()
 		{
-			for (auto it = m_components.begin(); it != m_components.end(); ++it)
+			for (const auto &component : GetComponents<T>(true))
 			{
-				auto casted = dynamic_cast<T *>((*it).get());
-
-				if (casted != nullptr)
-				{
-					(*it)->SetParent(nullptr);
-					m_components.erase(it);
-				}
+				RemoveComponent(component);
 			}
 		}
 
@@ -165,15 +189,24 @@ namespace acid
 
 		Transform &GetLocalTransform() { return m_localTransform; }
 
-		void SetLocalTransform(const Transform &localTransform) { m_localTransform = localTransform; }
+		void SetLocalTransform(const Transform &localTransform)
+		{
+			m_localTransform = localTransform;
+			m_worldDirty = true;
+		}
 
-		Transform GetWorldTransform() const;
+		/// <summary>
+		/// Gets the cached world transform, it is only recomputed if the local transform of this entity or of a parent changed.
+		/// The transforms of entities in a structure are brought up to date once per frame by its <seealso cref="TransformHierarchy"/>.
+		/// </summary>
+		/// <returns> The world transform. </returns>
+		const Transform &GetWorldTransform() const;
 
 		Matrix4 GetWorldMatrix() const;
 
 		const bool &IsRemoved() const { return m_removed; }
 
-		void SetRemoved(const bool &removed) { m_removed = removed; }
+		void SetRemoved(const bool &removed);
 
 		Entity *GetParent() const { return m_parent; }
 
@@ -184,13 +217,58 @@ namespace acid
 		void AddChild(Entity *child);
 
 		void RemoveChild(Entity *child);
+
+		/// <summary>
+		/// Gets the sorted ids of every component type this entity matches, used to group entities into archetypes.
+		/// </summary>
+		/// <returns> The component signature. </returns>
+		const std::vector<ComponentId> &GetSignature() const { return m_signature; }
 	private:
+		friend class Archetype;
+		friend class SceneStructure;
+		friend class TransformHierarchy;
+		friend class ViewBase;
+
+		/// <summary>
+		/// Rebuilds the matched component types after the components or the registered types changed.
+		/// </summary>
+		void UpdateMatches();
+
+		/// <summary>
+		/// Gets the buffer structural changes to this entity are deferred into while its structure is updating.
+		/// </summary>
+		/// <returns> The recording buffer, or nullptr if changes are applied immediately. </returns>
+		EntityCommands *GetCommands() const;
+
+		/// <summary>
+		/// Gets if the cached world transform is out of date, walking up the parents.
+		/// </summary>
+		/// <returns> If the world transform needs to be recomputed. </returns>
+		bool IsWorldDirty() const;
+
+		/// <summary>
+		/// Recomputes the cached world transform and the parents it depends on if any are out of date, the caller serializes access.
+		/// </summary>
+		/// <returns> The world transform. </returns>
+		const Transform &UpdateWorldTransform() const;
+
+		std::vector<std::pair<ComponentId, void *>>::const_iterator FindMatches(const ComponentId &id) const;
+
 		std::string m_name;
 		Transform m_localTransform;
 		mutable Transform m_worldTransform;
+		mutable bool m_worldDirty;
 		std::vector<std::unique_ptr<Component>> m_components;
 		Entity *m_parent;
 		std::vector<Entity *> m_children;
 		bool m_removed;
+
+		std::vector<std::pair<ComponentId, void *>> m_matches;
+		std::vector<ComponentId> m_signature;
+		uint32_t m_matchesCount;
+		SceneStructure *m_structure;
+		Archetype *m_archetype;
+		uint32_t m_archetypeIndex;
+		bool m_restructure;
 	};
 }
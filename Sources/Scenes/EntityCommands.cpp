@@ -0,0 +1,71 @@
+#include "EntityCommands.hpp"
+
+#include "Entity.hpp"
+
+namespace acid
+{
+	static thread_local EntityCommands *RECORDING = nullptr;
+
+	EntityCommands::Recorder::Recorder(EntityCommands *commands) :
+		m_previous(RECORDING)
+	{
+		RECORDING = commands;
+	}
+
+	EntityCommands::Recorder::~Recorder()
+	{
+		RECORDING = m_previous;
+	}
+
+	EntityCommands *EntityCommands::GetRecording()
+	{
+		return RECORDING;
+	}
+
+	void EntityCommands::AddComponent(Entity *entity, Component *component)
+	{
+		m_commands.emplace_back(Command{Type::AddComponent, entity, std::unique_ptr<Component>(component), nullptr, nullptr, false});
+	}
+
+	void EntityCommands::RemoveComponent(Entity *entity, Component *component)
+	{
+		m_commands.emplace_back(Command{Type::RemoveComponent, entity, nullptr, component, nullptr, false});
+	}
+
+	void EntityCommands::SetRemoved(Entity *entity, const bool &removed)
+	{
+		m_commands.emplace_back(Command{Type::SetRemoved, entity, nullptr, nullptr, nullptr, removed});
+	}
+
+	void EntityCommands::SetParent(Entity *entity, Entity *parent)
+	{
+		m_commands.emplace_back(Command{Type::SetParent, entity, nullptr, nullptr, parent, false});
+	}
+
+	void EntityCommands::Apply()
+	{
+		// Changes made while applying are applied immediately, not recorded into another buffer.
+		Recorder recorder(nullptr);
+
+		for (auto &command : m_commands)
+		{
+			switch (command.m_type)
+			{
+			case Type::AddComponent:
+				command.m_entity->AddComponent(command.m_added.release());
+				break;
+			case Type::RemoveComponent:
+				command.m_entity->RemoveComponent(command.m_removed);
+				break;
+			case Type::SetRemoved:
+				command.m_entity->SetRemoved(command.m_flag);
+				break;
+			case Type::SetParent:
+				command.m_entity->SetParent(command.m_parent);
+				break;
+			}
+		}
+
+		m_commands.clear();
+	}
+}
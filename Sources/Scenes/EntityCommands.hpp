@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Helpers/NonCopyable.hpp"
+#include "Component.hpp"
+
+namespace acid
+{
+	class Entity;
+
+	/// <summary>
+	/// A buffer of structural changes to entities, recorded while a <seealso cref="SceneStructure"/> is updating in parallel chunks and applied in recorded order at its sync point.
+	/// While a buffer is recording on a thread, entities in a structure defer adding and removing components, removal, and reparenting into it.
+	/// </summary>
+	class ACID_EXPORT EntityCommands :
+		public NonCopyable
+	{
+	public:
+		/// <summary>
+		/// Makes a buffer the recording buffer of the calling thread for its lifetime, restoring the previous buffer when destroyed.
+		/// </summary>
+		class ACID_EXPORT Recorder :
+			public NonCopyable
+		{
+		public:
+			explicit Recorder(EntityCommands *commands);
+
+			~Recorder();
+		private:
+			EntityCommands *m_previous;
+		};
+
+		EntityCommands() = default;
+
+		/// <summary>
+		/// Gets the buffer that is recording on the calling thread.
+		/// </summary>
+		/// <returns> The recording buffer, or nullptr if changes are applied immediately. </returns>
+		static EntityCommands *GetRecording();
+
+		/// <summary>
+		/// Records a component to be added to a entity, the buffer owns the component until it is applied.
+		/// </summary>
+		/// <param name="entity"> The entity to add to. </param>
+		/// <param name="component"> The component to add. </param>
+		void AddComponent(Entity *entity, Component *component);
+
+		/// <summary>
+		/// Records a component to be removed from a entity.
+		/// </summary>
+		/// <param name="entity"> The entity to remove from. </param>
+		/// <param name="component"> The component to remove. </param>
+		void RemoveComponent(Entity *entity, Component *component);
+
+		/// <summary>
+		/// Records a change to the removed state of a entity.
+		/// </summary>
+		/// <param name="entity"> The entity. </param>
+		/// <param name="removed"> If the entity will be removed. </param>
+		void SetRemoved(Entity *entity, const bool &removed);
+
+		/// <summary>
+		/// Records a change to the parent of a entity.
+		/// </summary>
+		/// <param name="entity"> The entity. </param>
+		/// <param name="parent"> The new parent, or nullptr. </param>
+		void SetParent(Entity *entity, Entity *parent);
+
+		/// <summary>
+		/// Applies every recorded change in the order it was recorded, then clears the buffer.
+		/// </summary>
+		void Apply();
+
+		bool IsEmpty() const { return m_commands.empty(); }
+	private:
+		enum class Type
+		{
+			AddComponent, RemoveComponent, SetRemoved, SetParent
+		};
+
+		struct Command
+		{
+			Type m_type;
+			Entity *m_entity;
+			std::unique_ptr<Component> m_added;
+			Component *m_removed;
+			Entity *m_parent;
+			bool m_flag;
+		};
+
+		std::vector<Command> m_commands;
+	};
+}
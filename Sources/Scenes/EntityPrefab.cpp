@@ -14,11 +14,11 @@ namespace acid
 {
 	std::shared_ptr<EntityPrefab> EntityPrefab::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<EntityPrefab>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<EntityPrefab>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<EntityPrefab>("");
@@ -84,6 +84,11 @@ namespace acid
 		metadata.SetChild("Filename", m_filename);
 	}
 
+	std::size_t EntityPrefab::GetCpuSize() const
+	{
+		return sizeof(EntityPrefab) + m_filename.capacity();
+	}
+
 	void EntityPrefab::Write(const Entity &entity)
 	{
 		m_file->GetMetadata()->ClearChildren();
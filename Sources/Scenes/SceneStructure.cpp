@@ -1,11 +1,26 @@
 ﻿#include "SceneStructure.hpp"
 
+#include <algorithm>
+#include "Engine/Engine.hpp"
 #include "Physics/Rigidbody.hpp"
 
 namespace acid
 {
-	SceneStructure::SceneStructure()
+	const uint32_t SceneStructure::UpdateGrainSize = 64;
+
+	SceneStructure::SceneStructure() :
+		m_typeCount(0),
+		m_parallel(false)
+	{
+	}
+
+	SceneStructure::~SceneStructure()
 	{
+		for (const auto &view : m_views)
+		{
+			view->m_structure = nullptr;
+			view->Clear();
+		}
 	}
 
 	Entity *SceneStructure::CreateEntity(const Transform &transform)
@@ -13,6 +28,7 @@ namespace acid
 		std::lock_guard<std::mutex> lock(m_mutex);
 		auto entity = new Entity(transform);
 		m_objects.emplace_back(entity);
+		Attach(entity);
 		return entity;
 	}
 
@@ -21,6 +37,7 @@ namespace acid
 		std::lock_guard<std::mutex> lock(m_mutex);
 		auto entity = new Entity(filename, transform);
 		m_objects.emplace_back(entity);
+		Attach(entity);
 		return entity;
 	}
 
@@ -28,11 +45,13 @@ namespace acid
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
 		m_objects.emplace_back(object);
+		Attach(object);
 	}
 
 	void SceneStructure::Add(std::unique_ptr<Entity> object)
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
+		Attach(object.get());
 		m_objects.emplace_back(std::move(object));
 	}
 
@@ -40,6 +59,11 @@ namespace acid
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
 
+		if (object->m_structure == this)
+		{
+			Detach(object);
+		}
+
 		m_objects.erase(std::remove_if(m_objects.begin(), m_objects.end(), [object](std::unique_ptr<Entity> &e)
 		{
 			return e.get() == object;
@@ -57,6 +81,7 @@ namespace acid
 				continue;
 			}
 
+			Detach(object);
 			structure.Add(std::move(*it));
 			m_objects.erase(it);
 		}
@@ -65,7 +90,27 @@ namespace acid
 	void SceneStructure::Clear()
 	{
 		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (const auto &object : m_objects)
+		{
+			object->m_structure = nullptr;
+			object->m_archetype = nullptr;
+		}
+
+		{
+			std::lock_guard<std::mutex> restructureLock(m_restructureMutex);
+			m_restructures.clear();
+		}
+
+		for (const auto &view : m_views)
+		{
+			view->Clear();
+		}
+
 		m_objects.clear();
+		m_hierarchy.MarkRelink();
+		m_archetypes.clear();
+		m_archetypeMap.clear();
 	}
 
 	void SceneStructure::Update()
@@ -76,13 +121,63 @@ namespace acid
 		{
 			if ((*it)->IsRemoved())
 			{
+				Detach((*it).get());
 				it = m_objects.erase(it);
 				continue;
 			}
 
-			(*it)->Update();
 			++it;
 		}
+
+		auto count = static_cast<uint32_t>(m_objects.size());
+		auto chunks = m_parallel ? std::max((count + UpdateGrainSize - 1) / UpdateGrainSize, 1u) : 1;
+
+		while (m_commands.size() < chunks)
+		{
+			m_commands.emplace_back(std::make_unique<EntityCommands>());
+		}
+
+		auto updateChunk = [this](const uint32_t &from, const uint32_t &to, EntityCommands *commands)
+		{
+			EntityCommands::Recorder recorder(commands);
+
+			for (auto i = from; i < to; i++)
+			{
+				m_objects[i]->Update();
+			}
+		};
+
+		if (chunks > 1)
+		{
+			// Each chunk records into its own buffer, the buffers are applied in chunk order so results do not depend on scheduling.
+			Engine::Get()->GetThreadPool().ParallelFor(0, count, [&](uint32_t from, uint32_t to)
+			{
+				updateChunk(from, to, m_commands[from / UpdateGrainSize].get());
+			}, UpdateGrainSize);
+
+			for (uint32_t i = 0; i < chunks; i++)
+			{
+				m_commands[i]->Apply();
+			}
+		}
+		else
+		{
+			// A single chunk runs on this thread alone, so structural changes are applied immediately.
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (m_objects[i]->IsRemoved())
+				{
+					continue;
+				}
+
+				m_objects[i]->Update();
+			}
+		}
+
+		m_hierarchy.Update(m_objects);
+
+		// Brings the views up to date before they are read by renderers.
+		Restructure();
 	}
 
 	std::vector<Entity *> SceneStructure::QueryAll()
@@ -152,4 +247,146 @@ namespace acid
 
 		return false;
 	}
+
+	void SceneStructure::AddView(ViewBase *view)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		view->m_structure = this;
+		m_views.emplace_back(view);
+
+		for (const auto &object : m_objects)
+		{
+			view->Patch(object.get());
+		}
+	}
+
+	void SceneStructure::RemoveView(ViewBase *view)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_views.erase(std::remove(m_views.begin(), m_views.end(), view), m_views.end());
+		view->m_structure = nullptr;
+	}
+
+	void SceneStructure::Attach(Entity *object)
+	{
+		object->m_structure = this;
+		m_hierarchy.MarkRelink();
+
+		if (object->m_matchesCount != ComponentTypes::GetCount())
+		{
+			object->UpdateMatches();
+			return;
+		}
+
+		MarkRestructure(object);
+	}
+
+	void SceneStructure::Detach(Entity *object)
+	{
+		if (object->m_archetype != nullptr)
+		{
+			object->m_archetype->Remove(object);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_restructureMutex);
+
+			if (object->m_restructure)
+			{
+				m_restructures.erase(std::remove(m_restructures.begin(), m_restructures.end(), object), m_restructures.end());
+				object->m_restructure = false;
+			}
+		}
+
+		for (const auto &view : m_views)
+		{
+			view->Erase(object);
+		}
+
+		object->m_structure = nullptr;
+		m_hierarchy.MarkRelink();
+	}
+
+	void SceneStructure::MarkRestructure(Entity *object)
+	{
+		std::lock_guard<std::mutex> lock(m_restructureMutex);
+
+		if (object->m_restructure)
+		{
+			return;
+		}
+
+		object->m_restructure = true;
+		m_restructures.emplace_back(object);
+	}
+
+	void SceneStructure::Restructure()
+	{
+		// Newly registered types may match components that were added before the type existed.
+		auto typeCount = ComponentTypes::GetCount();
+
+		if (m_typeCount != typeCount)
+		{
+			m_typeCount = typeCount;
+
+			for (const auto &object : m_objects)
+			{
+				object->UpdateMatches();
+			}
+		}
+
+		std::vector<Entity *> restructures;
+
+		{
+			std::lock_guard<std::mutex> lock(m_restructureMutex);
+			restructures.swap(m_restructures);
+
+			for (const auto &object : restructures)
+			{
+				object->m_restructure = false;
+			}
+		}
+
+		for (const auto &object : restructures)
+		{
+			for (const auto &view : m_views)
+			{
+				view->Patch(object);
+			}
+
+			if (object->m_archetype != nullptr)
+			{
+				if (object->m_archetype->GetSignature() == object->m_signature)
+				{
+					object->m_archetype->SetDirty();
+					continue;
+				}
+
+				object->m_archetype->Remove(object);
+			}
+
+			auto it = m_archetypeMap.find(object->m_signature);
+
+			if (it == m_archetypeMap.end())
+			{
+				auto archetype = m_archetypes.emplace_back(std::make_unique<Archetype>(object->m_signature)).get();
+				it = m_archetypeMap.emplace(object->m_signature, archetype).first;
+			}
+
+			it->second->Add(object);
+		}
+
+		// Archetypes left without entities are freed, signatures that come and go would otherwise keep growing the list.
+		m_archetypes.erase(std::remove_if(m_archetypes.begin(), m_archetypes.end(), [this](const std::unique_ptr<Archetype> &archetype)
+		{
+			if (!archetype->GetEntities().empty())
+			{
+				return false;
+			}
+
+			m_archetypeMap.erase(archetype->GetSignature());
+			return true;
+		}), m_archetypes.end());
+	}
 }
@@ -1,24 +1,37 @@
 ﻿#pragma once
 
+#include <map>
 #include <mutex>
 #include <vector>
 #include "Physics/Rigidbody.hpp"
+#include "Archetype.hpp"
 #include "Entity.hpp"
+#include "EntityCommands.hpp"
+#include "TransformHierarchy.hpp"
+#include "View.hpp"
 
 namespace acid
 {
 	/// <summary>
-	/// A structure of spatial objects for a scene.
+	/// A structure of spatial objects for a scene. Entities are grouped into archetypes by their component signature,
+	/// so component queries walk dense columns of the matching archetypes instead of casting every component.
 	/// </summary>
 	class ACID_EXPORT SceneStructure :
 		public NonCopyable
 	{
 	public:
+		/// <summary>
+		/// The amount of entities updated by each job in a parallel update, commands are buffered per chunk.
+		/// </summary>
+		static const uint32_t UpdateGrainSize;
+
 		/// <summary>
 		/// Creates a new scene structure.
 		/// </summary>
 		SceneStructure();
 
+		~SceneStructure();
+
 		/// <summary>
 		/// Creates a new entity that starts in this structure.
 		/// </summary>
@@ -65,10 +78,25 @@ namespace acid
 		void Clear();
 
 		/// <summary>
-		/// Updates all of the entity.
+		/// Updates all of the entity. When the update is split into parallel chunks, adding and removing components, removing entities, and reparenting done by components
+		/// are deferred into command buffers and applied in entity order once every entity has updated. Otherwise these changes are applied immediately.
 		/// </summary>
 		void Update();
 
+		/// <summary>
+		/// Gets if entities are updated in chunks on the engines thread pool.
+		/// </summary>
+		/// <returns> If updates are parallel. </returns>
+		bool IsParallel() const { return m_parallel; }
+
+		/// <summary>
+		/// Sets if entities are updated in chunks on the engines thread pool.
+		/// Only enable this when component updates change nothing outside of their own entity other than through deferred changes,
+		/// and do not rely on structural changes being visible before the update ends.
+		/// </summary>
+		/// <param name="parallel"> If updates will be parallel. </param>
+		void SetParallel(const bool &parallel) { m_parallel = parallel; }
+
 		/// <summary>
 		/// Gets the size of this structure.
 		/// </summary>
@@ -101,29 +129,47 @@ namespace acid
 		/// <returns> The list specified by of all components that match the type. </returns>
 		template<typename T>
 		std::vector<T *> QueryComponents(const bool &allowDisabled = false)
+		{
+			std::vector<T *> result = {};
+			QueryComponents(result, allowDisabled);
+			return result;
+		}
+
+		/// <summary>
+		/// Fills a list with all components of a type in the spatial structure, the lists capacity is reused between queries.
+		/// Queries read the layout from the last update and never restructure, so they can run while renderers read views.
+		/// </summary>
+		/// <param name="result"> The list to fill, it is cleared first. </param>
+		/// <param name="allowDisabled"> If disabled components will be included in this query. </param>
+		template<typename T>
+		void QueryComponents(std::vector<T *> &result, const bool &allowDisabled = false)
 		{
 			std::lock_guard<std::mutex> lock(m_mutex);
 
-			std::vector<T *> result = {};
+			auto id = ComponentTypes::Get<T>();
+			result.clear();
 
-			for (auto it = m_objects.begin(); it != m_objects.end(); ++it)
+			for (const auto &archetype : m_archetypes)
 			{
-				auto components = (*it)->GetComponents<T>();
+				if (!archetype->Has(id))
+				{
+					continue;
+				}
 
-				for (const auto &component : components)
+				for (const auto &component : archetype->GetColumn(id))
 				{
-					if (component != nullptr && (component->IsEnabled() || allowDisabled))
+					auto casted = static_cast<T *>(component);
+
+					if (casted->IsEnabled() || allowDisabled)
 					{
-						result.emplace_back(component);
+						result.emplace_back(casted);
 					}
 				}
 			}
-
-			return result;
 		}
 
 		/// <summary>
-		/// Returns the first component of a type found in the spatial structure.
+		/// Returns the first component of a type found in the spatial structure, from the layout of the last update.
 		/// </summary>
 		/// <param name="allowDisabled"> If disabled components will be included in this query. </param>
 		/// <returns> The first component of the type found. </returns>
@@ -132,13 +178,23 @@ namespace acid
 		{
 			std::lock_guard<std::mutex> lock(m_mutex);
 
-			for (auto it = m_objects.begin(); it != m_objects.end(); ++it)
+			auto id = ComponentTypes::Get<T>();
+
+			for (const auto &archetype : m_archetypes)
 			{
-				auto component = (*it)->GetComponent<T>();
+				if (!archetype->Has(id))
+				{
+					continue;
+				}
 
-				if (component != nullptr && (component->IsEnabled() || allowDisabled))
+				for (const auto &component : archetype->GetColumn(id))
 				{
-					return component;
+					auto casted = static_cast<T *>(component);
+
+					if (casted->IsEnabled() || allowDisabled)
+					{
+						return casted;
+					}
 				}
 			}
 
@@ -153,7 +209,61 @@ namespace acid
 		/// <returns> If the structure contains the object. </returns>
 		bool Contains(Entity *object);
 	private:
+		friend class Entity;
+		friend class ViewBase;
+
+		/// <summary>
+		/// Registers a view and fills it with every matching entity, from the layout of the last update.
+		/// Entities only match types registered by the view after the next update.
+		/// </summary>
+		/// <param name="view"> The view to add. </param>
+		void AddView(ViewBase *view);
+
+		/// <summary>
+		/// Unregisters a view, the view is no longer patched.
+		/// </summary>
+		/// <param name="view"> The view to remove. </param>
+		void RemoveView(ViewBase *view);
+
+		/// <summary>
+		/// Starts tracking a entity added to this structure, must be called with the structure locked.
+		/// </summary>
+		/// <param name="object"> The entity added. </param>
+		void Attach(Entity *object);
+
+		/// <summary>
+		/// Stops tracking a entity before it leaves this structure, must be called with the structure locked.
+		/// </summary>
+		/// <param name="object"> The entity leaving. </param>
+		void Detach(Entity *object);
+
+		/// <summary>
+		/// Queues a entity to be moved to the archetype of its new signature.
+		/// </summary>
+		/// <param name="object"> The entity with changed components. </param>
+		void MarkRestructure(Entity *object);
+
+		/// <summary>
+		/// Moves queued entities into their archetypes and patches their view rows, and rematches every entity when new component types have been registered.
+		/// Must be called with the structure locked, and only from <seealso cref="#Update()"/> so views are never rewritten while they are read.
+		/// </summary>
+		void Restructure();
+
 		std::mutex m_mutex;
 		std::vector<std::unique_ptr<Entity>> m_objects;
+
+		std::vector<std::unique_ptr<Archetype>> m_archetypes;
+		std::map<std::vector<ComponentId>, Archetype *> m_archetypeMap;
+		uint32_t m_typeCount;
+
+		std::mutex m_restructureMutex;
+		std::vector<Entity *> m_restructures;
+
+		std::vector<ViewBase *> m_views;
+
+		TransformHierarchy m_hierarchy;
+
+		bool m_parallel;
+		std::vector<std::unique_ptr<EntityCommands>> m_commands;
 	};
 }
@@ -0,0 +1,142 @@
+#include "TransformHierarchy.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include "Entity.hpp"
+
+namespace acid
+{
+	TransformHierarchy::TransformHierarchy() :
+		m_relink(true),
+		m_updatedCount(0)
+	{
+	}
+
+	void TransformHierarchy::Update(const std::vector<std::unique_ptr<Entity>> &objects)
+	{
+		auto relinked = m_relink;
+
+		if (m_relink)
+		{
+			Relink(objects);
+		}
+
+		m_updatedCount = 0;
+
+		for (uint32_t i = 0; i < m_entities.size(); i++)
+		{
+			auto entity = m_entities[i];
+			auto parent = m_parents[i];
+			auto &local = entity->m_localTransform;
+
+			// Parents outside of this structure are not tracked, so their children are always recomputed.
+			bool dirty = relinked || local.IsDirty() || entity->m_worldDirty || (parent != -1 ? m_dirty[parent] != 0 : entity->m_parent != nullptr);
+			m_dirty[i] = dirty;
+
+			if (!dirty)
+			{
+				continue;
+			}
+
+			if (parent != -1)
+			{
+				// A clean parent may have been recomputed lazily since its slot was written, so its slot is refreshed from the entity.
+				if (m_dirty[parent] == 0)
+				{
+					auto &parentWorld = m_entities[parent]->m_worldTransform;
+					m_rotations[parent] = parentWorld.GetRotation();
+					m_scalings[parent] = parentWorld.GetScaling();
+					m_matrices[parent] = parentWorld.GetWorldMatrix();
+				}
+
+				m_positions[i] = m_matrices[parent].Transform(local.GetPosition());
+				m_rotations[i] = m_rotations[parent] + local.GetRotation();
+				m_scalings[i] = m_scalings[parent] * local.GetScaling();
+				entity->m_worldTransform = Transform(m_positions[i], m_rotations[i], m_scalings[i]);
+				local.SetDirty(false);
+			}
+			else
+			{
+				if (entity->m_parent != nullptr)
+				{
+					entity->m_worldTransform = entity->m_parent->GetWorldTransform() * local;
+					local.SetDirty(false);
+				}
+				else
+				{
+					// Assignment copies the locals cached matrix and dirty flag, the matrix may never have been computed so the copy is marked dirty.
+					entity->m_worldTransform = local;
+					entity->m_worldTransform.SetDirty(true);
+					local.SetDirty(false);
+				}
+
+				m_positions[i] = entity->m_worldTransform.GetPosition();
+				m_rotations[i] = entity->m_worldTransform.GetRotation();
+				m_scalings[i] = entity->m_worldTransform.GetScaling();
+			}
+
+			m_matrices[i] = entity->m_worldTransform.GetWorldMatrix();
+			entity->m_worldDirty = false;
+			m_updatedCount++;
+		}
+	}
+
+	void TransformHierarchy::Relink(const std::vector<std::unique_ptr<Entity>> &objects)
+	{
+		std::unordered_map<const Entity *, uint32_t> depths;
+		depths.reserve(objects.size());
+
+		for (const auto &object : objects)
+		{
+			depths.emplace(object.get(), 0);
+		}
+
+		for (const auto &object : objects)
+		{
+			uint32_t depth = 0;
+
+			for (auto parent = object->m_parent; parent != nullptr && depths.find(parent) != depths.end(); parent = parent->m_parent)
+			{
+				depth++;
+			}
+
+			depths[object.get()] = depth;
+		}
+
+		m_entities.clear();
+
+		for (const auto &object : objects)
+		{
+			m_entities.emplace_back(object.get());
+		}
+
+		// Stable so entities of the same depth keep the structures order.
+		std::stable_sort(m_entities.begin(), m_entities.end(), [&depths](const Entity *a, const Entity *b)
+		{
+			return depths[a] < depths[b];
+		});
+
+		std::unordered_map<const Entity *, int32_t> indices;
+		indices.reserve(m_entities.size());
+
+		for (uint32_t i = 0; i < m_entities.size(); i++)
+		{
+			indices.emplace(m_entities[i], static_cast<int32_t>(i));
+		}
+
+		m_parents.resize(m_entities.size());
+
+		for (uint32_t i = 0; i < m_entities.size(); i++)
+		{
+			auto it = indices.find(m_entities[i]->m_parent);
+			m_parents[i] = it != indices.end() ? it->second : -1;
+		}
+
+		m_dirty.resize(m_entities.size());
+		m_positions.resize(m_entities.size());
+		m_rotations.resize(m_entities.size());
+		m_scalings.resize(m_entities.size());
+		m_matrices.resize(m_entities.size());
+		m_relink = false;
+	}
+}
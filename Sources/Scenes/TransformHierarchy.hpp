@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Maths/Matrix4.hpp"
+#include "Maths/Vector3.hpp"
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+	class Entity;
+
+	/// <summary>
+	/// A flat copy of the parent hierarchy of a structures entities, sorted by depth so parents always come before their children.
+	/// World transforms are updated in one linear pass, only entities with a dirty local transform and their subtrees are recomputed.
+	/// </summary>
+	class ACID_EXPORT TransformHierarchy :
+		public NonCopyable
+	{
+	public:
+		TransformHierarchy();
+
+		/// <summary>
+		/// Marks the order to be rebuilt before the next update, used when entities are added, removed, or reparented.
+		/// </summary>
+		void MarkRelink() { m_relink = true; }
+
+		/// <summary>
+		/// Updates the cached world transform of every changed entity.
+		/// </summary>
+		/// <param name="objects"> The entities in the structure, used to rebuild the order when it has been marked. </param>
+		void Update(const std::vector<std::unique_ptr<Entity>> &objects);
+
+		/// <summary>
+		/// Gets the amount of world transforms recomputed in the last update.
+		/// </summary>
+		/// <returns> The recomputed count. </returns>
+		uint32_t GetUpdatedCount() const { return m_updatedCount; }
+	private:
+		void Relink(const std::vector<std::unique_ptr<Entity>> &objects);
+
+		bool m_relink;
+		uint32_t m_updatedCount;
+
+		std::vector<Entity *> m_entities;
+		std::vector<int32_t> m_parents;
+		std::vector<uint8_t> m_dirty;
+		std::vector<Vector3> m_positions;
+		std::vector<Vector3> m_rotations;
+		std::vector<Vector3> m_scalings;
+		std::vector<Matrix4> m_matrices;
+	};
+}
@@ -0,0 +1,61 @@
+#include "View.hpp"
+
+#include <algorithm>
+#include <utility>
+#include "SceneStructure.hpp"
+
+namespace acid
+{
+	ViewBase::ViewBase(std::vector<ComponentId> ids) :
+		m_ids(std::move(ids)),
+		m_structure(nullptr)
+	{
+		std::sort(m_ids.begin(), m_ids.end());
+		m_ids.erase(std::unique(m_ids.begin(), m_ids.end()), m_ids.end());
+	}
+
+	ViewBase::~ViewBase()
+	{
+		if (m_structure != nullptr)
+		{
+			m_structure->RemoveView(this);
+		}
+	}
+
+	void ViewBase::Bind(SceneStructure *structure)
+	{
+		if (m_structure == structure)
+		{
+			return;
+		}
+
+		if (m_structure != nullptr)
+		{
+			m_structure->RemoveView(this);
+		}
+
+		Clear();
+
+		if (structure != nullptr)
+		{
+			structure->AddView(this);
+		}
+	}
+
+	bool ViewBase::Matches(const Entity *entity) const
+	{
+		return std::includes(entity->GetSignature().begin(), entity->GetSignature().end(), m_ids.begin(), m_ids.end());
+	}
+
+	std::vector<void *> ViewBase::FindAll(const Entity *entity, const ComponentId &id)
+	{
+		std::vector<void *> result;
+
+		for (auto it = entity->FindMatches(id); it != entity->m_matches.end() && it->first == id; ++it)
+		{
+			result.emplace_back(it->second);
+		}
+
+		return result;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Helpers/NonCopyable.hpp"
+#include "ComponentTypes.hpp"
+
+namespace acid
+{
+	class Entity;
+	class SceneStructure;
+
+	/// <summary>
+	/// The type independent part of a <seealso cref="View"/>, used by the structure to patch its views.
+	/// </summary>
+	class ACID_EXPORT ViewBase :
+		public NonCopyable
+	{
+	public:
+		virtual ~ViewBase();
+
+		/// <summary>
+		/// Registers this view with a structure, the view is rebuilt when the structure changes. Passing the current structure does nothing.
+		/// </summary>
+		/// <param name="structure"> The structure to view, or nullptr to stop viewing. </param>
+		void Bind(SceneStructure *structure);
+
+		/// <summary>
+		/// Gets the structure this view is registered with.
+		/// </summary>
+		/// <returns> The viewed structure. </returns>
+		SceneStructure *GetStructure() const { return m_structure; }
+	protected:
+		friend class SceneStructure;
+
+		explicit ViewBase(std::vector<ComponentId> ids);
+
+		/// <summary>
+		/// Gets if a entities signature contains every type in this view.
+		/// </summary>
+		/// <param name="entity"> The entity to check. </param>
+		/// <returns> If the entity belongs in this view. </returns>
+		bool Matches(const Entity *entity) const;
+
+		/// <summary>
+		/// Gets every component of a type attached to a entity, already cast to the type, in the order they were added.
+		/// </summary>
+		/// <param name="entity"> The entity. </param>
+		/// <param name="id"> The component type id. </param>
+		/// <returns> The components. </returns>
+		static std::vector<void *> FindAll(const Entity *entity, const ComponentId &id);
+
+		/// <summary>
+		/// Adds, updates or removes the row of a entity after its components changed.
+		/// </summary>
+		/// <param name="entity"> The entity that changed. </param>
+		virtual void Patch(Entity *entity) = 0;
+
+		/// <summary>
+		/// Removes the row of a entity leaving the structure.
+		/// </summary>
+		/// <param name="entity"> The entity leaving. </param>
+		virtual void Erase(Entity *entity) = 0;
+
+		/// <summary>
+		/// Removes every row.
+		/// </summary>
+		virtual void Clear() = 0;
+
+		std::vector<ComponentId> m_ids;
+		SceneStructure *m_structure;
+	};
+
+	/// <summary>
+	/// A persistent query over a <seealso cref="SceneStructure"/>. Holds rows for every entity that has all of the component types,
+	/// the rows are patched by the structure as entities change so iterating costs only the amount of matches.
+	/// A entity with several components of a type has a row for each of them, and a row for each combination when there are several types.
+	/// Rows are only modified while the structure restructures, during its update and queries, so they can be read without locking from the render stage.
+	/// </summary>
+	/// <param name="Ts"> The component types, each row holds one component of each type. </param>
+	template<typename... Ts>
+	class View :
+		public ViewBase
+	{
+	public:
+		using Row = std::tuple<Ts *...>;
+
+		View() :
+			ViewBase({ComponentTypes::Get<Ts>()...})
+		{
+		}
+
+		/// <summary>
+		/// Creates a new view registered with a structure.
+		/// </summary>
+		/// <param name="structure"> The structure to view. </param>
+		explicit View(SceneStructure *structure) :
+			View()
+		{
+			Bind(structure);
+		}
+
+		~View()
+		{
+			Bind(nullptr);
+		}
+
+		/// <summary>
+		/// Gets the rows of components, the order changes as entities are added and removed.
+		/// </summary>
+		/// <returns> The rows. </returns>
+		const std::vector<Row> &GetRows() const { return m_rows; }
+
+		/// <summary>
+		/// Gets the entity of each row, a entity is repeated for each of its rows.
+		/// </summary>
+		/// <returns> The entities. </returns>
+		const std::vector<Entity *> &GetEntities() const { return m_entities; }
+
+		uint32_t GetSize() const { return static_cast<uint32_t>(m_rows.size()); }
+
+		typename std::vector<Row>::const_iterator begin() const { return m_rows.begin(); }
+
+		typename std::vector<Row>::const_iterator end() const { return m_rows.end(); }
+	protected:
+		void Patch(Entity *entity) override
+		{
+			// The components of a entity are few, so its rows are rebuilt rather than matched against the old ones.
+			Erase(entity);
+
+			if (!Matches(entity))
+			{
+				return;
+			}
+
+			std::array<std::vector<void *>, sizeof...(Ts)> matches = {FindAll(entity, ComponentTypes::Get<Ts>())...};
+			AddRows(entity, matches, std::index_sequence_for<Ts...>());
+		}
+
+		void Erase(Entity *entity) override
+		{
+			auto it = m_indices.find(entity);
+
+			if (it == m_indices.end())
+			{
+				return;
+			}
+
+			auto indices = std::move(it->second);
+			m_indices.erase(it);
+
+			// Removing from the back means the last row is never one of this entities rows still to be removed.
+			std::sort(indices.begin(), indices.end(), std::greater<>());
+
+			for (const auto &index : indices)
+			{
+				auto last = static_cast<uint32_t>(m_rows.size() - 1);
+
+				// Swaps the last row into the removed rows place.
+				if (index != last)
+				{
+					m_rows[index] = m_rows.back();
+					m_entities[index] = m_entities.back();
+					auto &moved = m_indices[m_entities[index]];
+					std::replace(moved.begin(), moved.end(), last, index);
+				}
+
+				m_rows.pop_back();
+				m_entities.pop_back();
+			}
+		}
+
+		void Clear() override
+		{
+			m_rows.clear();
+			m_entities.clear();
+			m_indices.clear();
+		}
+	private:
+		template<std::size_t... Is>
+		void AddRows(Entity *entity, const std::array<std::vector<void *>, sizeof...(Ts)> &matches, std::index_sequence<Is...>)
+		{
+			auto &indices = m_indices[entity];
+			std::array<std::size_t, sizeof...(Ts)> counters = {};
+
+			// Counts through every combination of the matches, the first type changes fastest.
+			while (true)
+			{
+				indices.emplace_back(static_cast<uint32_t>(m_rows.size()));
+				m_rows.emplace_back(Row{static_cast<Ts *>(matches[Is][counters[Is]])...});
+				m_entities.emplace_back(entity);
+
+				std::size_t digit = 0;
+
+				for (; digit < counters.size(); digit++)
+				{
+					if (++counters[digit] < matches[digit].size())
+					{
+						break;
+					}
+
+					counters[digit] = 0;
+				}
+
+				if (digit == counters.size())
+				{
+					break;
+				}
+			}
+		}
+
+		std::vector<Row> m_rows;
+		std::vector<Entity *> m_entities;
+		std::unordered_map<Entity *, std::vector<uint32_t>> m_indices;
+	};
+}
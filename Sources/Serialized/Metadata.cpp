@@ -1,11 +1,17 @@
 #include "Metadata.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <utility>
 #include "Engine/Log.hpp"
 
 namespace acid
 {
+	static void HashCombine(std::size_t &seed, const std::size_t &value)
+	{
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
 	Metadata::Metadata(const std::string &name, const std::string &value, std::map<std::string, std::string> attributes) :
 		m_name(String::Trim(String::RemoveAll(name, '\"'))), // TODO: Remove first and last.
 		m_value(String::Trim(value)),
@@ -175,6 +181,26 @@ namespace acid
 		return result;
 	}
 
+	std::size_t Metadata::GetHash() const
+	{
+		std::hash<std::string> hasher;
+		auto result = hasher(m_name);
+		HashCombine(result, hasher(m_value));
+
+		for (const auto &[attribute, value] : m_attributes)
+		{
+			HashCombine(result, hasher(attribute));
+			HashCombine(result, hasher(value));
+		}
+
+		for (const auto &child : m_children)
+		{
+			HashCombine(result, child->GetHash());
+		}
+
+		return result;
+	}
+
 	bool Metadata::operator==(const Metadata &other) const
 	{
 		return m_name == other.m_name && m_value == other.m_value && m_attributes == other.m_attributes && m_children.size() == other.m_children.size() &&
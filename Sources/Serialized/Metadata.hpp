@@ -267,6 +267,12 @@ namespace acid
 
 		Metadata *Clone() const;
 
+		/// <summary>
+		/// Gets a hash of the name, value, attributes, and children of this tree. Equal trees always have equal hashes.
+		/// </summary>
+		/// <returns> The structural hash. </returns>
+		std::size_t GetHash() const;
+
 		bool operator==(const Metadata &other) const;
 
 		bool operator!=(const Metadata &other) const;
@@ -1,14 +1,17 @@
 #include "RendererShadows.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include "Meshes/Mesh.hpp"
 #include "Models/VertexModel.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Scenes/Entity.hpp"
 #include "Scenes/Scenes.hpp"
 #include "ShadowRender.hpp"
 #include "Shadows.hpp"
 
 namespace acid
 {
-	const uint32_t RendererShadows::Cascades = 4; // TODO: Relocate to Shadows class.
-
 	const float RendererShadows::BiasConstants = 1.25f;
 	const float RendererShadows::BiasSlope = 1.75f;
 
@@ -22,27 +25,102 @@ namespace acid
 	void RendererShadows::Render(const CommandBuffer &commandBuffer)
 	{
 		auto camera = Scenes::Get()->GetCamera();
-		m_uniformScene.Push("projectionView", Shadows::Get()->GetShadowBox().GetProjectionViewMatrix());
+		auto shadows = Shadows::Get();
+		auto renderStage = Renderer::Get()->GetRenderStage(GetStage().first);
+
+		if (camera == nullptr || shadows == nullptr || renderStage == nullptr)
+		{
+			return;
+		}
+
+		auto pushBlock = m_pipeline.GetShaderProgram()->GetUniformBlock("PushCascade");
+
+		if (pushBlock == nullptr)
+		{
+			return;
+		}
+
+		m_pushCascade.Update(pushBlock);
+
+		// Updates uniforms, every cascade is drawn with the same scene and selects its matrix with a push constant.
+		std::vector<Matrix4> projectionViews;
+
+		for (uint32_t i = 0; i < Shadows::Cascades; i++)
+		{
+			projectionViews.emplace_back(shadows->GetShadowBox(i).GetProjectionViewMatrix());
+		}
+
+		m_uniformScene.Push("projectionViews", *projectionViews.data(), sizeof(Matrix4) * projectionViews.size());
 		m_uniformScene.Push("cameraPosition", camera->GetPosition());
 
 		vkCmdSetDepthBias(commandBuffer.GetCommandBuffer(), BiasConstants, 0.0f, BiasSlope);
 
 		m_pipeline.BindPipeline(commandBuffer);
 
-	//	vkCmdSetDepthBias(commandBuffer.GetCommandBuffer(), 1.25f, 0.0f, 1.75f);
+		// Finds the bounding sphere of each caster once, then each cascade only draws the casters inside of its box.
+		m_view.Bind(Scenes::Get()->GetStructure());
+		m_casters.clear();
+
+		for (const auto &[shadowRender] : m_view)
+		{
+			if (!shadowRender->IsEnabled())
+			{
+				continue;
+			}
+
+			auto mesh = shadowRender->GetParent()->GetComponent<Mesh>();
+
+			if (mesh == nullptr || mesh->GetModel() == nullptr)
+			{
+				continue;
+			}
+
+			auto &worldTransform = shadowRender->GetParent()->GetWorldTransform();
+			auto &scaling = worldTransform.GetScaling();
+			auto scale = std::max({std::abs(scaling.m_x), std::abs(scaling.m_y), std::abs(scaling.m_z)});
+			m_casters.emplace_back(Caster{shadowRender, worldTransform.GetPosition(), mesh->GetModel()->GetRadius() * scale});
+		}
 
-		auto sceneShadowRenders = Scenes::Get()->GetStructure()->QueryComponents<ShadowRender>();
+		auto tileWidth = renderStage->GetWidth() / Shadows::CascadeColumns;
+		auto tileHeight = renderStage->GetHeight() / Shadows::CascadeColumns;
 
-		for (const auto &shadowRender : sceneShadowRenders)
+		for (uint32_t i = 0; i < Shadows::Cascades; i++)
 		{
-			shadowRender->CmdRender(commandBuffer, m_pipeline, m_uniformScene);
+			auto offset = shadows->GetCascadeOffset(i);
+
+			VkViewport viewport = {};
+			viewport.x = offset.m_x * static_cast<float>(renderStage->GetWidth());
+			viewport.y = offset.m_y * static_cast<float>(renderStage->GetHeight());
+			viewport.width = static_cast<float>(tileWidth);
+			viewport.height = static_cast<float>(tileHeight);
+			viewport.minDepth = 0.0f;
+			viewport.maxDepth = 1.0f;
+			vkCmdSetViewport(commandBuffer.GetCommandBuffer(), 0, 1, &viewport);
+
+			VkRect2D scissor = {};
+			scissor.offset = {static_cast<int32_t>(viewport.x), static_cast<int32_t>(viewport.y)};
+			scissor.extent = {tileWidth, tileHeight};
+			vkCmdSetScissor(commandBuffer.GetCommandBuffer(), 0, 1, &scissor);
+
+			m_pushCascade.Push("cascade", i);
+			m_pushCascade.BindPush(commandBuffer, m_pipeline);
+
+			auto &shadowBox = shadows->GetShadowBox(i);
+
+			for (const auto &caster : m_casters)
+			{
+				if (shadowBox.IsInBox(caster.m_position, caster.m_radius))
+				{
+					caster.m_shadowRender->CmdRender(commandBuffer, m_pipeline, m_uniformScene);
+				}
+			}
 		}
 	}
 
 	std::vector<Shader::Define> RendererShadows::GetDefines()
 	{
 		std::vector<Shader::Define> result = {};
-		result.emplace_back("NUM_CASCADES", String::To(Cascades));
+		result.emplace_back("NUM_CASCADES", String::To(Shadows::Cascades));
 		return result;
 	}
 }
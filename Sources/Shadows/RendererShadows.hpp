@@ -1,16 +1,23 @@
 #pragma once
 
+#include "Maths/Vector3.hpp"
 #include "Renderer/RenderPipeline.hpp"
+#include "Renderer/Handlers/PushHandler.hpp"
 #include "Renderer/Handlers/UniformHandler.hpp"
 #include "Renderer/Pipelines/PipelineGraphics.hpp"
+#include "Scenes/View.hpp"
 
 namespace acid
 {
+	class ShadowRender;
+
+	/// <summary>
+	/// Renders shadow casters into each cascade tile of the shadow map, casters are culled against each cascades shadow box before they are drawn.
+	/// </summary>
 	class ACID_EXPORT RendererShadows :
 		public RenderPipeline
 	{
 	public:
-		static const uint32_t Cascades;
 		static const float BiasConstants;
 		static const float BiasSlope;
 
@@ -18,9 +25,19 @@ namespace acid
 
 		void Render(const CommandBuffer &commandBuffer) override;
 	private:
+		struct Caster
+		{
+			ShadowRender *m_shadowRender;
+			Vector3 m_position;
+			float m_radius;
+		};
+
 		std::vector<Shader::Define> GetDefines();
 
 		PipelineGraphics m_pipeline;
 		UniformHandler m_uniformScene;
+		PushHandler m_pushCascade;
+		View<ShadowRender> m_view;
+		std::vector<Caster> m_casters;
 	};
 }
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <array>
 #include "Maths/Matrix4.hpp"
 #include "Maths/Vector4.hpp"
 #include "Scenes/Camera.hpp"
@@ -7,31 +8,32 @@
 namespace acid
 {
 	/// <summary>
-	/// Represents the 3D area of the world in which engine.shadows will be cast (basically represents the orthographic projection area for the shadow render pass).
-	/// It can be updated each frame to optimize the area, making it as small as possible (to allow for optimal shadow map resolution) while not being too small to avoid objects not having shadows when they should.
-	/// This class also provides functionality to test whether an object is inside this shadow box. Everything inside the box will be rendered to the shadow map in the shadow render pass.
+	/// Represents the 3D area of the world in which shadows will be cast for one cascade (the orthographic projection area for that cascades tile in the shadow map).
+	/// The box bounds a sphere around a slice of the camera's view frustum, so its size does not change as the camera turns, and its centre is snapped to whole shadow map texels so edges do not shimmer as the camera moves.
+	/// This class also provides functionality to test whether an object is inside this shadow box. Everything inside the box will be rendered into the cascade in the shadow render pass.
 	/// </summary>
 	class ACID_EXPORT ShadowBox
 	{
 	public:
 		/// <summary>
-		/// Creates a new shadow box and calculates some initial values relating to the camera's view frustum.
+		/// Creates a new shadow box.
 		/// </summary>
 		ShadowBox();
 
 		/// <summary>
-		/// Updates the bounds of the shadow box based on the light direction and the camera's view frustum.
-		/// Will make sure that the box covers the smallest area possible while still ensuring that everything.
-		/// Objects inside the camera's view (and in range) will be shadowed.
+		/// Updates the bounds of the shadow box based on the light direction and a slice of the camera's view frustum.
 		/// </summary>
 		/// <param name="camera"> The camera object to be used when calculating the shadow boxes size. </param>
-		/// <param name="lightPosition"> The lights position. </param>
-		/// <param name="shadowOffset"> The shadows offset. </param>
-		/// <param name="shadowDistance"> The shadows distance. </param>
-		void Update(const Camera &camera, const Vector3 &lightPosition, const float &shadowOffset, const float &shadowDistance);
+		/// <param name="lightDirection"> The direction of the light. </param>
+		/// <param name="nearSplit"> The view distance the slice starts at. </param>
+		/// <param name="farSplit"> The view distance the slice ends at. </param>
+		/// <param name="shadowOffset"> How far the box is extended towards the light, so casters outside of the view still shadow it. </param>
+		/// <param name="shadowSize"> The width of the shadow map tile the box is rendered into, in texels. </param>
+		void Update(const Camera &camera, const Vector3 &lightDirection, const float &nearSplit, const float &farSplit, const float &shadowOffset,
+			const uint32_t &shadowSize);
 
 		/// <summary>
-		/// Test if a bounding sphere intersects the shadow box. Can be used to decide which engine.entities should be rendered in the shadow render pass.
+		/// Test if a bounding sphere intersects the shadow box. Can be used to decide which entities should be rendered in the shadow render pass.
 		/// </summary>
 		/// <param name="position"> The centre of the bounding sphere in world space. </param>
 		/// <param name="radius"> The radius of the bounding sphere.
@@ -62,62 +64,37 @@ namespace acid
 		float GetHeight() const { return m_maxExtents.m_y - m_minExtents.m_y; }
 
 		float GetDepth() const { return m_maxExtents.m_z - m_minExtents.m_z; }
-	private:
-		void UpdateShadowBox(const Camera &camera);
-
-		/// <summary>
-		/// Updates the widths and heights of the box panes.
-		/// </summary>
-		/// <param name="camera"> The camera object. </param>
-		void UpdateSizes(const Camera &camera);
 
-		/// <summary>
-		/// Calculates the vertex of each corner of the view frustum in light space.
-		/// </summary>
-		/// <param name="rotation"> - camera's rotation. </param>
-		/// <param name="forwardVector"> - the direction that the camera is aiming, and thus the direction of the frustum. </param>
-		/// <param name="centreNear"> - the centre point of the frustum's near plane. </param>
-		/// <param name="centreFar"> - the centre point of the frustum's far plane.
-		/// </param>
-		/// <returns> The vertices of the frustum in light space. </returns>
-		std::array<Vector4, 8> CalculateFrustumVertices(const Matrix4 &rotation, const Vector3 &forwardVector, const Vector3 &centreNear, const Vector3 &centreFar);
+		const float &GetNearSplit() const { return m_nearSplit; }
 
+		const float &GetFarSplit() const { return m_farSplit; }
+	private:
 		/// <summary>
-		/// Calculates one of the corner vertices of the view frustum in world space and converts it to light space.
+		/// Calculates the corners of the slice of the view frustum in world space.
 		/// </summary>
-		/// <param name="startPoint"> The starting centre point on the view frustum. </param>
-		/// <param name="direction"> The direction of the corner from the start point. </param>
-		/// <param name="width"> The distance of the corner from the start point.
-		/// </param>
-		/// <returns> The relevant corner vertex of the view frustum in light space. </returns>
-		Vector4 CalculateLightSpaceFrustumCorner(const Vector3 &startPoint, const Vector3 &direction, const float &width) const;
+		/// <param name="camera"> The camera object. </param>
+		/// <returns> The near corners followed by the far corners. </returns>
+		std::array<Vector3, 8> CalculateFrustumCorners(const Camera &camera) const;
 
 		void UpdateOrthoProjectionMatrix();
 
-		/// <summary>
-		/// Updates the centre of the shadow box (orthographic projection area).
-		/// </summary>
-		void UpdateCenter();
-
-		void UpdateLightViewMatrix();
+		void UpdateLightRotationMatrix();
 
 		void UpdateViewShadowMatrix();
 
 		Vector3 m_lightDirection;
-		float m_shadowOffset;
-		float m_shadowDistance;
+		float m_nearSplit;
+		float m_farSplit;
 
 		Matrix4 m_projectionMatrix;
+		Matrix4 m_lightRotationMatrix;
 		Matrix4 m_lightViewMatrix;
 		Matrix4 m_projectionViewMatrix;
 		Matrix4 m_shadowMapSpaceMatrix;
 		Matrix4 m_offset;
 		Vector3 m_centre;
 
-		float m_farHeight, m_farWidth;
-		float m_nearHeight, m_nearWidth;
-
 		Vector3 m_minExtents;
 		Vector3 m_maxExtents;
 	};
-}
+}
\ No newline at end of file
@@ -1,9 +1,13 @@
 #include "Shadows.hpp"
 
+#include "Maths/Maths.hpp"
 #include "Scenes/Scenes.hpp"
 
 namespace acid
 {
+	const uint32_t Shadows::Cascades = 4;
+	const uint32_t Shadows::CascadeColumns = 2;
+
 	Shadows::Shadows() :
 		m_lightDirection(0.5f, 0.0f, 0.5f),
 		m_shadowSize(8192),
@@ -12,15 +16,54 @@ namespace acid
 		m_shadowDarkness(0.6f),
 		m_shadowTransition(11.0f),
 		m_shadowBoxOffset(9.0f),
-		m_shadowBoxDistance(70.0f)
+		m_shadowBoxDistance(70.0f),
+		m_cascadeSplitLambda(0.75f),
+		m_cascadeSplits(Cascades + 1),
+		m_shadowBoxes(Cascades)
 	{
+		AddRead<Scenes>();
+		AddWrite<Shadows>();
 	}
 
 	void Shadows::Update()
 	{
-		if (Scenes::Get()->GetCamera() != nullptr)
+		auto camera = Scenes::Get()->GetCamera();
+
+		if (camera == nullptr)
+		{
+			return;
+		}
+
+		// Splits blend between even and logarithmic spacing, logarithmic spacing keeps texel density closer to constant on screen.
+		auto nearPlane = std::max(camera->GetNearPlane(), 0.001f);
+		auto farPlane = std::max(m_shadowBoxDistance, nearPlane);
+		m_cascadeSplits[0] = nearPlane;
+
+		for (uint32_t i = 1; i <= Cascades; i++)
 		{
-			m_shadowBox.Update(*Scenes::Get()->GetCamera(), m_lightDirection, m_shadowBoxOffset, m_shadowBoxDistance);
+			auto fraction = static_cast<float>(i) / static_cast<float>(Cascades);
+			auto uniform = nearPlane + (farPlane - nearPlane) * fraction;
+			auto logarithmic = nearPlane * std::pow(farPlane / nearPlane, fraction);
+			m_cascadeSplits[i] = Maths::Lerp(uniform, logarithmic, m_cascadeSplitLambda);
 		}
+
+		for (uint32_t i = 0; i < Cascades; i++)
+		{
+			m_shadowBoxes[i].Update(*camera, m_lightDirection, m_cascadeSplits[i], m_cascadeSplits[i + 1], m_shadowBoxOffset, GetCascadeSize());
+		}
+	}
+
+	Vector2 Shadows::GetCascadeOffset(const uint32_t &cascade) const
+	{
+		return Vector2(static_cast<float>(cascade % CascadeColumns), static_cast<float>(cascade / CascadeColumns)) / static_cast<float>(CascadeColumns);
+	}
+
+	Matrix4 Shadows::GetShadowSpace(const uint32_t &cascade) const
+	{
+		auto offset = GetCascadeOffset(cascade);
+		auto tile = Matrix4();
+		tile = tile.Translate(Vector3(offset.m_x, offset.m_y, 0.0f));
+		tile = tile.Scale(Vector3(1.0f / CascadeColumns, 1.0f / CascadeColumns, 1.0f));
+		return tile * m_shadowBoxes[cascade].GetToShadowMapSpaceMatrix();
 	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <vector>
 #include "Engine/Engine.hpp"
+#include "Maths/Vector2.hpp"
 #include "Maths/Vector3.hpp"
 #include "ShadowBox.hpp"
 
@@ -8,6 +10,7 @@ namespace acid
 {
 	/// <summary>
 	/// A module used for managing shadow maps.
+	/// The view is split into cascades that each have their own shadow box, cascades are tiled in a grid inside of the shadow map.
 	/// </summary>
 	class ACID_EXPORT Shadows :
 		public Module
@@ -56,10 +59,56 @@ namespace acid
 		void SetShadowBoxDistance(const float &shadowBoxDistance) { m_shadowBoxDistance = shadowBoxDistance; }
 
 		/// <summary>
-		/// Get the shadow box, so that it can be used by other class to test if engine.entities are inside the box.
+		/// Gets how cascade splits are placed, zero spaces splits evenly and one spaces them logarithmically.
 		/// </summary>
+		/// <returns> The split lambda. </returns>
+		const float &GetCascadeSplitLambda() const { return m_cascadeSplitLambda; }
+
+		void SetCascadeSplitLambda(const float &cascadeSplitLambda) { m_cascadeSplitLambda = cascadeSplitLambda; }
+
+		/// <summary>
+		/// Gets the view distance a cascade ends at.
+		/// </summary>
+		/// <param name="cascade"> The cascade index. </param>
+		/// <returns> The far split of the cascade. </returns>
+		const float &GetCascadeSplit(const uint32_t &cascade) const { return m_cascadeSplits[cascade + 1]; }
+
+		/// <summary>
+		/// Gets the width and height of each cascades tile in the shadow map.
+		/// </summary>
+		/// <returns> The cascade size in texels. </returns>
+		uint32_t GetCascadeSize() const { return m_shadowSize / CascadeColumns; }
+
+		/// <summary>
+		/// Gets the offset of a cascades tile in the shadow map, each tile covers one over <seealso cref="#CascadeColumns"/> of the map on both axes.
+		/// </summary>
+		/// <param name="cascade"> The cascade index. </param>
+		/// <returns> The tile offset, from zero to one. </returns>
+		Vector2 GetCascadeOffset(const uint32_t &cascade) const;
+
+		/// <summary>
+		/// Get the shadow box of a cascade, so that it can be used by other class to test if entities are inside the box.
+		/// </summary>
+		/// <param name="cascade"> The cascade index. </param>
 		/// <returns> The shadow box. </returns>
-		const ShadowBox &GetShadowBox() const { return m_shadowBox; }
+		const ShadowBox &GetShadowBox(const uint32_t &cascade) const { return m_shadowBoxes[cascade]; }
+
+		/// <summary>
+		/// Gets the matrix that converts world positions into the shadow map, inside of a cascades tile.
+		/// </summary>
+		/// <param name="cascade"> The cascade index. </param>
+		/// <returns> The to-shadow-map-space matrix. </returns>
+		Matrix4 GetShadowSpace(const uint32_t &cascade) const;
+
+		/// <summary>
+		/// The amount of cascades the view is split into, the deferred pass reads the splits as a vec4 so there can be no more than four.
+		/// </summary>
+		static const uint32_t Cascades;
+
+		/// <summary>
+		/// The amount of cascade tiles across the shadow map.
+		/// </summary>
+		static const uint32_t CascadeColumns;
 	private:
 		Vector3 m_lightDirection;
 
@@ -72,6 +121,8 @@ namespace acid
 		float m_shadowBoxOffset;
 		float m_shadowBoxDistance;
 
-		ShadowBox m_shadowBox;
+		float m_cascadeSplitLambda;
+		std::vector<float> m_cascadeSplits;
+		std::vector<ShadowBox> m_shadowBoxes;
 	};
 }
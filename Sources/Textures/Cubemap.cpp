@@ -11,11 +11,11 @@ namespace acid
 {
 	std::shared_ptr<Cubemap> Cubemap::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<Cubemap>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<Cubemap>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<Cubemap>("");
@@ -51,7 +51,6 @@ namespace acid
 		m_height(0),
 		m_pixels(nullptr),
 		m_image(VK_NULL_HANDLE),
-		m_memory(VK_NULL_HANDLE),
 		m_view(VK_NULL_HANDLE),
 		m_sampler(VK_NULL_HANDLE),
 		m_format(VK_FORMAT_R8G8B8A8_UNORM)
@@ -79,7 +78,6 @@ namespace acid
 		m_height(height),
 		m_pixels(pixels),
 		m_image(VK_NULL_HANDLE),
-		m_memory(VK_NULL_HANDLE),
 		m_view(VK_NULL_HANDLE),
 		m_sampler(VK_NULL_HANDLE),
 		m_format(VK_FORMAT_R8G8B8A8_UNORM)
@@ -93,8 +91,8 @@ namespace acid
 
 		vkDestroySampler(logicalDevice->GetLogicalDevice(), m_sampler, nullptr);
 		vkDestroyImageView(logicalDevice->GetLogicalDevice(), m_view, nullptr);
-		vkFreeMemory(logicalDevice->GetLogicalDevice(), m_memory, nullptr);
 		vkDestroyImage(logicalDevice->GetLogicalDevice(), m_image, nullptr);
+		Renderer::Get()->GetMemoryAllocator()->Free(m_allocation);
 	}
 
 	VkDescriptorSetLayoutBinding Cubemap::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage, const uint32_t &count)
@@ -146,42 +144,12 @@ namespace acid
 			return;
 		}
 
-		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 		auto mipLevels = m_mipmap ? Texture::GetMipLevels(m_width, m_height) : 1;
 
-		Texture::CreateImage(m_image, m_memory, m_width, m_height, VK_IMAGE_TYPE_2D, m_samples, mipLevels, m_format, VK_IMAGE_TILING_OPTIMAL,
+		Texture::CreateImage(m_image, m_allocation, m_width, m_height, VK_IMAGE_TYPE_2D, m_samples, mipLevels, m_format, VK_IMAGE_TILING_OPTIMAL,
 		                     m_usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 6);
 
-		if (m_pixels != nullptr || m_mipmap)
-		{
-			Texture::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 6);
-		}
-
-		if (m_pixels != nullptr)
-		{
-			Buffer bufferStaging = Buffer(m_width * m_height * 4 * 6, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-			void *data;
-			Renderer::CheckVk(vkMapMemory(logicalDevice->GetLogicalDevice(), bufferStaging.GetBufferMemory(), 0, bufferStaging.GetSize(), 0, &data));
-			memcpy(data, m_pixels, bufferStaging.GetSize());
-			vkUnmapMemory(logicalDevice->GetLogicalDevice(), bufferStaging.GetBufferMemory());
-
-			Texture::CopyBufferToImage(bufferStaging.GetBuffer(), m_image, m_width, m_height, 0, 6);
-		}
-
-		if (m_mipmap)
-		{
-			Texture::CreateMipmaps(m_image, m_width, m_height, m_layout, mipLevels, 0, 6);
-		}
-		else if (m_pixels != nullptr)
-		{
-			Texture::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 6);
-		}
-		else
-		{
-			Texture::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 6);
-		}
+		Renderer::Get()->GetUploadManager()->UploadImage(m_image, m_format, m_pixels, m_width * m_height * 4 * 6, m_width, m_height, mipLevels, 0, 6, m_layout);
 
 		Texture::CreateImageSampler(m_sampler, m_filter, m_addressMode, m_anisotropic, mipLevels);
 		Texture::CreateImageView(m_image, m_view, VK_IMAGE_VIEW_TYPE_CUBE, m_format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 6);
@@ -210,13 +178,35 @@ namespace acid
 		metadata.SetChild("Mipmap", m_mipmap);
 	}
 
+	std::size_t Cubemap::GetCpuSize() const
+	{
+		std::size_t size = sizeof(Cubemap) + m_filename.capacity() + m_fileSuffix.capacity();
+
+		for (const auto &fileSide : m_fileSides)
+		{
+			size += sizeof(std::string) + fileSide.capacity();
+		}
+
+		if (m_pixels != nullptr)
+		{
+			size += static_cast<std::size_t>(m_width) * m_height * 4 * 6;
+		}
+
+		return size;
+	}
+
+	std::size_t Cubemap::GetGpuSize() const
+	{
+		return m_allocation.GetSize();
+	}
+
 	uint8_t *Cubemap::GetPixels(const uint32_t &arrayLayer) const
 	{
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 
 		VkImage dstImage;
-		VkDeviceMemory dstImageMemory;
-		Texture::CopyImage(m_image, dstImage, dstImageMemory, m_width, m_height, false, arrayLayer, 6);
+		MemoryAllocation dstAllocation;
+		Texture::CopyImage(m_image, dstImage, dstAllocation, m_width, m_height, false, arrayLayer, 6);
 
 		VkImageSubresource imageSubresource = {};
 		imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -228,13 +218,11 @@ namespace acid
 
 		auto result = new uint8_t[subresourceLayout.size];
 
-		void *data;
-		vkMapMemory(logicalDevice->GetLogicalDevice(), dstImageMemory, subresourceLayout.offset, subresourceLayout.size, 0, &data);
+		auto data = static_cast<uint8_t *>(dstAllocation.GetMapped()) + subresourceLayout.offset;
 		memcpy(result, data, static_cast<size_t>(subresourceLayout.size));
-		vkUnmapMemory(logicalDevice->GetLogicalDevice(), dstImageMemory);
 
-		vkFreeMemory(logicalDevice->GetLogicalDevice(), dstImageMemory, nullptr);
 		vkDestroyImage(logicalDevice->GetLogicalDevice(), dstImage, nullptr);
+		Renderer::Get()->GetMemoryAllocator()->Free(dstAllocation);
 
 		return result;
 	}
@@ -254,13 +242,11 @@ namespace acid
 
 	void Cubemap::SetPixels(const uint8_t *pixels)
 	{
-		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
-
 		Buffer bufferStaging = Buffer(m_width * m_height * 4 * 6, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
 		void *data;
-		vkMapMemory(logicalDevice->GetLogicalDevice(), bufferStaging.GetBufferMemory(), 0, bufferStaging.GetSize(), 0, &data);
+		bufferStaging.Map(&data);
 		memcpy(data, pixels, bufferStaging.GetSize());
-		vkUnmapMemory(logicalDevice->GetLogicalDevice(), bufferStaging.GetBufferMemory());
+		bufferStaging.Unmap();
 	}
 }
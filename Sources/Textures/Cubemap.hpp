@@ -4,6 +4,7 @@
 #include <vector>
 #include <vulkan/vulkan.h>
 #include "Renderer/Descriptors/Descriptor.hpp"
+#include "Renderer/Memory/MemoryAllocator.hpp"
 #include "Resources/Resource.hpp"
 
 namespace acid
@@ -79,6 +80,10 @@ namespace acid
 
 		void Encode(Metadata &metadata) const override;
 
+		std::size_t GetCpuSize() const override;
+
+		std::size_t GetGpuSize() const override;
+
 		/// <summary>
 		/// Gets a copy of the face of a cubemaps pixels from memory, after usage is finished remember to delete the result.
 		/// </summary>
@@ -124,7 +129,7 @@ namespace acid
 
 		const VkImage &GetImage() const { return m_image; }
 
-		const VkDeviceMemory &GetDMemory() { return m_memory; }
+		const MemoryAllocation &GetAllocation() const { return m_allocation; }
 
 		const VkImageView &GetView() const { return m_view; }
 
@@ -147,7 +152,7 @@ namespace acid
 		uint8_t *m_pixels;
 
 		VkImage m_image;
-		VkDeviceMemory m_memory;
+		MemoryAllocation m_allocation;
 		VkImageView m_view;
 		VkSampler m_sampler;
 		VkFormat m_format;
@@ -0,0 +1,170 @@
+#include "DepthPyramid.hpp"
+
+#include <algorithm>
+#include "Renderer/Renderer.hpp"
+#include "Texture.hpp"
+
+namespace acid
+{
+	DepthPyramid::DepthPyramid(const uint32_t &width, const uint32_t &height) :
+		m_width(width),
+		m_height(height),
+		m_mipLevels(Texture::GetMipLevels(width, height)),
+		m_image(VK_NULL_HANDLE),
+		m_imageView(VK_NULL_HANDLE),
+		m_sampler(VK_NULL_HANDLE),
+		m_pipeline("Shaders/DepthPyramid.comp", width, height, 16, false, {}, m_mipLevels)
+	{
+		Texture::CreateImage(m_image, m_imageAllocation, m_width, m_height, VK_IMAGE_TYPE_2D, VK_SAMPLE_COUNT_1_BIT, m_mipLevels, VK_FORMAT_R32_SFLOAT, 
+			VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1);
+		Texture::TransitionImageLayout(m_image, VK_FORMAT_R32_SFLOAT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1);
+		Texture::CreateImageSampler(m_sampler, VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, false, m_mipLevels);
+		Texture::CreateImageView(m_image, m_imageView, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels, 0, 1);
+
+		// Each level is written through its own view, and read through it by the next level.
+		for (uint32_t i = 0; i < m_mipLevels; i++)
+		{
+			VkImageView levelView = VK_NULL_HANDLE;
+			Texture::CreateImageView(m_image, levelView, VK_IMAGE_VIEW_TYPE_2D, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT, 1, 0, 1, i);
+			m_levels.emplace_back(std::make_unique<LevelView>(levelView, m_sampler, VK_IMAGE_LAYOUT_GENERAL));
+			m_descriptorSets.emplace_back(m_pipeline);
+		}
+	}
+
+	DepthPyramid::~DepthPyramid()
+	{
+		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
+
+		for (const auto &level : m_levels)
+		{
+			vkDestroyImageView(logicalDevice->GetLogicalDevice(), level->GetImageView(), nullptr);
+		}
+
+		vkDestroySampler(logicalDevice->GetLogicalDevice(), m_sampler, nullptr);
+		vkDestroyImageView(logicalDevice->GetLogicalDevice(), m_imageView, nullptr);
+		vkDestroyImage(logicalDevice->GetLogicalDevice(), m_image, nullptr);
+		Renderer::Get()->GetMemoryAllocator()->Free(m_imageAllocation);
+	}
+
+	bool DepthPyramid::CmdBuild(const CommandBuffer &commandBuffer, const DepthStencil &depthStencil)
+	{
+		if (depthStencil.GetWidth() != m_width || depthStencil.GetHeight() != m_height || depthStencil.GetSamples() != VK_SAMPLE_COUNT_1_BIT)
+		{
+			return false;
+		}
+
+		// The depth is read in the read only layout it is transitioned into below, not the attachment layout it is usually bound in.
+		if (m_depthView == nullptr || m_depthView->GetImageView() != depthStencil.GetImageView())
+		{
+			m_depthView = std::make_unique<LevelView>(depthStencil.GetImageView(), m_sampler, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+		}
+
+		// Updates the descriptors of every level before recording, so nothing is left half recorded.
+		for (uint32_t i = 0; i < m_mipLevels; i++)
+		{
+			auto &descriptorSet = m_descriptorSets[i];
+			descriptorSet.Push("outDepth", *m_levels[i]);
+
+			if (i == 0)
+			{
+				descriptorSet.Push("samplerDepth", *m_depthView);
+			}
+			else
+			{
+				descriptorSet.Push("samplerDepth", *m_levels[i - 1]);
+			}
+
+			if (!descriptorSet.Update(m_pipeline))
+			{
+				return false;
+			}
+		}
+
+		VkImageSubresourceRange depthRange = {};
+		depthRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+		depthRange.baseMipLevel = 0;
+		depthRange.levelCount = 1;
+		depthRange.baseArrayLayer = 0;
+		depthRange.layerCount = 1;
+
+		if (Texture::HasStencil(depthStencil.GetFormat()))
+		{
+			depthRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+		}
+
+		// The depth written by the last renderpass is read by the first level.
+		Texture::InsertImageMemoryBarrier(commandBuffer.GetCommandBuffer(), depthStencil.GetImage(), VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, depthRange);
+
+		// The levels are not written until the last frames culling passes have read them.
+		vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 
+			0, nullptr);
+
+		m_pipeline.BindPipeline(commandBuffer);
+
+		for (uint32_t i = 0; i < m_mipLevels; i++)
+		{
+			m_descriptorSets[i].BindDescriptor(commandBuffer, m_pipeline);
+			m_pipeline.CmdRender(commandBuffer, std::max(m_width >> i, 1u), std::max(m_height >> i, 1u));
+
+			// Each level is read by the next level, the last level is read by culling passes.
+			VkMemoryBarrier memoryBarrier = {};
+			memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 
+				0, nullptr, 0, nullptr);
+		}
+
+		// The depth is returned to the layout the renderpass expects.
+		Texture::InsertImageMemoryBarrier(commandBuffer.GetCommandBuffer(), depthStencil.GetImage(), VK_ACCESS_SHADER_READ_BIT, 
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, 
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 
+			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, depthRange);
+		return true;
+	}
+
+	WriteDescriptorSet DepthPyramid::GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType,
+		const VkDescriptorSet &descriptorSet, const std::optional<OffsetSize> &offsetSize) const
+	{
+		VkDescriptorImageInfo imageInfo = {};
+		imageInfo.sampler = m_sampler;
+		imageInfo.imageView = m_imageView;
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+		VkWriteDescriptorSet descriptorWrite = {};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = descriptorSet;
+		descriptorWrite.dstBinding = binding;
+		descriptorWrite.dstArrayElement = 0;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.descriptorType = descriptorType;
+		return WriteDescriptorSet(descriptorWrite, imageInfo);
+	}
+
+	DepthPyramid::LevelView::LevelView(const VkImageView &imageView, const VkSampler &sampler, const VkImageLayout &imageLayout) :
+		m_imageView(imageView),
+		m_sampler(sampler),
+		m_imageLayout(imageLayout)
+	{
+	}
+
+	WriteDescriptorSet DepthPyramid::LevelView::GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType,
+		const VkDescriptorSet &descriptorSet, const std::optional<OffsetSize> &offsetSize) const
+	{
+		VkDescriptorImageInfo imageInfo = {};
+		imageInfo.sampler = m_sampler;
+		imageInfo.imageView = m_imageView;
+		imageInfo.imageLayout = m_imageLayout;
+
+		VkWriteDescriptorSet descriptorWrite = {};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = descriptorSet;
+		descriptorWrite.dstBinding = binding;
+		descriptorWrite.dstArrayElement = 0;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.descriptorType = descriptorType;
+		return WriteDescriptorSet(descriptorWrite, imageInfo);
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Renderer/Commands/CommandBuffer.hpp"
+#include "Renderer/Descriptors/Descriptor.hpp"
+#include "Renderer/Handlers/DescriptorsHandler.hpp"
+#include "Renderer/Memory/MemoryAllocator.hpp"
+#include "Renderer/Pipelines/PipelineCompute.hpp"
+#include "DepthStencil.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// A hierarchical depth buffer, each mip level holds the furthest depth of the texels it covers in the level above.
+	/// Built from a depth attachment with a compute pass, and used to test if bounding volumes are hidden behind what was drawn.
+	/// The image is kept in the general layout, bound as a sampler it is read with texelFetch.
+	/// </summary>
+	class ACID_EXPORT DepthPyramid :
+		public Descriptor
+	{
+	public:
+		/// <summary>
+		/// Creates a new depth pyramid.
+		/// </summary>
+		/// <param name="width"> The width of the first mip level, the same as the depth attachment. </param>
+		/// <param name="height"> The height of the first mip level, the same as the depth attachment. </param>
+		DepthPyramid(const uint32_t &width, const uint32_t &height);
+
+		~DepthPyramid();
+
+		/// <summary>
+		/// Records the reduction of a depth attachment into the pyramid, the depth attachment must have been written by a previous renderpass.
+		/// The depth is sampled in the read only layout and returned to the attachment layout, ready for the next renderpass that uses it.
+		/// </summary>
+		/// <param name="commandBuffer"> The command buffer to record into, outside of a renderpass. </param>
+		/// <param name="depthStencil"> The depth attachment to reduce, with the same size as the pyramid and a single sample. </param>
+		/// <returns> If the pyramid was built. </returns>
+		bool CmdBuild(const CommandBuffer &commandBuffer, const DepthStencil &depthStencil);
+
+		WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType,
+			const VkDescriptorSet &descriptorSet, const std::optional<OffsetSize> &offsetSize) const override;
+
+		const uint32_t &GetWidth() const { return m_width; }
+
+		const uint32_t &GetHeight() const { return m_height; }
+
+		const uint32_t &GetMipLevels() const { return m_mipLevels; }
+
+		const VkImage &GetImage() const { return m_image; }
+	private:
+		/// <summary>
+		/// A image view bound in a set layout, used for single mip levels and for the depth attachment being reduced.
+		/// </summary>
+		class LevelView :
+			public Descriptor
+		{
+		public:
+			LevelView(const VkImageView &imageView, const VkSampler &sampler, const VkImageLayout &imageLayout);
+
+			WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType,
+				const VkDescriptorSet &descriptorSet, const std::optional<OffsetSize> &offsetSize) const override;
+
+			const VkImageView &GetImageView() const { return m_imageView; }
+		private:
+			VkImageView m_imageView;
+			VkSampler m_sampler;
+			VkImageLayout m_imageLayout;
+		};
+
+		uint32_t m_width, m_height;
+		uint32_t m_mipLevels;
+
+		VkImage m_image;
+		MemoryAllocation m_imageAllocation;
+		VkImageView m_imageView;
+		VkSampler m_sampler;
+		std::vector<std::unique_ptr<LevelView>> m_levels;
+		std::unique_ptr<LevelView> m_depthView;
+
+		PipelineCompute m_pipeline;
+		std::vector<DescriptorsHandler> m_descriptorSets;
+	};
+}
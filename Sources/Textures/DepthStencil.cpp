@@ -19,6 +19,7 @@ namespace acid
 		Buffer(width * height * 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
 		m_width(width),
 		m_height(height),
+		m_samples(samples),
 		m_image(VK_NULL_HANDLE),
 		m_imageView(VK_NULL_HANDLE),
 		m_sampler(VK_NULL_HANDLE),
@@ -50,7 +51,7 @@ namespace acid
 			aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
 		}
 
-		Texture::CreateImage(m_image, m_bufferMemory, m_width, m_height, VK_IMAGE_TYPE_2D, samples, 1, m_format, VK_IMAGE_TILING_OPTIMAL, 
+		Texture::CreateImage(m_image, m_imageAllocation, m_width, m_height, VK_IMAGE_TYPE_2D, samples, 1, m_format, VK_IMAGE_TILING_OPTIMAL, 
 			VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1);
 		Texture::TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, 
 			aspectMask, 1, 0, 1);
@@ -65,6 +66,7 @@ namespace acid
 		vkDestroySampler(logicalDevice->GetLogicalDevice(), m_sampler, nullptr);
 		vkDestroyImageView(logicalDevice->GetLogicalDevice(), m_imageView, nullptr);
 		vkDestroyImage(logicalDevice->GetLogicalDevice(), m_image, nullptr);
+		Renderer::Get()->GetMemoryAllocator()->Free(m_imageAllocation);
 	}
 
 	VkDescriptorSetLayoutBinding DepthStencil::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage)
@@ -28,10 +28,14 @@ namespace acid
 		const VkImageView &GetImageView() const { return m_imageView; }
 
 		const VkFormat &GetFormat() const { return m_format; }
+
+		const VkSampleCountFlagBits &GetSamples() const { return m_samples; }
 	private:
 		uint32_t m_width, m_height;
+		VkSampleCountFlagBits m_samples;
 
 		VkImage m_image;
+		MemoryAllocation m_imageAllocation;
 		VkImageView m_imageView;
 		VkSampler m_sampler;
 		VkFormat m_format;
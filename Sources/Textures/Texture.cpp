@@ -21,11 +21,11 @@ namespace acid
 
 	std::shared_ptr<Texture> Texture::Create(const Metadata &metadata)
 	{
-		auto resource = Resources::Get()->Find(metadata);
+		auto resource = Resources::Get()->Find<Texture>(metadata);
 
 		if (resource != nullptr)
 		{
-			return std::dynamic_pointer_cast<Texture>(resource);
+			return resource;
 		}
 
 		auto result = std::make_shared<Texture>("");
@@ -57,7 +57,6 @@ namespace acid
 		m_height(0),
 		m_pixels(nullptr),
 		m_image(VK_NULL_HANDLE),
-		m_memory(VK_NULL_HANDLE),
 		m_view(VK_NULL_HANDLE),
 		m_sampler(VK_NULL_HANDLE),
 		m_format(VK_FORMAT_R8G8B8A8_UNORM)
@@ -83,7 +82,6 @@ namespace acid
 		m_height(height),
 		m_pixels(pixels),
 		m_image(VK_NULL_HANDLE),
-		m_memory(VK_NULL_HANDLE),
 		m_view(VK_NULL_HANDLE),
 		m_sampler(VK_NULL_HANDLE),
 		m_format(format)
@@ -97,8 +95,8 @@ namespace acid
 
 		vkDestroySampler(logicalDevice->GetLogicalDevice(), m_sampler, nullptr);
 		vkDestroyImageView(logicalDevice->GetLogicalDevice(), m_view, nullptr);
-		vkFreeMemory(logicalDevice->GetLogicalDevice(), m_memory, nullptr);
 		vkDestroyImage(logicalDevice->GetLogicalDevice(), m_image, nullptr);
+		Renderer::Get()->GetMemoryAllocator()->Free(m_allocation);
 	}
 
 	VkDescriptorSetLayoutBinding Texture::GetDescriptorSetLayout(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkShaderStageFlags &stage, const uint32_t &count)
@@ -131,7 +129,7 @@ namespace acid
 		return WriteDescriptorSet(descriptorWrite, imageInfo);
 	}
 
-	void Texture::Load()
+	void Texture::Prepare()
 	{
 		if (!m_filename.empty() && m_pixels == nullptr)
 		{
@@ -144,46 +142,23 @@ namespace acid
 			Log::Out("Texture '%s' loaded in %ims\n", m_filename.c_str(), (debugEnd - debugStart).AsMilliseconds());
 #endif
 		}
+	}
+
+	void Texture::Load()
+	{
+		Prepare();
 
 		if (m_width == 0 && m_height == 0)
 		{
 			return;
 		}
 
-		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 		auto mipLevels = m_mipmap ? GetMipLevels(m_width, m_height) : 1;
 
-		CreateImage(m_image, m_memory, m_width, m_height, VK_IMAGE_TYPE_2D, m_samples, mipLevels, m_format, VK_IMAGE_TILING_OPTIMAL, m_usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1);
+		CreateImage(m_image, m_allocation, m_width, m_height, VK_IMAGE_TYPE_2D, m_samples, mipLevels, m_format, VK_IMAGE_TILING_OPTIMAL, m_usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 1);
 
-		if (m_pixels != nullptr || m_mipmap)
-		{
-			TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1);
-		}
-
-		if (m_pixels != nullptr)
-		{
-			Buffer bufferStaging = Buffer(m_width * m_height * 4, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-			void *data;
-			vkMapMemory(logicalDevice->GetLogicalDevice(), bufferStaging.GetBufferMemory(), 0, bufferStaging.GetSize(), 0, &data);
-			memcpy(data, m_pixels, bufferStaging.GetSize());
-			vkUnmapMemory(logicalDevice->GetLogicalDevice(), bufferStaging.GetBufferMemory());
-
-			CopyBufferToImage(bufferStaging.GetBuffer(), m_image, m_width, m_height, 0, 1);
-		}
-
-		if (m_mipmap)
-		{
-			CreateMipmaps(m_image, m_width, m_height, m_layout, mipLevels, 0, 1);
-		}
-		else if (m_pixels != nullptr)
-		{
-			TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1);
-		}
-		else
-		{
-			TransitionImageLayout(m_image, m_format, VK_IMAGE_LAYOUT_UNDEFINED, m_layout, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1);
-		}
+		// Recorded into the next upload batch, the image is ready for anything submitted after it.
+		Renderer::Get()->GetUploadManager()->UploadImage(m_image, m_format, m_pixels, m_width * m_height * 4, m_width, m_height, mipLevels, 0, 1, m_layout);
 
 		CreateImageSampler(m_sampler, m_filter, m_addressMode, m_anisotropic, mipLevels);
 		CreateImageView(m_image, m_view, VK_IMAGE_VIEW_TYPE_2D, m_format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, 0, 1);
@@ -208,13 +183,32 @@ namespace acid
 		metadata.SetChild("Mipmap", m_mipmap);
 	}
 
+	std::size_t Texture::GetCpuSize() const
+	{
+		std::size_t size = sizeof(Texture) + m_filename.capacity();
+
+		// Pixels are only held until they have been uploaded.
+		if (m_pixels != nullptr)
+		{
+			size += static_cast<std::size_t>(m_width) * m_height * 4;
+		}
+
+		return size;
+	}
+
+	std::size_t Texture::GetGpuSize() const
+	{
+		// The allocation is sized by the driver for the images format, samples and mip chain.
+		return m_allocation.GetSize();
+	}
+
 	uint8_t *Texture::GetPixels() const
 	{
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 
 		VkImage dstImage;
-		VkDeviceMemory dstImageMemory;
-		CopyImage(m_image, dstImage, dstImageMemory, m_width, m_height, false, 0, 1);
+		MemoryAllocation dstAllocation;
+		CopyImage(m_image, dstImage, dstAllocation, m_width, m_height, false, 0, 1);
 
 		VkImageSubresource imageSubresource = {};
 		imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -226,27 +220,23 @@ namespace acid
 
 		auto result = new uint8_t[subresourceLayout.size];
 
-		void *data;
-		vkMapMemory(logicalDevice->GetLogicalDevice(), dstImageMemory, subresourceLayout.offset, subresourceLayout.size, 0, &data);
+		auto data = static_cast<uint8_t *>(dstAllocation.GetMapped()) + subresourceLayout.offset;
 		std::memcpy(result, data, static_cast<size_t>(subresourceLayout.size));
-		vkUnmapMemory(logicalDevice->GetLogicalDevice(), dstImageMemory);
 
-		vkFreeMemory(logicalDevice->GetLogicalDevice(), dstImageMemory, nullptr);
 		vkDestroyImage(logicalDevice->GetLogicalDevice(), dstImage, nullptr);
+		Renderer::Get()->GetMemoryAllocator()->Free(dstAllocation);
 
 		return result;
 	}
 
 	void Texture::SetPixels(const uint8_t *pixels)
 	{
-		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
-
 		Buffer bufferStaging = Buffer(m_width * m_height * 4, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
 		void *data;
-		vkMapMemory(logicalDevice->GetLogicalDevice(), bufferStaging.GetBufferMemory(), 0, bufferStaging.GetSize(), 0, &data);
+		bufferStaging.Map(&data);
 		std::memcpy(data, pixels, bufferStaging.GetSize());
-		vkUnmapMemory(logicalDevice->GetLogicalDevice(), bufferStaging.GetBufferMemory());
+		bufferStaging.Unmap();
 	}
 
 	uint8_t *Texture::LoadPixels(const std::string &filename, uint32_t *width, uint32_t *height, uint32_t *components)
@@ -346,7 +336,7 @@ namespace acid
 		return std::find(STENCIL_FORMATS.begin(), STENCIL_FORMATS.end(), format) != std::end(STENCIL_FORMATS);
 	}
 
-	void Texture::CreateImage(VkImage &image, VkDeviceMemory &memory, const uint32_t &width, const uint32_t &height, const VkImageType &type, const VkSampleCountFlagBits &samples, 
+	void Texture::CreateImage(VkImage &image, MemoryAllocation &allocation, const uint32_t &width, const uint32_t &height, const VkImageType &type, const VkSampleCountFlagBits &samples, 
 		const uint32_t &mipLevels, const VkFormat &format, const VkImageTiling &tiling, const VkImageUsageFlags &usage, const VkMemoryPropertyFlags &properties, const uint32_t &arrayLayers)
 	{
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
@@ -369,13 +359,9 @@ namespace acid
 		VkMemoryRequirements memoryRequirements;
 		vkGetImageMemoryRequirements(logicalDevice->GetLogicalDevice(), image, &memoryRequirements);
 
-		VkMemoryAllocateInfo memoryAllocateInfo = {};
-		memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		memoryAllocateInfo.allocationSize = memoryRequirements.size;
-		memoryAllocateInfo.memoryTypeIndex = Buffer::FindMemoryType(memoryRequirements.memoryTypeBits, properties);
-		Renderer::CheckVk(vkAllocateMemory(logicalDevice->GetLogicalDevice(), &memoryAllocateInfo, nullptr, &memory));
+		allocation = Renderer::Get()->GetMemoryAllocator()->Allocate(memoryRequirements, properties, tiling == VK_IMAGE_TILING_LINEAR);
 
-		Renderer::CheckVk(vkBindImageMemory(logicalDevice->GetLogicalDevice(), image, memory, 0));
+		Renderer::CheckVk(vkBindImageMemory(logicalDevice->GetLogicalDevice(), image, allocation.GetMemory(), allocation.GetOffset()));
 	}
 
 	bool Texture::HasStencilComponent(const VkFormat &format)
@@ -387,7 +373,14 @@ namespace acid
 		const VkImageAspectFlags &aspectMask, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount)
 	{
 		CommandBuffer commandBuffer = CommandBuffer();
+		TransitionImageLayout(commandBuffer.GetCommandBuffer(), image, format, srcImageLayout, dstImageLayout, aspectMask, mipLevels, baseArrayLayer, layerCount);
+		commandBuffer.End();
+		commandBuffer.SubmitIdle();
+	}
 
+	void Texture::TransitionImageLayout(const VkCommandBuffer &commandBuffer, const VkImage &image, const VkFormat &format, const VkImageLayout &srcImageLayout, 
+		const VkImageLayout &dstImageLayout, const VkImageAspectFlags &aspectMask, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount)
+	{
 		VkImageMemoryBarrier imageMemoryBarrier = {};
 		imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 		imageMemoryBarrier.oldLayout = srcImageLayout;
@@ -459,18 +452,22 @@ namespace acid
 		VkPipelineStageFlags srcStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
 		VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
 
-		vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-
-		commandBuffer.End();
-		commandBuffer.SubmitIdle();
+		vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 	}
 
 	void Texture::CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, const uint32_t &width, const uint32_t &height, const uint32_t &baseArrayLayer, const uint32_t &layerCount)
 	{
 		CommandBuffer commandBuffer = CommandBuffer();
+		CopyBufferToImage(commandBuffer.GetCommandBuffer(), buffer, image, width, height, baseArrayLayer, layerCount);
+		commandBuffer.End();
+		commandBuffer.SubmitIdle();
+	}
 
+	void Texture::CopyBufferToImage(const VkCommandBuffer &commandBuffer, const VkBuffer &buffer, const VkImage &image, const uint32_t &width, const uint32_t &height, 
+		const uint32_t &baseArrayLayer, const uint32_t &layerCount, const VkDeviceSize &bufferOffset)
+	{
 		VkBufferImageCopy region = {};
-		region.bufferOffset = 0;
+		region.bufferOffset = bufferOffset;
 		region.bufferRowLength = 0;
 		region.bufferImageHeight = 0;
 		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -479,17 +476,21 @@ namespace acid
 		region.imageSubresource.layerCount = layerCount;
 		region.imageOffset = {0, 0, 0};
 		region.imageExtent = {width, height, 1};
-		vkCmdCopyBufferToImage(commandBuffer.GetCommandBuffer(), buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-		commandBuffer.End();
-		commandBuffer.SubmitIdle();
+		vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 	}
 
 	void Texture::CreateMipmaps(const VkImage &image, const uint32_t &width, const uint32_t &height, const VkImageLayout &dstImageLayout, 
 		const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount)
 	{
 		CommandBuffer commandBuffer = CommandBuffer();
+		CreateMipmaps(commandBuffer.GetCommandBuffer(), image, width, height, dstImageLayout, mipLevels, baseArrayLayer, layerCount);
+		commandBuffer.End();
+		commandBuffer.SubmitIdle();
+	}
 
+	void Texture::CreateMipmaps(const VkCommandBuffer &commandBuffer, const VkImage &image, const uint32_t &width, const uint32_t &height, 
+		const VkImageLayout &dstImageLayout, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount)
+	{
 		int32_t mipWidth = width;
 		int32_t mipHeight = height;
 
@@ -509,7 +510,7 @@ namespace acid
 			barrier0.subresourceRange.levelCount = 1;
 			barrier0.subresourceRange.baseArrayLayer = baseArrayLayer;
 			barrier0.subresourceRange.layerCount = layerCount;
-			vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier0);
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier0);
 
 			VkImageBlit imageBlit = {};
 			imageBlit.srcOffsets[0] = {0, 0, 0};
@@ -524,7 +525,7 @@ namespace acid
 			imageBlit.dstSubresource.mipLevel = i;
 			imageBlit.dstSubresource.baseArrayLayer = baseArrayLayer;
 			imageBlit.dstSubresource.layerCount = layerCount;
-			vkCmdBlitImage(commandBuffer.GetCommandBuffer(), image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit, VK_FILTER_LINEAR);
+			vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit, VK_FILTER_LINEAR);
 
 			VkImageMemoryBarrier barrier1 = {};
 			barrier1.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -540,7 +541,7 @@ namespace acid
 			barrier1.subresourceRange.levelCount = 1;
 			barrier1.subresourceRange.baseArrayLayer = baseArrayLayer;
 			barrier1.subresourceRange.layerCount = layerCount;
-			vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier1);
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier1);
 
 			if (mipWidth > 1)
 			{
@@ -567,10 +568,7 @@ namespace acid
 		barrier.subresourceRange.levelCount = 1;
 		barrier.subresourceRange.baseArrayLayer = baseArrayLayer;
 		barrier.subresourceRange.layerCount = layerCount;
-		vkCmdPipelineBarrier(commandBuffer.GetCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-		commandBuffer.End();
-		commandBuffer.SubmitIdle();
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
 	}
 
 	void Texture::CreateImageSampler(VkSampler &sampler, const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic, const uint32_t &mipLevels)
@@ -599,7 +597,7 @@ namespace acid
 	}
 
 	void Texture::CreateImageView(const VkImage &image, VkImageView &imageView, const VkImageViewType &type, const VkFormat &format, 
-		const VkImageAspectFlags &imageAspect, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount)
+		const VkImageAspectFlags &imageAspect, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount, const uint32_t &baseMipLevel)
 	{
 		auto logicalDevice = Renderer::Get()->GetLogicalDevice();
 
@@ -616,14 +614,14 @@ namespace acid
 		};
 		imageViewCreateInfo.subresourceRange = {};
 		imageViewCreateInfo.subresourceRange.aspectMask = imageAspect;
-		imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+		imageViewCreateInfo.subresourceRange.baseMipLevel = baseMipLevel;
 		imageViewCreateInfo.subresourceRange.levelCount = mipLevels;
 		imageViewCreateInfo.subresourceRange.baseArrayLayer = baseArrayLayer;
 		imageViewCreateInfo.subresourceRange.layerCount = layerCount;
 		Renderer::CheckVk(vkCreateImageView(logicalDevice->GetLogicalDevice(), &imageViewCreateInfo, nullptr, &imageView));
 	}
 
-	bool Texture::CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory &dstImageMemory, const uint32_t &width, const uint32_t &height, const bool &srcSwapchain, const uint32_t &baseArrayLayer, const uint32_t &layerCount)
+	bool Texture::CopyImage(const VkImage &srcImage, VkImage &dstImage, MemoryAllocation &dstAllocation, const uint32_t &width, const uint32_t &height, const bool &srcSwapchain, const uint32_t &baseArrayLayer, const uint32_t &layerCount)
 	{
 		auto physicalDevice = Renderer::Get()->GetPhysicalDevice();
 		auto surface = Renderer::Get()->GetSurface();
@@ -648,7 +646,7 @@ namespace acid
 			supportsBlit = false;
 		}
 
-		CreateImage(dstImage, dstImageMemory, width, height, VK_IMAGE_TYPE_2D, VK_SAMPLE_COUNT_1_BIT, 1, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_LINEAR, 
+		CreateImage(dstImage, dstAllocation, width, height, VK_IMAGE_TYPE_2D, VK_SAMPLE_COUNT_1_BIT, 1, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_LINEAR, 
 			VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1);
 
 		// Do the actual blit from the swapchain image to our host visible destination image.
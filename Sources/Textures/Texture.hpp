@@ -4,6 +4,7 @@
 #include <vector>
 #include <vulkan/vulkan.h>
 #include "Renderer/Descriptors/Descriptor.hpp"
+#include "Renderer/Memory/MemoryAllocator.hpp"
 #include "Resources/Resource.hpp"
 
 namespace acid
@@ -42,7 +43,7 @@ namespace acid
 		/// <param name="anisotropic"> If anisotropic filtering will be use on the texture. </param>
 		/// <param name="mipmap"> If mipmaps will be generated for the texture. </param>
 		/// <param name="load"> If this resource will load immediately, otherwise <seealso cref="#Load()"/> can be called. </param>
-		explicit Texture(std::string filename, const VkFilter &filter = VK_FILTER_LINEAR, const VkSamplerAddressMode &addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+		explicit Texture(std::string filename = "", const VkFilter &filter = VK_FILTER_LINEAR, const VkSamplerAddressMode &addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
 			const bool &anisotropic = true, const bool &mipmap = true, const bool &load = true);
 
 		/// <summary>
@@ -71,12 +72,18 @@ namespace acid
 		WriteDescriptorSet GetWriteDescriptor(const uint32_t &binding, const VkDescriptorType &descriptorType, const VkDescriptorSet &descriptorSet, 
 			const std::optional<OffsetSize> &offsetSize) const override;
 
+		void Prepare() override;
+
 		void Load() override;
 
 		void Decode(const Metadata &metadata) override;
 
 		void Encode(Metadata &metadata) const override;
 
+		std::size_t GetCpuSize() const override;
+
+		std::size_t GetGpuSize() const override;
+
 		/// <summary>
 		/// Gets a copy of the textures pixels from memory, after usage is finished remember to delete the result.
 		/// </summary>
@@ -113,7 +120,7 @@ namespace acid
 
 		const VkImage &GetImage() { return m_image; }
 
-		const VkDeviceMemory &GetDMemory() { return m_memory; }
+		const MemoryAllocation &GetAllocation() const { return m_allocation; }
 
 		const VkImageView &GetView() const { return m_view; }
 
@@ -141,7 +148,7 @@ namespace acid
 		/// <returns> If this has a stencil component. </returns>
 		static bool HasStencil(const VkFormat &format);
 
-		static void CreateImage(VkImage &image, VkDeviceMemory &memory, const uint32_t &width, const uint32_t &height, const VkImageType &type, const VkSampleCountFlagBits &samples, 
+		static void CreateImage(VkImage &image, MemoryAllocation &allocation, const uint32_t &width, const uint32_t &height, const VkImageType &type, const VkSampleCountFlagBits &samples, 
 			const uint32_t &mipLevels, const VkFormat &format, const VkImageTiling &tiling, const VkImageUsageFlags &usage, const VkMemoryPropertyFlags &properties, const uint32_t &arrayLayers);
 
 		static bool HasStencilComponent(const VkFormat &format);
@@ -149,19 +156,28 @@ namespace acid
 		static void TransitionImageLayout(const VkImage &image, const VkFormat &format, const VkImageLayout &srcImageLayout, const VkImageLayout &dstImageLayout, 
 			const VkImageAspectFlags &aspectMask, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount);
 
+		static void TransitionImageLayout(const VkCommandBuffer &commandBuffer, const VkImage &image, const VkFormat &format, const VkImageLayout &srcImageLayout, 
+			const VkImageLayout &dstImageLayout, const VkImageAspectFlags &aspectMask, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount);
+
 		static void CopyBufferToImage(const VkBuffer &buffer, const VkImage &image, const uint32_t &width, const uint32_t &height, 
 			const uint32_t &baseArrayLayer, const uint32_t &layerCount);
 
+		static void CopyBufferToImage(const VkCommandBuffer &commandBuffer, const VkBuffer &buffer, const VkImage &image, const uint32_t &width, const uint32_t &height, 
+			const uint32_t &baseArrayLayer, const uint32_t &layerCount, const VkDeviceSize &bufferOffset = 0);
+
 		static void CreateMipmaps(const VkImage &image, const uint32_t &width, const uint32_t &height, const VkImageLayout &dstImageLayout, 
 			const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount);
 
+		static void CreateMipmaps(const VkCommandBuffer &commandBuffer, const VkImage &image, const uint32_t &width, const uint32_t &height, 
+			const VkImageLayout &dstImageLayout, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount);
+
 		static void CreateImageSampler(VkSampler &sampler, const VkFilter &filter, const VkSamplerAddressMode &addressMode, const bool &anisotropic,
 			const uint32_t &mipLevels);
 
 		static void CreateImageView(const VkImage &image, VkImageView &imageView, const VkImageViewType &type, const VkFormat &format, 
-			const VkImageAspectFlags &imageAspect, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount);
+			const VkImageAspectFlags &imageAspect, const uint32_t &mipLevels, const uint32_t &baseArrayLayer, const uint32_t &layerCount, const uint32_t &baseMipLevel = 0);
 
-		static bool CopyImage(const VkImage &srcImage, VkImage &dstImage, VkDeviceMemory &dstImageMemory, const uint32_t &width, const uint32_t &height, const bool &srcSwapchain, const uint32_t &baseArrayLayer, const uint32_t &layerCount);
+		static bool CopyImage(const VkImage &srcImage, VkImage &dstImage, MemoryAllocation &dstAllocation, const uint32_t &width, const uint32_t &height, const bool &srcSwapchain, const uint32_t &baseArrayLayer, const uint32_t &layerCount);
 
 		static void InsertImageMemoryBarrier(const VkCommandBuffer &cmdbuffer, const VkImage &image, const VkAccessFlags &srcAccessMask, 
 			const VkAccessFlags &dstAccessMask, const VkImageLayout &oldImageLayout, const VkImageLayout &newImageLayout, const VkPipelineStageFlags &srcStageMask, 
@@ -182,7 +198,7 @@ namespace acid
 		uint8_t *m_pixels;
 
 		VkImage m_image;
-		VkDeviceMemory m_memory;
+		MemoryAllocation m_allocation;
 		VkImageView m_view;
 		VkSampler m_sampler;
 		VkFormat m_format;
@@ -0,0 +1,33 @@
+#include "Job.hpp"
+
+#include <utility>
+
+namespace acid
+{
+	Job::Job(std::function<void()> function, std::shared_ptr<Job> parent) :
+		m_function(std::move(function)),
+		m_parent(std::move(parent)),
+		m_unfinished(1)
+	{
+		if (m_parent != nullptr)
+		{
+			m_parent->m_unfinished.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void Job::Finish()
+	{
+		if (m_unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			return;
+		}
+
+		// Releases the function now, captured state may hold resources.
+		m_function = nullptr;
+
+		if (m_parent != nullptr)
+		{
+			m_parent->Finish();
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "Helpers/NonCopyable.hpp"
+
+namespace acid
+{
+	/// <summary>
+	/// A unit of work scheduled on a <seealso cref="ThreadPool"/>. A job is finished once its function and all of its children have run.
+	/// </summary>
+	class ACID_EXPORT Job :
+		public NonCopyable
+	{
+	public:
+		/// <summary>
+		/// Creates a new job, jobs are normally created through <seealso cref="ThreadPool#Submit()"/>.
+		/// </summary>
+		/// <param name="function"> The function to run, may be empty for jobs that only group children. </param>
+		/// <param name="parent"> The parent job that will not finish until this job has finished. </param>
+		explicit Job(std::function<void()> function = {}, std::shared_ptr<Job> parent = nullptr);
+
+		/// <summary>
+		/// Gets if this job and all of its children have finished.
+		/// </summary>
+		/// <returns> If the job is finished. </returns>
+		bool IsFinished() const { return m_unfinished.load(std::memory_order_acquire) == 0; }
+
+		/// <summary>
+		/// Gets the parent job of this job.
+		/// </summary>
+		/// <returns> The parent job. </returns>
+		const std::shared_ptr<Job> &GetParent() const { return m_parent; }
+	private:
+		friend class ThreadPool;
+
+		/// <summary>
+		/// Marks one unfinished unit of this job as completed, propagating to the parent when the last unit finishes.
+		/// </summary>
+		void Finish();
+
+		std::function<void()> m_function;
+		std::shared_ptr<Job> m_parent;
+		std::atomic<uint32_t> m_unfinished;
+	};
+}
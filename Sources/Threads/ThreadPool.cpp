@@ -1,22 +1,239 @@
 #include "ThreadPool.hpp"
 
+#include <algorithm>
+#include "Engine/Profiler.hpp"
+
 namespace acid
 {
 	const uint32_t ThreadPool::HardwareConcurrency = std::thread::hardware_concurrency();
 
-	ThreadPool::ThreadPool(const uint32_t &threadCount)
+	// The pool and worker index of the calling thread, used to push into and pop from the threads own deque.
+	static thread_local ThreadPool *CURRENT_POOL = nullptr;
+	static thread_local uint32_t CURRENT_WORKER = 0;
+
+	ThreadPool::ThreadPool(const uint32_t &threadCount) :
+		m_queued(0),
+		m_pending(0),
+		m_nextWorker(0),
+		m_destroying(false)
 	{
-		for (uint32_t i = 0; i < threadCount; i++)
+		auto workerCount = std::max(threadCount, 1u);
+
+		for (uint32_t i = 0; i < workerCount; i++)
+		{
+			m_workers.emplace_back(std::make_unique<Worker>());
+		}
+
+		// Workers are started after all deques exist, as any worker may steal from any other.
+		for (uint32_t i = 0; i < workerCount; i++)
 		{
-			m_threads.emplace_back(std::make_unique<Thread>());
+			m_workers[i]->m_thread = std::thread(&ThreadPool::WorkerLoop, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		Wait();
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_destroying = true;
+		}
+
+		m_sleepCondition.notify_all();
+
+		for (auto &worker : m_workers)
+		{
+			if (worker->m_thread.joinable())
+			{
+				worker->m_thread.join();
+			}
+		}
+	}
+
+	std::shared_ptr<Job> ThreadPool::Submit(std::function<void()> function, const std::shared_ptr<Job> &parent)
+	{
+		auto job = std::make_shared<Job>(std::move(function), parent);
+		m_pending.fetch_add(1, std::memory_order_relaxed);
+
+		// Workers push into their own deque, other threads spread jobs between the workers.
+		uint32_t index = CURRENT_POOL == this ? CURRENT_WORKER : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % GetWorkerCount();
+
+		// Counted before the push so a thief can never take the job before it is counted.
+		m_queued.fetch_add(1, std::memory_order_release);
+
+		{
+			std::lock_guard<std::mutex> lock(m_workers[index]->m_mutex);
+			m_workers[index]->m_jobs.emplace_back(job);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+
+		m_sleepCondition.notify_one();
+		return job;
+	}
+
+	void ThreadPool::ParallelFor(const uint32_t &begin, const uint32_t &end, const std::function<void(uint32_t, uint32_t)> &function, const uint32_t &grainSize)
+	{
+		if (end <= begin)
+		{
+			return;
+		}
+
+		uint32_t count = end - begin;
+		// Splits into a few chunks per thread so stealing can balance uneven chunks.
+		uint32_t grain = grainSize != 0 ? grainSize : std::max(count / ((GetWorkerCount() + 1) * 4), 1u);
+
+		if (count <= grain)
+		{
+			function(begin, end);
+			return;
+		}
+
+		auto root = std::make_shared<Job>();
+
+		for (uint32_t from = begin; from < end; from += std::min(grain, end - from))
+		{
+			uint32_t to = from + std::min(grain, end - from);
+			Submit([&function, from, to]()
+			{
+				function(from, to);
+			}, root);
+		}
+
+		root->Finish();
+		Wait(root);
+	}
+
+	void ThreadPool::Wait(const std::shared_ptr<Job> &job)
+	{
+		std::optional<uint32_t> index = {};
+
+		if (CURRENT_POOL == this)
+		{
+			index = CURRENT_WORKER;
+		}
+
+		while (!job->IsFinished())
+		{
+			auto next = TakeJob(index);
+
+			if (next == nullptr)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			Execute(next);
 		}
 	}
 
 	void ThreadPool::Wait()
 	{
-		for (auto &thread : m_threads)
+		std::optional<uint32_t> index = {};
+
+		if (CURRENT_POOL == this)
+		{
+			index = CURRENT_WORKER;
+		}
+
+		while (m_pending.load(std::memory_order_acquire) != 0)
+		{
+			auto next = TakeJob(index);
+
+			if (next == nullptr)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			Execute(next);
+		}
+	}
+
+	void ThreadPool::WorkerLoop(const uint32_t &index)
+	{
+		CURRENT_POOL = this;
+		CURRENT_WORKER = index;
+#if defined(ACID_PROFILE)
+		Profiler::SetThreadName("Worker " + std::to_string(index));
+#endif
+
+		while (true)
+		{
+			auto job = TakeJob(index);
+
+			if (job != nullptr)
+			{
+				Execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepCondition.wait(lock, [this]()
+			{
+				return m_destroying || m_queued.load(std::memory_order_acquire) != 0;
+			});
+
+			if (m_destroying)
+			{
+				break;
+			}
+		}
+	}
+
+	std::shared_ptr<Job> ThreadPool::TakeJob(const std::optional<uint32_t> &index)
+	{
+		if (m_queued.load(std::memory_order_acquire) == 0)
+		{
+			return nullptr;
+		}
+
+		// Pops the newest job from the owning deque, it is the most likely to still be in cache.
+		if (index)
+		{
+			auto &worker = m_workers[*index];
+			std::lock_guard<std::mutex> lock(worker->m_mutex);
+
+			if (!worker->m_jobs.empty())
+			{
+				auto job = std::move(worker->m_jobs.back());
+				worker->m_jobs.pop_back();
+				m_queued.fetch_sub(1, std::memory_order_relaxed);
+				return job;
+			}
+		}
+
+		// Steals the oldest job from another worker.
+		uint32_t start = index ? *index + 1 : 0;
+
+		for (uint32_t i = 0; i < GetWorkerCount(); i++)
+		{
+			auto &victim = m_workers[(start + i) % GetWorkerCount()];
+			std::lock_guard<std::mutex> lock(victim->m_mutex);
+
+			if (!victim->m_jobs.empty())
+			{
+				auto job = std::move(victim->m_jobs.front());
+				victim->m_jobs.pop_front();
+				m_queued.fetch_sub(1, std::memory_order_relaxed);
+				return job;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void ThreadPool::Execute(const std::shared_ptr<Job> &job)
+	{
+		if (job->m_function)
 		{
-			thread->Wait();
+			job->m_function();
 		}
+
+		job->Finish();
+		m_pending.fetch_sub(1, std::memory_order_acq_rel);
 	}
 }
@@ -1,14 +1,21 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <vector>
 #include "Helpers/NonCopyable.hpp"
-#include "Thread.hpp"
+#include "Job.hpp"
 
 namespace acid
 {
 	/// <summary>
-	/// A pool of threads.
+	/// A work-stealing pool of worker threads. Each worker owns a deque of jobs, it pops its newest job first and when empty steals the oldest job from another worker.
+	/// Threads that wait on a job help run queued jobs, so waiting from inside a job will not deadlock the pool.
 	/// </summary>
 	class ACID_EXPORT ThreadPool :
 		public NonCopyable
@@ -16,15 +23,68 @@ namespace acid
 	public:
 		explicit ThreadPool(const uint32_t &threadCount = HardwareConcurrency);
 
+		~ThreadPool();
+
+		/// <summary>
+		/// Submits a job to the pool.
+		/// </summary>
+		/// <param name="function"> The function the job will run. </param>
+		/// <param name="parent"> A unfinished parent job that will wait on this job before finishing. </param>
+		/// <returns> The job handle, can be passed to <seealso cref="#Wait()"/>. </returns>
+		std::shared_ptr<Job> Submit(std::function<void()> function, const std::shared_ptr<Job> &parent = nullptr);
+
+		/// <summary>
+		/// Runs a function over the range [begin, end) split into chunks across the pool, blocks until all chunks have finished.
+		/// </summary>
+		/// <param name="begin"> The first index in the range. </param>
+		/// <param name="end"> One past the last index in the range. </param>
+		/// <param name="function"> The function called with the [from, to) sub range of each chunk. </param>
+		/// <param name="grainSize"> The minimum amount of indices per chunk, 0 will divide the range evenly across the workers. </param>
+		void ParallelFor(const uint32_t &begin, const uint32_t &end, const std::function<void(uint32_t, uint32_t)> &function, const uint32_t &grainSize = 0);
+
+		/// <summary>
+		/// Waits until a job and all of its children have finished, the calling thread runs queued jobs while waiting.
+		/// </summary>
+		/// <param name="job"> The job to wait on. </param>
+		void Wait(const std::shared_ptr<Job> &job);
+
 		/// <summary>
-		/// Waits until all threads are finished.
+		/// Waits until every submitted job has finished.
 		/// </summary>
 		void Wait();
 
-		std::vector<std::unique_ptr<Thread>> &GetThreads() { return m_threads; }
+		/// <summary>
+		/// Gets the amount of worker threads in this pool.
+		/// </summary>
+		/// <returns> The worker count. </returns>
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
 
 		static const uint32_t HardwareConcurrency;
 	private:
-		std::vector<std::unique_ptr<Thread>> m_threads;
+		struct Worker
+		{
+			std::thread m_thread;
+			std::deque<std::shared_ptr<Job>> m_jobs;
+			std::mutex m_mutex;
+		};
+
+		void WorkerLoop(const uint32_t &index);
+
+		/// <summary>
+		/// Takes a job, first from the back of the owning workers deque then from the front of every other worker.
+		/// </summary>
+		/// <param name="index"> The index of the calling worker, empty if the caller is not a worker of this pool. </param>
+		/// <returns> The job taken, or nullptr if every deque was empty. </returns>
+		std::shared_ptr<Job> TakeJob(const std::optional<uint32_t> &index);
+
+		void Execute(const std::shared_ptr<Job> &job);
+
+		std::vector<std::unique_ptr<Worker>> m_workers;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_sleepCondition;
+		std::atomic<uint32_t> m_queued;
+		std::atomic<uint32_t> m_pending;
+		std::atomic<uint32_t> m_nextWorker;
+		bool m_destroying;
 	};
 }
@@ -1,10 +1,24 @@
 #include "Uis.hpp"
 
+#include "Audio/Audio.hpp"
+#include "Devices/Keyboard.hpp"
+#include "Resources/Resources.hpp"
+
 namespace acid
 {
 	Uis::Uis() :
 		m_container(nullptr, UiBound::Screen)
 	{
+		AddRead<Mouse>();
+		AddRead<Keyboard>();
+		// Ui actions may create resources.
+		AddWrite<Resources>();
+		// Ui actions play sounds, which are gained and played through the audio device.
+		AddWrite<Audio>();
+		AddWrite<Uis>();
+		// Selectors poll the cursor and key states from GLFW, which may only be queried on the main thread.
+		SetMainThread(true);
+
 		for (auto button : enum_iterator<MouseButton>())
 		{
 			m_selectors.emplace(button, SelectorMouse());
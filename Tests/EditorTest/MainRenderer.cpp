@@ -92,7 +92,7 @@ namespace test
 	{
 		auto &renderpassCreate0 = Renderer::Get()->GetRenderStage(0)->GetRenderpassCreate();
 		renderpassCreate0.SetWidth(Shadows::Get()->GetShadowSize());
-		renderpassCreate0.SetHeight(Shadows::Get()->GetShadowSize()); // * RendererShadows::NUM_CASCADES
+		renderpassCreate0.SetHeight(Shadows::Get()->GetShadowSize());
 
 		//	auto &renderpassCreate1 = Renderer::Get()->GetRenderStage(1)->GetRenderpassCreate();
 		//	renderpassCreate1.SetScale(0.75f);